@@ -2,6 +2,7 @@
 #include <iostream>
 #include <thread>
 #include <chrono>
+#include <functional>
 
 Napi::FunctionReference BrowserWrapper::constructor;
 
@@ -22,7 +23,8 @@ public:
             } else if (operation_ == "fill") {
                 result_bool_ = wrapper_->browser_->fillInput(selector_param_, value_param_);
             } else if (operation_ == "screenshot") {
-                result_bool_ = wrapper_->browser_->takeScreenshot(filename_param_);
+                wrapper_->browser_->takeScreenshot(filename_param_);
+                result_bool_ = wrapper_->browser_->getLastScreenshotInfo().success;
             } else if (operation_ == "javascript") {
                 result_string_ = wrapper_->browser_->executeJavascriptSync(js_param_);
                 result_bool_ = true;
@@ -82,6 +84,7 @@ Napi::Object BrowserWrapper::Init(Napi::Env env, Napi::Object exports) {
         InstanceMethod("countElements", &BrowserWrapper::CountElements),
         InstanceMethod("getInnerText", &BrowserWrapper::GetInnerText),
         InstanceMethod("getElementHtml", &BrowserWrapper::GetElementHtml),
+        InstanceMethod("getPageSource", &BrowserWrapper::GetPageSource),
         
         // Attributes
         InstanceMethod("getAttribute", &BrowserWrapper::GetAttribute),
@@ -94,6 +97,7 @@ Napi::Object BrowserWrapper::Init(Napi::Env env, Napi::Object exports) {
         // Screenshots
         InstanceMethod("takeScreenshot", &BrowserWrapper::TakeScreenshot),
         InstanceMethod("takeScreenshotAsync", &BrowserWrapper::TakeScreenshotAsync),
+        InstanceMethod("takeScreenshotBuffer", &BrowserWrapper::TakeScreenshotBuffer),
         
         // Waiting
         InstanceMethod("waitForSelector", &BrowserWrapper::WaitForSelector),
@@ -360,8 +364,58 @@ Napi::Value BrowserWrapper::TakeScreenshot(const Napi::CallbackInfo& info) {
     }
     
     try {
-        bool result = browser_->takeScreenshot(filename);
-        return Napi::Boolean::New(env, result);
+        browser_->takeScreenshot(filename);
+        return Napi::Boolean::New(env, browser_->getLastScreenshotInfo().success);
+    } catch (const std::exception& e) {
+        Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
+        return env.Undefined();
+    }
+}
+
+// In-memory screenshot: the encoded PNG (or raw ARGB32 pixels) is wrapped
+// directly in a Node Buffer and freed by the finalizer, with no temp file or copy
+Napi::Value BrowserWrapper::TakeScreenshotBuffer(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    
+    bool full_page = false;
+    bool raw = false;
+    if (info.Length() > 0 && info[0].IsObject()) {
+        Napi::Object options = info[0].As<Napi::Object>();
+        
+        if (options.Has("fullPage")) {
+            full_page = options.Get("fullPage").ToBoolean().Value();
+        }
+        
+        if (options.Has("raw")) {
+            raw = options.Get("raw").ToBoolean().Value();
+        }
+    }
+    
+    try {
+        ScreenshotBuffer capture;
+        if (!browser_->captureScreenshotBuffer(capture, full_page, raw) || capture.empty()) {
+            Napi::Error::New(env, "Screenshot capture failed").ThrowAsJavaScriptException();
+            return env.Undefined();
+        }
+        
+        size_t size = capture.size();
+        ScreenshotBuffer::Deleter deleter = capture.deleter();
+        uint8_t* data = capture.release();
+        
+        Napi::Buffer<uint8_t> buffer = Napi::Buffer<uint8_t>::New(
+            env, data, size,
+            [](Napi::Env /*env*/, uint8_t* bytes, ScreenshotBuffer::Deleter* free_fn) {
+                (*free_fn)(bytes);
+                delete free_fn;
+            },
+            new ScreenshotBuffer::Deleter(deleter));
+        
+        buffer.Set("format", Napi::String::New(env, capture.raw ? "argb32" : "png"));
+        buffer.Set("width", Napi::Number::New(env, capture.width));
+        buffer.Set("height", Napi::Number::New(env, capture.height));
+        buffer.Set("stride", Napi::Number::New(env, static_cast<double>(capture.stride)));
+        buffer.Set("hash", Napi::String::New(env, capture.hash));
+        return buffer;
     } catch (const std::exception& e) {
         Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
         return env.Undefined();
@@ -394,9 +448,59 @@ Napi::Value BrowserWrapper::CountElements(const Napi::CallbackInfo& info) {
     return Napi::Number::New(env, 0); // TODO: Implement
 }
 
+// With an onChunk(buffer) callback each slice is handed over as it arrives
+// and true/false is returned; otherwise the slices are joined into a string.
+static Napi::Value deliverStreamed(Napi::Env env, const Napi::Value& on_chunk,
+                                   const std::function<bool(const Browser::ChunkSink&)>& stream) {
+    if (on_chunk.IsFunction()) {
+        Napi::Function callback = on_chunk.As<Napi::Function>();
+        bool ok = stream([&](const char* data, size_t length) {
+            callback.Call({Napi::Buffer<char>::Copy(env, data, length)});
+        });
+        return Napi::Boolean::New(env, ok);
+    }
+    
+    std::string text;
+    if (!stream([&text](const char* data, size_t length) { text.append(data, length); })) {
+        Napi::Error::New(env, "Transfer from page failed").ThrowAsJavaScriptException();
+        return env.Undefined();
+    }
+    return Napi::String::New(env, text);
+}
+
 Napi::Value BrowserWrapper::GetElementHtml(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
-    return Napi::String::New(env, ""); // TODO: Implement
+    
+    if (info.Length() < 1 || !info[0].IsString()) {
+        Napi::TypeError::New(env, "Selector string expected").ThrowAsJavaScriptException();
+        return env.Undefined();
+    }
+    
+    std::string selector = info[0].As<Napi::String>().Utf8Value();
+    Napi::Value on_chunk = info.Length() > 1 ? info[1] : env.Undefined();
+    
+    try {
+        return deliverStreamed(env, on_chunk, [&](const Browser::ChunkSink& sink) {
+            return browser_->streamElementHtml(selector, sink);
+        });
+    } catch (const std::exception& e) {
+        Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
+        return env.Undefined();
+    }
+}
+
+Napi::Value BrowserWrapper::GetPageSource(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    Napi::Value on_chunk = info.Length() > 0 ? info[0] : env.Undefined();
+    
+    try {
+        return deliverStreamed(env, on_chunk, [&](const Browser::ChunkSink& sink) {
+            return browser_->streamPageSource(sink);
+        });
+    } catch (const std::exception& e) {
+        Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
+        return env.Undefined();
+    }
 }
 
 Napi::Value BrowserWrapper::GetAttribute(const Napi::CallbackInfo& info) {
@@ -34,6 +34,7 @@ private:
     Napi::Value CountElements(const Napi::CallbackInfo& info);
     Napi::Value GetInnerText(const Napi::CallbackInfo& info);
     Napi::Value GetElementHtml(const Napi::CallbackInfo& info);
+    Napi::Value GetPageSource(const Napi::CallbackInfo& info);
     
     // Attribute methods
     Napi::Value GetAttribute(const Napi::CallbackInfo& info);
@@ -46,6 +47,7 @@ private:
     // Screenshot methods
     Napi::Value TakeScreenshot(const Napi::CallbackInfo& info);
     Napi::Value TakeScreenshotAsync(const Napi::CallbackInfo& info);
+    Napi::Value TakeScreenshotBuffer(const Napi::CallbackInfo& info);
     
     // Waiting methods
     Napi::Value WaitForSelector(const Napi::CallbackInfo& info);
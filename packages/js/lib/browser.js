@@ -226,6 +226,19 @@ class Browser extends EventEmitter {
         return result;
     }
     
+    /**
+     * Capture a screenshot into memory without writing a file (sync)
+     * @param {Object} [options] - Capture options
+     * @param {boolean} [options.fullPage=false] - Capture the full document instead of the viewport
+     * @param {boolean} [options.raw=false] - Return raw ARGB32 pixels instead of PNG
+     * @returns {Buffer} - Image bytes with format, width, height, stride and hash properties
+     */
+    screenshotBuffer(options = {}) {
+        const buffer = this._browser.takeScreenshotBuffer(options);
+        this.emit('screenshot', { filename: null, size: buffer.length, hash: buffer.hash });
+        return buffer;
+    }
+    
     // ========== Element Query Methods (All Sync) ==========
     
     /**
@@ -249,10 +262,29 @@ class Browser extends EventEmitter {
     /**
      * Get HTML content of an element
      * @param {string} selector - CSS selector for the element
-     * @returns {string} - HTML content of the element
+     * @param {Function} [onChunk] - Receives the HTML as Buffer slices instead of one string
+     * @returns {string|boolean} - HTML content, or success when onChunk is given
+     */
+    getHtml(selector, onChunk) {
+        return onChunk ? this._browser.getElementHtml(selector, onChunk) : this._browser.getElementHtml(selector);
+    }
+    
+    /**
+     * Get the full document HTML, without the size cap of executeJavaScriptSync
+     * @param {Function} [onChunk] - Receives the HTML as Buffer slices instead of one string
+     * @returns {string|boolean} - Page HTML, or success when onChunk is given
+     */
+    getPageSource(onChunk) {
+        return onChunk ? this._browser.getPageSource(onChunk) : this._browser.getPageSource();
+    }
+    
+    /**
+     * Write the full document HTML to a writable stream slice by slice
+     * @param {stream.Writable} writable - Destination (file stream, socket, process.stdout)
+     * @returns {boolean} - True if the whole document was transferred
      */
-    getHtml(selector) {
-        return this._browser.getElementHtml(selector);
+    pipePageSource(writable) {
+        return this._browser.getPageSource(chunk => writable.write(chunk));
     }
     
     /**
@@ -157,6 +157,55 @@ describe('Basic Automation Integration', () => {
         });
     });
     
+    describe('Streamed Extraction', () => {
+        const ITEMS = 50000;
+        
+        beforeEach(async () => {
+            const htmlContent = `
+                <!DOCTYPE html>
+                <html>
+                <head><title>Streaming Test Page</title></head>
+                <body><div id="big"></div></body>
+                </html>
+            `;
+            
+            const dataUrl = 'data:text/html;charset=utf-8,' + encodeURIComponent(htmlContent);
+            await browser.navigate(dataUrl);
+            
+            // Numbered items, well over one 256 KiB slice, with multi-byte text mixed in
+            browser.executeJavaScriptSync(`
+                var parts = [];
+                for (var i = 0; i < ${ITEMS}; i++) parts.push('<b>' + i + ' \u00e9\u{1F600}</b>');
+                document.getElementById('big').innerHTML = parts.join(''); 'ok'
+            `);
+        });
+        
+        test('should deliver element HTML chunks in order and complete', () => {
+            const chunks = [];
+            expect(browser.getHtml('#big', chunk => chunks.push(chunk))).toBe(true);
+            expect(chunks.length).toBeGreaterThan(1);
+            chunks.forEach(chunk => expect(Buffer.isBuffer(chunk)).toBe(true));
+            
+            const html = Buffer.concat(chunks).toString('utf8');
+            expect(html.startsWith('<div id="big"><b>0 \u00e9\u{1F600}</b>')).toBe(true);
+            expect(html.endsWith('</b></div>')).toBe(true);
+            
+            const numbers = [...html.matchAll(/<b>(\d+) \u00e9\u{1F600}<\/b>/gu)].map(m => Number(m[1]));
+            expect(numbers).toHaveLength(ITEMS);
+            expect(numbers.every((n, i) => n === i)).toBe(true);
+        });
+        
+        test('should pipe the whole page source', () => {
+            const written = [];
+            expect(browser.pipePageSource({ write: chunk => written.push(chunk) })).toBe(true);
+            
+            const source = Buffer.concat(written).toString('utf8');
+            expect(source).toContain('<title>Streaming Test Page</title>');
+            expect(source).toContain(`<b>${ITEMS - 1} \u00e9\u{1F600}</b>`);
+            expect(source.trimEnd().endsWith('</html>')).toBe(true);
+        });
+    });
+    
     describe('Screenshot Capabilities', () => {
         test('should take screenshots', async () => {
             await browser.navigate('about:blank');
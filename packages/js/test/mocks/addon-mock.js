@@ -76,9 +76,25 @@ class MockBrowser {
         return content || '';
     }
     
-    getElementHtml(selector) {
+    getElementHtml(selector, onChunk) {
         const content = this.mockDOM[selector];
-        return content ? `<div>${content}</div>` : '';
+        const html = content ? `<div>${content}</div>` : '';
+        return onChunk ? this._deliverChunks(html, onChunk) : html;
+    }
+    
+    getPageSource(onChunk) {
+        const html = '<html><body>' + 'x'.repeat(300000) + '</body></html>';
+        return onChunk ? this._deliverChunks(html, onChunk) : html;
+    }
+    
+    _deliverChunks(text, onChunk) {
+        const slice = 262144;
+        let pos = 0;
+        do {
+            onChunk(Buffer.from(text.substring(pos, pos + slice)));
+            pos += slice;
+        } while (pos < text.length);
+        return true;
     }
     
     getAttribute(selector, attribute) {
@@ -128,6 +144,21 @@ class MockBrowser {
             callback(null, result);
         }, 10);
     }
+    
+    takeScreenshotBuffer(options = {}) {
+        const raw = !!options.raw;
+        const width = 4;
+        const height = 2;
+        const buffer = raw
+            ? Buffer.alloc(width * height * 4, 0xff)
+            : Buffer.from([0x89, 0x50, 0x4e, 0x47, 0x0d, 0x0a, 0x1a, 0x0a]);
+        buffer.format = raw ? 'argb32' : 'png';
+        buffer.width = width;
+        buffer.height = height;
+        buffer.stride = raw ? width * 4 : 0;
+        buffer.hash = '0000000000000000';
+        return buffer;
+    }
 }
 
 class MockSession {
@@ -171,6 +171,17 @@ describe('Browser Class', () => {
             const result = browser.screenshotSync('test-sync.png');
             expect(result).toBe(true);
         });
+        
+        test('should capture screenshot into a buffer', () => {
+            const png = browser.screenshotBuffer();
+            expect(Buffer.isBuffer(png)).toBe(true);
+            expect(png.format).toBe('png');
+            expect(png.subarray(0, 4).toString('latin1')).toBe('\x89PNG');
+            
+            const raw = browser.screenshotBuffer({ raw: true });
+            expect(raw.format).toBe('argb32');
+            expect(raw.length).toBe(raw.stride * raw.height);
+        });
     });
     
     describe('Element Query Methods', () => {
@@ -193,6 +204,20 @@ describe('Browser Class', () => {
             expect(html).toContain('Mock Page Title');
         });
         
+        test('should stream page source in slices', () => {
+            const whole = browser.getPageSource();
+            expect(whole.length).toBeGreaterThan(100000);
+            
+            const chunks = [];
+            expect(browser.getPageSource(chunk => chunks.push(chunk))).toBe(true);
+            expect(chunks.length).toBeGreaterThan(1);
+            expect(Buffer.concat(chunks).toString()).toBe(whole);
+            
+            const written = [];
+            expect(browser.pipePageSource({ write: chunk => written.push(chunk) })).toBe(true);
+            expect(Buffer.concat(written).length).toBe(whole.length);
+        });
+        
         test('should get element attribute', () => {
             browser.typeSync('#username', 'testvalue');
             const value = browser.getAttribute('#username', 'value');
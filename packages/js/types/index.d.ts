@@ -19,6 +19,29 @@ declare module '@headlessweb/js' {
         height?: number;
     }
 
+    /**
+     * In-memory screenshot options
+     */
+    export interface ScreenshotBufferOptions {
+        /** Capture the full document instead of the viewport (default: false) */
+        fullPage?: boolean;
+        /** Return raw ARGB32 pixels instead of PNG (default: false) */
+        raw?: boolean;
+    }
+
+    /**
+     * Screenshot bytes returned without a temp file
+     */
+    export interface ScreenshotBuffer extends Buffer {
+        format: 'png' | 'argb32';
+        width: number;
+        height: number;
+        /** Row stride in bytes for raw buffers, 0 for PNG */
+        stride: number;
+        /** xxh64 of the raw pixels */
+        hash: string;
+    }
+
     /**
      * Page information object
      */
@@ -103,6 +126,7 @@ declare module '@headlessweb/js' {
         typeSync(selector: string, text: string): boolean;
         executeJavaScriptSync(code: string): string;
         screenshotSync(filename?: string): boolean;
+        screenshotBuffer(options?: ScreenshotBufferOptions): ScreenshotBuffer;
 
         // Element query methods
         exists(selector: string): boolean;
@@ -123,7 +147,7 @@ declare module '@headlessweb/js' {
         on(event: 'navigated', listener: (data: { url: string }) => void): this;
         on(event: 'clicked', listener: (data: { selector: string }) => void): this;
         on(event: 'typed', listener: (data: { selector: string; text: string }) => void): this;
-        on(event: 'screenshot', listener: (data: { filename: string }) => void): this;
+        on(event: 'screenshot', listener: (data: { filename: string | null; size?: number; hash?: string }) => void): this;
         on(event: 'destroyed', listener: () => void): this;
         on(event: 'error', listener: (error: Error) => void): this;
     }
@@ -561,6 +561,86 @@ std::string AsyncNavigationOperations::generateRenderingCompleteScript() const {
 )JS";
 }
 
+std::string AsyncNavigationOperations::generatePaintSettledScript(const std::string& token, int quiet_ms,
+                                                                  int max_resource_wait_ms) const {
+    std::string script = R"JS(
+(function(token, quietMs, maxResourceWaitMs) {
+    // HeadlessWeb paint-settled probe: fonts, pending images, layout-shift and
+    // DOM quiescence, then a double requestAnimationFrame tick before reporting
+    function post(payload) {
+        try {
+            window.webkit.messageHandlers.hwebPaint.postMessage(JSON.stringify(payload));
+        } catch (e) {}
+    }
+    
+    var lastChange = performance.now();
+    var touch = function() { lastChange = performance.now(); };
+    
+    var mutationObserver = null;
+    try {
+        mutationObserver = new MutationObserver(touch);
+        mutationObserver.observe(document.documentElement, {
+            childList: true, subtree: true, attributes: true, characterData: true
+        });
+    } catch (e) { mutationObserver = null; }
+    
+    var shiftObserver = null;
+    try {
+        shiftObserver = new PerformanceObserver(function(list) {
+            list.getEntries().forEach(function(entry) {
+                if (!entry.hadRecentInput) touch();
+            });
+        });
+        shiftObserver.observe({ type: 'layout-shift', buffered: false });
+    } catch (e) { shiftObserver = null; }
+    
+    var pending = [];
+    if (document.fonts && document.fonts.ready) {
+        pending.push(document.fonts.ready);
+    }
+    Array.prototype.forEach.call(document.images || [], function(img) {
+        if (!img.complete) {
+            pending.push(new Promise(function(resolve) {
+                img.addEventListener('load', resolve, { once: true });
+                img.addEventListener('error', resolve, { once: true });
+            }));
+        }
+    });
+    var pendingCount = pending.length;
+    
+    // rAF can be throttled for offscreen views; fall back to a short timer
+    function nextFrame(callback) {
+        var done = false;
+        var timer = setTimeout(function() { if (!done) { done = true; callback(); } }, 50);
+        requestAnimationFrame(function() {
+            if (!done) { done = true; clearTimeout(timer); callback(); }
+        });
+    }
+    
+    function check() {
+        nextFrame(function() {
+            nextFrame(function() {
+                var quiet = performance.now() - lastChange;
+                if (quiet >= quietMs) {
+                    if (mutationObserver) mutationObserver.disconnect();
+                    if (shiftObserver) shiftObserver.disconnect();
+                    post({ token: token, readyState: document.readyState, pendingResources: pendingCount });
+                } else {
+                    setTimeout(check, quietMs - quiet);
+                }
+            });
+        });
+    }
+    
+    var timeout = new Promise(function(resolve) { setTimeout(resolve, maxResourceWaitMs); });
+    Promise.race([Promise.all(pending), timeout]).then(check, check);
+    return 'armed';
+})JS";
+    
+    script += "('" + token + "', " + std::to_string(quiet_ms) + ", " + std::to_string(max_resource_wait_ms) + ");";
+    return script;
+}
+
 // Private method
 void AsyncNavigationOperations::emitPageLoadEvent(EventType type, const std::string& url, double progress, 
                                                   const std::string& state, bool spa) {
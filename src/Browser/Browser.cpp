@@ -97,13 +97,17 @@ Browser::Browser(const HWeb::HWebConfig& config) : cookieManager(nullptr), main_
     // Store browser instance in the webView for callbacks
     g_object_set_data(G_OBJECT(webView), "browser-instance", this);
     
-    // CRITICAL: Block file chooser dialogs for headless operation
+    // CRITICAL: Never show file chooser dialogs in headless operation. Requests
+    // are answered with the paths of a pending selectFiles() or cancelled.
     g_signal_connect(webView, "run-file-chooser", G_CALLBACK(+[](WebKitWebView* web_view, WebKitFileChooserRequest* request, gpointer user_data) -> gboolean {
-        debug_output("File chooser request blocked (headless mode)");
-        // Cancel the file chooser request to prevent dialog
-        webkit_file_chooser_request_cancel(request);
+        Browser* browser = static_cast<Browser*>(user_data);
+        if (browser && browser->isObjectValid()) {
+            browser->notifyFileChooser(request);
+        } else {
+            webkit_file_chooser_request_cancel(request);
+        }
         return TRUE; // Signal handled, don't show dialog
-    }), NULL);
+    }), this);
     
     // Initialize the EventLoopManager
     event_loop_manager = std::make_unique<EventLoopManager>();
@@ -125,6 +129,15 @@ Browser::Browser(const HWeb::HWebConfig& config) : cookieManager(nullptr), main_
     // Setup event-driven signal handlers (implemented in BrowserEvents.cpp)
     setupSignalHandlers();
     
+    // Preinstall the in-page helper runtime used by the DOM methods
+    installPageRuntime();
+    
+    // A new document starts with an empty handle table, so drop existing element handles
+    event_bus_->subscribe(BrowserEvents::EventType::NAVIGATION_STARTED,
+        [generation = handle_generation_](const BrowserEvents::Event&) {
+            generation->fetch_add(1);
+        });
+    
     g_object_unref(settings);
 }
 
@@ -144,6 +157,11 @@ Browser::~Browser() {
     // Cleanup waiters (implemented in BrowserEvents.cpp)
     cleanupWaiters();
     
+    if (fetch_session_) {
+        g_object_unref(fetch_session_);
+        fetch_session_ = nullptr;
+    }
+    
     // Let GTK handle cleanup automatically to avoid race conditions
     
     if (main_loop) {
@@ -5,6 +5,16 @@
 #include "../Debug.h"
 #include "EventLoopManager.h"
 #include "BrowserEventBus.h"
+#include "ScreenshotStore.h"
+#include "ScreenshotRecorder.h"
+#include "PageRuntime.h"
+#include "ElementHandle.h"
+#include "TableExtraction.h"
+#include "DomMirror.h"
+#include "Downloads.h"
+#include "Uploads.h"
+#include "Fetch.h"
+#include "../FileOps/Sha256.h"
 #include <string>
 #include <functional>
 #include <map>
@@ -21,6 +31,8 @@
 typedef struct _GtkWidget GtkWidget;
 typedef struct _WebKitWebView WebKitWebView;
 typedef struct _WebKitCookieManager WebKitCookieManager;
+typedef struct _WebKitDownload WebKitDownload;
+typedef struct _SoupSession SoupSession;
 
 class Browser {
     // Friend functions for static callbacks that need access to private members
@@ -65,6 +77,13 @@ private:
     // Navigation tracking for proper waitForNavigation behavior
     std::string previous_url;
     
+    // Screenshot hashing and content-addressed dedup - BrowserScreenshot.cpp
+    ScreenshotInfo last_screenshot_;
+    std::unique_ptr<ScreenshotStore> screenshot_store_;
+    ScreenshotStore* getScreenshotStore();
+    void prepareForScreenshot();
+    bool snapshotToBuffer(ScreenshotBuffer& out, bool full_page, bool raw, ScreenshotInfo* info);
+    
     // JavaScript event helpers - BrowserEvents.cpp
     std::string setupDOMObserver(const std::string& selector, int timeout_ms);
     std::string setupVisibilityObserver(const std::string& selector, int timeout_ms);
@@ -76,7 +95,54 @@ private:
     bool waitForWebKitSignal(const std::string& signal_name, int timeout_ms);
     
     void setupSignalHandlers();
+    void installPageRuntime();  // BrowserJavaScript.cpp
     void cleanupWaiters();
+    
+    // Bumped on every document load; element handles from older documents are invalid
+    std::shared_ptr<std::atomic<uint64_t>> handle_generation_ = std::make_shared<std::atomic<uint64_t>>(0);
+    
+    // Paint-settled detection - BrowserEvents.cpp
+    gulong paint_message_signal_id = 0;
+    std::string pending_paint_token_;
+    bool paint_settled_ = false;
+    
+    // Chunked result transfer - BrowserJavaScript.cpp (one transfer at a time)
+    gulong chunk_message_signal_id = 0;
+    std::string active_stream_id_;
+    std::function<void(const char*, size_t)> active_stream_sink_;
+    bool active_stream_done_ = false;
+    
+    // Random id for one exchange with in-page code; pages share the message
+    // handlers, so ids they could guess would let them forge replies
+    static std::string newTransferToken();
+    
+    // DOM mirror diffs - BrowserJavaScript.cpp
+    gulong mutation_message_signal_id = 0;
+    
+    // File chooser answers - BrowserDOM.cpp
+    std::vector<std::string> pending_file_selection_;
+    bool file_chooser_answered_ = false;
+    size_t file_chooser_selected_ = 0;
+    
+    // Upload transfers reported by the page - UploadTracking.cpp
+    gulong upload_message_signal_id = 0;
+    std::vector<UploadTransfer> uploads_;
+    std::chrono::steady_clock::time_point last_upload_report_;
+    std::string upload_token_;  // reports without it are ignored
+    
+    // Downloads - DownloadTracking.cpp
+    gulong download_started_signal_id = 0;
+    std::string download_dir_;
+    std::vector<DownloadRecord> downloads_;
+    std::map<WebKitDownload*, size_t> download_index_;  // live downloads -> downloads_ slot
+    std::map<WebKitDownload*, std::unique_ptr<FileOps::StreamingFileHash>> download_hashes_;
+    uint64_t download_counter_ = 0;
+    DownloadRecord* findDownload(WebKitDownload* download);
+    void releaseDownloads();
+    void emitDownloadEvent(BrowserEvents::EventType type, const DownloadRecord& record);
+    
+    // Direct HTTP requests - DirectFetch.cpp; kept so connections are reused
+    SoupSession* fetch_session_ = nullptr;
 
 public:
     // Core members
@@ -124,6 +190,30 @@ public:
     bool waitForJavaScriptCompletion(int timeout_ms = 5000);
     std::string executeJavascriptSync(const std::string& script);
     std::string executeJavascriptSyncSafe(const std::string& script);
+    // Call a window.__hweb runtime method with string arguments passed as typed
+    // values (no source splicing); result follows executeJavascriptSync()
+    std::string callPageRuntime(const std::string& method, const std::vector<std::string>& args, int timeout_ms = 5000);
+    // As above; reached is false only when the call never got to run in the page
+    // (no document, or the runtime could not be installed). A timeout or an
+    // empty result leaves it true, since the method may have run part-way.
+    std::string callPageRuntime(const std::string& method, const std::vector<std::string>& args, int timeout_ms,
+                                bool& reached);
+    // Same call, but the string result is posted back in slices through the
+    // hwebChunk message handler and fed to sink as it arrives; no result cap.
+    // Returns false if the transfer failed or timed out (sink may be partly fed).
+    using ChunkSink = std::function<void(const char* data, size_t length)>;
+    bool streamPageRuntime(const std::string& method, const std::vector<std::string>& args,
+                           const ChunkSink& sink, int timeout_ms = 30000);
+    bool streamPageSource(const ChunkSink& sink);
+    bool streamElementHtml(const std::string& selector, const ChunkSink& sink);
+    // Main page content (readability-style pick) as Markdown or plain text
+    bool streamReadableContent(bool markdown, const ChunkSink& sink);
+    // Node table of the whole document ({"seq":0,"nodes":[...]}, see DomMirror)
+    // streamed to sink. From then on every change is published on the event
+    // bus as a DOM_MUTATION event with target "dom-diff" and the diff JSON
+    // ({"seq":n,"ops":[...]}) as data, until stopDomDiffs() or navigation.
+    bool snapshotDom(const ChunkSink& sink);
+    void stopDomDiffs();
 
     // ========== Event-driven Operations - BrowserEvents.cpp ==========
     bool waitForSelectorEvent(const std::string& selector, int timeout_ms);
@@ -133,6 +223,8 @@ public:
     bool waitForVisibilityEvent(const std::string& selector, int timeout_ms);
     bool waitForConditionEvent(const std::string& js_condition, int timeout_ms);
     bool waitForPageReadyEvent(int timeout_ms);
+    // Returns once the page is visually stable (fonts, images, layout shifts, rAF) or on timeout
+    bool waitForPaintSettled(int timeout_ms = 2000, int quiet_ms = 100);
     
     // Dynamic content waiting (wrappers)
     bool waitForPageReady(const Session& session);
@@ -150,6 +242,16 @@ public:
     void notifyUriChanged();
     void notifyTitleChanged();
     void notifyReadyToShow();
+    void notifyPaintSettled(const std::string& payload);
+    void notifyChunkMessage(const char* payload, size_t length);
+    void notifyDomDiff(const char* payload, size_t length);
+    void notifyUploadMessage(const char* payload, size_t length);
+    void notifyFileChooser(WebKitFileChooserRequest* request);
+    void notifyDownloadStarted(WebKitDownload* download);
+    bool notifyDownloadDestination(WebKitDownload* download, const char* suggested_filename);
+    void notifyDownloadProgress(WebKitDownload* download);
+    void notifyDownloadFailed(WebKitDownload* download, GError* error);
+    void notifyDownloadFinished(WebKitDownload* download);
     void checkSignalConditions();
     
     // Object validity checking
@@ -186,6 +288,9 @@ public:
 
     // ========== DOM Manipulation - BrowserDOM.cpp ==========
     bool fillInput(const std::string& selector, const std::string& value);
+    // Types text as one trusted WebKit editing insertion (isTrusted input events,
+    // no synthetic dispatch); false if the element is not an editable text field
+    bool typeTrusted(const std::string& selector, const std::string& text, bool replace = true);
     bool fillInputEnhanced(const std::string& selector, const std::string& value);
     bool interactWithDynamicForm(const std::string& input_selector, const std::string& value, 
                                  const std::string& submit_selector, int wait_timeout = 1000);
@@ -198,6 +303,87 @@ public:
     bool focusElement(const std::string& selector);
     std::string getAttribute(const std::string& selector, const std::string& attribute);
     bool setAttribute(const std::string& selector, const std::string& attribute, const std::string& value);
+    // Fills every field of a {"key": value} JSON object in one page call.
+    // Keys are selectors, field names or ids; values are strings, booleans
+    // (checkboxes) or arrays (multi-selects, checkbox groups). Returns
+    // key -> "ok", "not_found", "no_option: ...", "mismatch: ..." or "error: ...".
+    std::map<std::string, std::string> fillForm(const std::string& fields_json);
+    std::map<std::string, std::string> fillForm(const std::map<std::string, std::string>& fields);
+    // Sets the files of an <input type=file> through WebKit's own file chooser
+    // path: the input is clicked and run-file-chooser is answered with these
+    // paths, so the web process reads the files from disk itself. Only the
+    // first path is used for inputs without the multiple attribute.
+    bool selectFiles(const std::string& selector, const std::vector<std::string>& paths, int timeout_ms = 5000);
+    
+    // ========== Uploads - UploadTracking.cpp ==========
+    // WebKit has no per-request signals, so the page runtime wraps
+    // XMLHttpRequest.send and fetch and pushes every file-carrying request
+    // (start, progress, end) through the hwebUpload message handler.
+    // Starts reporting in the current document; false if the handler is missing.
+    bool watchUploads();
+    std::vector<UploadTransfer> getUploads() const;
+    // Waits until every named file has been carried by a finished or failed
+    // transfer at index first or later. Gives up early once nothing is in
+    // flight and the page has reported nothing for quiet_ms. False unless
+    // every file was carried.
+    bool waitForUploads(const std::vector<std::string>& filenames, size_t first, int quiet_ms, int timeout_ms);
+    
+    // ========== Downloads - DownloadTracking.cpp ==========
+    // Downloads of this view are saved into the download directory under the
+    // server's suggested name (made unique), and tracked from WebKit's own
+    // download signals rather than by watching the directory.
+    void setDownloadDirectory(const std::string& directory);
+    std::string getDownloadDirectory() const;
+    std::vector<DownloadRecord> getDownloads() const;
+    // Starts downloading uri in this view; returns the download id, 0 on failure
+    uint64_t startDownload(const std::string& uri);
+    // Like startDownload, but the bytes are handed to sink as they arrive.
+    // WebKit only writes to files, so the download lands in a memory-backed
+    // scratch directory that is read behind the writer and removed at the
+    // end. A sink returning false cancels the download.
+    uint64_t streamDownload(const std::string& uri, FileOps::StreamingFileHash::Sink sink);
+    bool cancelDownload(uint64_t id);
+    // Marks a download as taken by one waiter; false if unknown or already claimed
+    bool claimDownload(uint64_t id);
+    // Progress is also published on the event bus as DownloadEvents
+    // (DOWNLOAD_STARTED once the destination is chosen, then PROGRESS,
+    // FINISHED or FAILED).
+    // Waits for the oldest unclaimed download accepted by matches to finish,
+    // fail or be cancelled, then claims it into result. progress is called
+    // whenever its received byte count changes. False on timeout.
+    bool waitForDownload(const std::function<bool(const DownloadRecord&)>& matches, int timeout_ms,
+                         DownloadRecord& result,
+                         const std::function<void(const DownloadRecord&)>& progress = nullptr);
+    
+    // ========== Direct HTTP - DirectFetch.cpp ==========
+    // GETs url without the web view, so no DOM, layout or script is
+    // involved. The request carries the view's User-Agent, a Referer of the
+    // current page, and the cookies WebKit holds for url merged with the
+    // matching ones from cookies. Set-Cookie headers of the response are
+    // stored back into WebKit and copied to response.set_cookies. A 2xx body
+    // is handed to sink as it arrives; other bodies are not read. A sink
+    // returning false aborts the transfer. Returns response.ok().
+    bool fetch(const std::string& url, const std::vector<Cookie>& cookies, FileOps::StreamingFileHash::Sink sink,
+               int timeout_ms, FetchResponse& response);
+    
+    // ========== Element Handles - BrowserDOM.cpp ==========
+    // Resolve selector once; returns an invalid handle if nothing matches
+    ElementHandle query(const std::string& selector);
+    void releaseHandle(ElementHandle& handle);
+    bool elementExists(const ElementHandle& handle);   // still attached to the document
+    bool fillInput(const ElementHandle& handle, const std::string& value);
+    bool clickElement(const ElementHandle& handle);
+    bool focusElement(const ElementHandle& handle);
+    std::string getValue(const ElementHandle& handle);
+    std::string getInnerText(const ElementHandle& handle);
+    std::string getElementHtml(const ElementHandle& handle);
+    std::string getAttribute(const ElementHandle& handle, const std::string& attribute);
+    bool setAttribute(const ElementHandle& handle, const std::string& attribute, const std::string& value);
+    
+    // ========== Bulk Extraction - BrowserDOM.cpp ==========
+    // Streams one JSON array of cells per matched row to on_row, pulling
+    // bounded chunks from the page. Returns the row count, or -1 on error.
+    long extractTable(const TableSpec& spec, const std::function<void(const Json::Value&)>& on_row);
     
     // ========== Event-Driven DOM Operations - Replace blocking patterns ==========
     std::future<bool> fillInputAsync(const std::string& selector, const std::string& value, int timeout_ms = 5000);
@@ -282,6 +468,13 @@ public:
     // ========== Screenshot Operations - BrowserScreenshot.cpp ==========
     void takeScreenshot(const std::string& filename);
     void takeFullPageScreenshot(const std::string& filename);
+    // Capture into memory as PNG (or raw ARGB32 when raw is true) without touching disk
+    bool captureScreenshotBuffer(ScreenshotBuffer& out, bool full_page = false, bool raw = false);
+    const ScreenshotInfo& getLastScreenshotInfo() const { return last_screenshot_; }
+    // Burst capture at an interval and/or on navigation/DOM events; returns frames written or -1
+    int recordScreenshots(const ScreenshotRecordingOptions& options);
+    // Resize the loaded page through each viewport and capture it; returns images written or -1
+    int captureViewportSweep(const ScreenshotSweepOptions& options);
 
     // ========== Utility Functions - BrowserUtilities.cpp ==========
     void wait(int milliseconds); // Blocking wait
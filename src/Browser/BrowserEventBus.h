@@ -9,6 +9,7 @@
 #include <atomic>
 #include <future>
 #include <chrono>
+#include "Downloads.h"
 
 namespace BrowserEvents {
 
@@ -96,7 +97,13 @@ enum class EventType {
     CUSTOM_ATTRIBUTES_RESTORED,
     CUSTOM_STATE_RESTORED,
     SCROLL_POSITIONS_RESTORED,
-    SESSION_RESTORATION_COMPLETE
+    SESSION_RESTORATION_COMPLETE,
+    
+    // Download events (WebKitDownload signals)
+    DOWNLOAD_STARTED,
+    DOWNLOAD_PROGRESS,
+    DOWNLOAD_FINISHED,
+    DOWNLOAD_FAILED
 };
 
 // Base event class - made polymorphic for dynamic_cast
@@ -185,6 +192,14 @@ struct NetworkEvent : public Event {
         : Event(t, request_url), url(request_url), status_code(status), method(m), completed(c) {}
 };
 
+// Download event; target is the destination path once it is known
+struct DownloadEvent : public Event {
+    DownloadRecord download;
+    
+    DownloadEvent(EventType t, const DownloadRecord& record)
+        : Event(t, record.destination, record.uri), download(record) {}
+};
+
 // Event handler function types
 using EventHandler = std::function<void(const Event&)>;
 using EventCondition = std::function<bool(const Event&)>;
@@ -536,6 +551,8 @@ public:
     std::string generateSPANavigationDetectionScript() const;
     std::string generateFrameworkDetectionScript(const std::string& framework) const;
     std::string generateRenderingCompleteScript() const;
+    std::string generatePaintSettledScript(const std::string& token, int quiet_ms = 100,
+                                           int max_resource_wait_ms = 1000) const;
     
 private:
     void emitPageLoadEvent(EventType type, const std::string& url, double progress = 0.0, 
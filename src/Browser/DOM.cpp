@@ -3,216 +3,90 @@
 #include <string>
 #include <thread>
 #include <chrono>
+#include <algorithm>
+#include <filesystem>
 
 // External debug flag
 extern bool g_debug;
 
-// Helper function to escape selectors for single-quoted JavaScript strings
-static std::string escapeSelectorForSingleQuotes(const std::string& selector) {
-    std::string escaped = selector;
-    size_t pos = 0;
-    // Escape backslashes first
-    while ((pos = escaped.find("\\", pos)) != std::string::npos) {
-        escaped.replace(pos, 1, "\\\\");
-        pos += 2;
-    }
-    pos = 0;
-    // Then escape single quotes
-    while ((pos = escaped.find("'", pos)) != std::string::npos) {
-        escaped.replace(pos, 1, "\\'");
-        pos += 2;
-    }
-    return escaped;
-}
+// All DOM operations call into the preinstalled window.__hweb runtime
+// (PageRuntime.cpp). Selectors and values are passed as typed arguments,
+// so nothing here needs to be escaped into JavaScript source.
 
 // ========== Form Interaction Methods ==========
 
 bool Browser::fillInput(const std::string& selector, const std::string& value) {
     // For test scenarios with static HTML, try immediate element check first
-    // Use double quotes in JavaScript to avoid escaping issues with selectors containing single quotes
-    std::string escaped_selector = selector;
-    size_t pos = 0;
-    // Escape double quotes and backslashes for JavaScript double-quoted string
-    while ((pos = escaped_selector.find("\\", pos)) != std::string::npos) {
-        escaped_selector.replace(pos, 1, "\\\\");
-        pos += 2;
-    }
-    pos = 0;
-    while ((pos = escaped_selector.find("\"", pos)) != std::string::npos) {
-        escaped_selector.replace(pos, 1, "\\\"");
-        pos += 2;
-    }
-    std::string check_js = "(function() { try { return document.querySelector(\"" + escaped_selector + "\") !== null ? 'true' : 'false'; } catch(e) { return 'false'; } })()";
-    std::string immediate_check = executeJavascriptSync(check_js);
+    std::string immediate_check = callPageRuntime("exists", {selector});
     
     // If element is immediately available (common in tests), skip the complex wait entirely
     if (immediate_check != "true") {
         // Only use complex waitForSelectorEvent if element isn't immediately available
-        // Reduce timeout significantly for better test performance
         if (!waitForSelectorEvent(selector, 2000)) {  // Increased to 2000ms for test reliability
             return false;
         }
     }
     
-    // REPLACED: Use event-driven input completion instead of blocking wait(5)
-    // The new async DOM operations will handle timing through event detection
-    
-    // Escape quotes and other special characters in the value
-    std::string escaped_value = value;
-    size_t value_pos = 0;
-    // Escape backslashes first to avoid double-escaping
-    while ((value_pos = escaped_value.find("\\", value_pos)) != std::string::npos) {
-        escaped_value.replace(value_pos, 1, "\\\\");
-        value_pos += 2;
-    }
-    // Then escape quotes
-    value_pos = 0;
-    while ((value_pos = escaped_value.find("'", value_pos)) != std::string::npos) {
-        escaped_value.replace(value_pos, 1, "\\'");
-        value_pos += 2;
-    }
-    
-    std::string js_script = 
-        "(function() { "
-        "  try { "
-        "    var element = document.querySelector(\"" + escaped_selector + "\"); "
-        "    if (!element) return 'ELEMENT_NOT_FOUND'; "
-        "    element.focus(); "
-        "    element.click(); "
-        "    element.value = ''; "
-        "    element.value = '" + escaped_value + "'; "
-        "    element.dispatchEvent(new Event('focus', { bubbles: true })); "
-        "    element.dispatchEvent(new Event('input', { bubbles: true })); "
-        "    element.dispatchEvent(new Event('keydown', { bubbles: true })); "
-        "    element.dispatchEvent(new Event('keyup', { bubbles: true })); "
-        "    element.dispatchEvent(new Event('change', { bubbles: true })); "
-        "    if (element._valueTracker) { "
-        "      element._valueTracker.setValue('" + escaped_value + "'); "
-        "    } "
-        "    return 'FILL_SUCCESS'; "
-        "  } catch(e) { "
-        "    return 'FILL_ERROR: ' + e.message; "
-        "  } "
-        "})()";
-    
-    
-    std::string result = executeJavascriptSync(js_script);
-    debug_output("FillInput JavaScript result: '" + result + "'");
-    
-    // If complex JavaScript fails, use multi-step approach for full event simulation
-    if (result.empty() || result == "") {
-        debug_output("Complex JS failed, using multi-step approach for: " + selector);
-        
-        // Step 1: Basic form filling (we know this works)
-        // Escape the original value properly for JavaScript strings (not the already-escaped one)
-        std::string step_escaped_value = value;  // Use original value, not escaped_value
-        size_t step_pos = 0;
-        // Escape backslashes first
-        while ((step_pos = step_escaped_value.find("\\", step_pos)) != std::string::npos) {
-            step_escaped_value.replace(step_pos, 1, "\\\\");
-            step_pos += 2;
-        }
-        step_pos = 0;
-        // Then escape single quotes for JavaScript string literals
-        while ((step_pos = step_escaped_value.find("'", step_pos)) != std::string::npos) {
-            step_escaped_value.replace(step_pos, 1, "\\'");
-            step_pos += 2;
-        }
-        
-        std::string step1 = executeJavascriptSync(
-            "(function() { "
-            "try { "
-            "var e = document.querySelector(\"" + escaped_selector + "\"); "
-            "if (!e) return 'ELEMENT_NOT_FOUND'; "
-            "e.focus(); "
-            "e.click(); "
-            "e.value = ''; "
-            "e.value = '" + step_escaped_value + "'; "
-            "return 'STEP1_SUCCESS'; "
-            "} catch(ex) { return 'STEP1_ERROR: ' + ex.message; } "
-            "})()"
-        );
-        
-        if (step1 == "STEP1_SUCCESS") {
-            // Step 2: Dispatch essential events for modern frameworks
-            std::string step2 = executeJavascriptSync(
-                "(function() { "
-                "try { "
-                "var e = document.querySelector(\"" + escaped_selector + "\"); "
-                "e.dispatchEvent(new Event('focus', { bubbles: true })); "
-                "e.dispatchEvent(new Event('input', { bubbles: true })); "
-                "e.dispatchEvent(new Event('change', { bubbles: true })); "
-                "return 'STEP2_SUCCESS'; "
-                "} catch(ex) { return 'STEP2_ERROR: ' + ex.message; } "
-                "})()"
-            );
-            
-            // Step 3: React/Vue compatibility (if needed)
-            std::string step3 = executeJavascriptSync(
-                "(function() { "
-                "try { "
-                "var e = document.querySelector(\"" + escaped_selector + "\"); "
-                "if (e._valueTracker) { e._valueTracker.setValue('" + step_escaped_value + "'); } "
-                "return 'STEP3_SUCCESS'; "
-                "} catch(ex) { return 'STEP3_ERROR: ' + ex.message; } "
-                "})()"
-            );
-            
-            debug_output("Multi-step form filling - Step1: " + step1 + ", Step2: " + step2 + ", Step3: " + step3);
-            
-            // If steps succeeded, consider it a success
-            if (step2 == "STEP2_SUCCESS") {
-                result = "FILL_SUCCESS";
-            } else {
-                result = step1; // At least basic filling worked
-            }
-        } else {
-            result = step1; // Return the error
-        }
+    // Real editing input first; frameworks see the same events as from a user
+    if (typeTrusted(selector, value)) {
+        return true;
     }
     
-    // Add verification step with delay (optimized for tests)
+    // Sets the value and dispatches focus/input/key/change events plus the React value tracker
+    std::string result = callPageRuntime("fill", {selector, value});
+    debug_output("FillInput JavaScript result: '" + result + "'");
+    
     if (result == "FILL_SUCCESS") {
-        // REPLACED: Event-driven value processing instead of blocking wait(5)
-        
         // Verify the value was actually set
-        std::string verifyJs = "document.querySelector(\"" + escaped_selector + "\") ? document.querySelector(\"" + escaped_selector + "\").value : 'NOT_FOUND'";
-        std::string actualValue = executeJavascriptSync(verifyJs);
+        std::string actualValue = callPageRuntime("value", {selector});
         
         // DEBUG: Log verification result
         debug_output("FillInput VERIFY: expected='" + value + "' actual='" + actualValue + "'");
         
-        if (actualValue == escaped_value || actualValue == value) {
+        if (actualValue == value) {
             debug_output("FillInput VERIFY: SUCCESS");
             return true;
-        } else {
-            debug_output("FillInput VERIFY: FAILED");
-            debug_output("Warning: Value verification failed. Expected: '" + value + "', Got: '" + actualValue + "'");
-            
-            // Try alternative method using setAttribute
-            std::string altJs = 
-                "try { "
-                "  var el = document.querySelector(\"" + escaped_selector + "\"); "
-                "  if (el) { "
-                "    el.setAttribute('value', '" + escaped_value + "'); "
-                "    el.value = '" + escaped_value + "'; "
-                "    return 'retry_success'; "
-                "  } "
-                "  return 'retry_failed'; "
-                "} catch(e) { return 'retry_error'; }";
-            
-            std::string retryResult = executeJavascriptSync(altJs);
-            if (retryResult == "retry_success") {
-                // REPLACED: Event-driven retry completion instead of blocking wait(25)
-            }
-            return retryResult == "retry_success";
         }
+        
+        debug_output("FillInput VERIFY: FAILED");
+        debug_output("Warning: Value verification failed. Expected: '" + value + "', Got: '" + actualValue + "'");
+        
+        // Try alternative method using setAttribute
+        return callPageRuntime("forceValue", {selector, value}) == "retry_success";
     }
     
     debug_output("fillInput failed: " + result);
     return false;
 }
 
+bool Browser::typeTrusted(const std::string& selector, const std::string& text, bool replace) {
+    if (!webView) {
+        return false;
+    }
+    
+    std::string ready = callPageRuntime("prepareInput", {selector, replace ? "true" : "false"});
+    if (ready != "READY") {
+        debug_output("typeTrusted: " + selector + " not ready: " + ready);
+        return false;
+    }
+    
+    // The whole string is inserted by WebKit's editor in one command, which fires
+    // trusted beforeinput/input events just like typing into the focused field
+    if (!text.empty()) {
+        webkit_web_view_execute_editing_command_with_argument(webView, "InsertText", text.c_str());
+    } else if (replace) {
+        webkit_web_view_execute_editing_command(webView, "Delete");
+    }
+    
+    // Messages to the web process are ordered, so this runs after the edit
+    std::string settled = callPageRuntime("settleInput", {selector, replace ? "true" : "false", text});
+    if (settled != "true") {
+        debug_output("typeTrusted: " + selector + " " + settled);
+        return false;
+    }
+    return true;
+}
+
 bool Browser::clickElement(const std::string& selector) {
     // Check if webView exists first
     if (!webView) {
@@ -232,168 +106,38 @@ bool Browser::clickElement(const std::string& selector) {
         return false;
     }
     
-    // Escape selector to prevent injection
-    std::string escaped_selector = selector;
-    size_t pos = 0;
-    while ((pos = escaped_selector.find("'", pos)) != std::string::npos) {
-        escaped_selector.replace(pos, 1, "\\'");
-        pos += 2;
-    }
-    
-    // SIMPLIFIED DEBUG VERSION - test step by step
-    std::string js_script = 
-        "(function() { "
-        "  try { "
-        "    if (!document) return 'NO_DOCUMENT'; "
-        "    if (!document.querySelector) return 'NO_QUERYSELECTOR'; "
-        "    var element = document.querySelector(\"" + escaped_selector + "\"); "
-        "    if (!element) return 'ELEMENT_NOT_FOUND'; "
-        "    var rect = element.getBoundingClientRect(); "
-        "    if (rect.width <= 0 || rect.height <= 0) return 'ELEMENT_NOT_VISIBLE'; "
-        "    element.click(); "
-        "    return 'CLICKED_SUCCESS'; "
-        "  } catch(e) { "
-        "    return 'JS_ERROR: ' + e.message; "
-        "  } "
-        "})()";
-    
-    std::string result = executeJavascriptSync(js_script);
-    
+    std::string result = callPageRuntime("click", {selector});
+    if (result != "CLICKED_SUCCESS") {
+        debug_output("clickElement failed: " + result);
+    }
     return result == "CLICKED_SUCCESS";
 }
 
 bool Browser::submitForm(const std::string& form_selector) {
-    std::string js_script = 
-        "(function() { "
-        "  try { "
-        "    var form = document.querySelector('" + form_selector + "'); "
-        "    if (form) { "
-        "      form.submit(); "
-        "      return true; "
-        "    } "
-        "    return false; "
-        "  } catch(e) { "
-        "    return false; "
-        "  } "
-        "})()";
-    
-    std::string result = executeJavascriptSync(js_script);
-    return result == "true";
+    return callPageRuntime("submit", {form_selector}) == "true";
 }
 
 bool Browser::searchForm(const std::string& query) {
-    // Escape quotes and other special characters in the query
-    std::string escaped_query = query;
-    size_t pos = 0;
-    // Escape backslashes first to avoid double-escaping
-    while ((pos = escaped_query.find("\\", pos)) != std::string::npos) {
-        escaped_query.replace(pos, 1, "\\\\");
-        pos += 2;
-    }
-    // Then escape quotes
-    pos = 0;
-    while ((pos = escaped_query.find("'", pos)) != std::string::npos) {
-        escaped_query.replace(pos, 1, "\\'");
-        pos += 2;
-    }
-    
-    // Implementation for search form
-    std::string js_script = 
-        "(function() { "
-        "  try { "
-        "    var inputs = document.querySelectorAll(\"input[type='search'], input[name*='search'], input[placeholder*='search']\"); "
-        "    if (inputs.length > 0) { "
-        "      inputs[0].value = '" + escaped_query + "'; "
-        "      inputs[0].dispatchEvent(new Event('input', { bubbles: true })); "
-        "      var form = inputs[0].closest('form'); "
-        "      if (form) { "
-        "        form.submit(); "
-        "        return 'true'; "
-        "      } "
-        "    } "
-        "    return 'false'; "
-        "  } catch(e) { "
-        "    return 'false'; "
-        "  } "
-        "})()";
-    
-    std::string result = executeJavascriptSync(js_script);
-    return result == "true";
+    // Fills the first search-like input and submits its form
+    return callPageRuntime("search", {query}) == "true";
 }
 
 bool Browser::selectOption(const std::string& selector, const std::string& value) {
-    // Wait for element and add a small delay
     // REPLACED: Event-driven element ready detection instead of blocking wait(10)
+    std::string result = callPageRuntime("select", {selector, value});
     
-    // Escape quotes and other special characters in the value
-    std::string escaped_value = value;
-    size_t pos = 0;
-    while ((pos = escaped_value.find("'", pos)) != std::string::npos) {
-        escaped_value.replace(pos, 1, "\\'");
-        pos += 2;
-    }
-    // Also escape backslashes
-    pos = 0;
-    while ((pos = escaped_value.find("\\", pos)) != std::string::npos) {
-        escaped_value.replace(pos, 1, "\\\\");
-        pos += 2;
-    }
-    
-    std::string js_script = 
-        "(function() { "
-        "  try { "
-        "    var select = document.querySelector('" + escapeSelectorForSingleQuotes(selector) + "'); "
-        "    if (select) { "
-        "      select.focus(); "
-        "      select.value = '" + escaped_value + "'; "
-        "      select.dispatchEvent(new Event('change', { bubbles: true })); "
-        "      select.dispatchEvent(new Event('blur', { bubbles: true })); "
-        "      return 'true'; "
-        "    } "
-        "    return 'false'; "
-        "  } catch(e) { "
-        "    return 'error: ' + e.message; "
-        "  } "
-        "})()";
-    
-    std::string result = executeJavascriptSync(js_script);
-    
-    // Add verification step with delay (optimized for tests)
     if (result == "true") {
-        // REPLACED: Event-driven value processing instead of blocking wait(5)
-        
         // Verify the value was actually set
-        std::string escaped_selector_verify = escapeSelectorForSingleQuotes(selector);
-        std::string verifyJs = "document.querySelector('" + escaped_selector_verify + "') ? document.querySelector('" + escaped_selector_verify + "').value : 'NOT_FOUND'";
-        std::string actualValue = executeJavascriptSync(verifyJs);
+        std::string actualValue = callPageRuntime("value", {selector});
         
-        if (actualValue == escaped_value || actualValue == value) {
+        if (actualValue == value) {
             return true;
-        } else {
-            debug_output("Warning: Select verification failed. Expected: '" + value + "', Got: '" + actualValue + "'");
-            
-            // Try alternative method using selectedIndex
-            std::string altJs = 
-                "try { "
-                "  var sel = document.querySelector('" + escapeSelectorForSingleQuotes(selector) + "'); "
-                "  if (sel) { "
-                "    for (var i = 0; i < sel.options.length; i++) { "
-                "      if (sel.options[i].value === '" + escaped_value + "') { "
-                "        sel.selectedIndex = i; "
-                "        sel.dispatchEvent(new Event('change', { bubbles: true })); "
-                "        return 'retry_success'; "
-                "      } "
-                "    } "
-                "  } "
-                "  return 'retry_failed'; "
-                "} catch(e) { return 'retry_error'; }";
-            
-            std::string retryResult = executeJavascriptSync(altJs);
-            if (retryResult == "retry_success") {
-                // REPLACED: Event-driven retry completion instead of blocking wait(25)
-            }
-            return retryResult == "retry_success";
         }
+        
+        debug_output("Warning: Select verification failed. Expected: '" + value + "', Got: '" + actualValue + "'");
+        
+        // Try alternative method using selectedIndex
+        return callPageRuntime("selectByOption", {selector, value}) == "retry_success";
     }
     
     debug_output("selectOption failed: " + result);
@@ -401,37 +145,12 @@ bool Browser::selectOption(const std::string& selector, const std::string& value
 }
 
 bool Browser::checkElement(const std::string& selector) {
-    // Small delay to ensure element is ready
     // REPLACED: Event-driven element ready detection instead of blocking wait(10)
+    std::string result = callPageRuntime("setChecked", {selector, "true"});
     
-    std::string js_script = 
-        "(function() { "
-        "  try { "
-        "    var element = document.querySelector('" + escapeSelectorForSingleQuotes(selector) + "'); "
-        "    if (element) { "
-        "      element.focus(); "
-        "      element.checked = true; "
-        "      element.dispatchEvent(new Event('change', { bubbles: true })); "
-        "      element.dispatchEvent(new Event('click', { bubbles: true })); "
-        "      element.dispatchEvent(new Event('blur', { bubbles: true })); "
-        "      return 'true'; "
-        "    } "
-        "    return 'false'; "
-        "  } catch(e) { "
-        "    return 'error: ' + e.message; "
-        "  } "
-        "})()";
-    
-    std::string result = executeJavascriptSync(js_script);
-    
-    // Add verification step with delay
     if (result == "true") {
-        // REPLACED: Event-driven change processing instead of blocking wait(5)
-        
         // Verify the checkbox was actually checked
-        std::string escaped_selector_verify = escapeSelectorForSingleQuotes(selector);
-        std::string verifyJs = "document.querySelector('" + escaped_selector_verify + "') ? document.querySelector('" + escaped_selector_verify + "').checked : false";
-        std::string actualValue = executeJavascriptSync(verifyJs);
+        std::string actualValue = callPageRuntime("isChecked", {selector});
         
         if (actualValue == "true") {
             return true;
@@ -445,37 +164,12 @@ bool Browser::checkElement(const std::string& selector) {
 }
 
 bool Browser::uncheckElement(const std::string& selector) {
-    // Small delay to ensure element is ready
     // REPLACED: Event-driven element ready detection instead of blocking wait(10)
+    std::string result = callPageRuntime("setChecked", {selector, "false"});
     
-    std::string js_script = 
-        "(function() { "
-        "  try { "
-        "    var element = document.querySelector('" + escapeSelectorForSingleQuotes(selector) + "'); "
-        "    if (element) { "
-        "      element.focus(); "
-        "      element.checked = false; "
-        "      element.dispatchEvent(new Event('change', { bubbles: true })); "
-        "      element.dispatchEvent(new Event('click', { bubbles: true })); "
-        "      element.dispatchEvent(new Event('blur', { bubbles: true })); "
-        "      return 'true'; "
-        "    } "
-        "    return 'false'; "
-        "  } catch(e) { "
-        "    return 'error: ' + e.message; "
-        "  } "
-        "})()";
-    
-    std::string result = executeJavascriptSync(js_script);
-    
-    // Add verification step with delay
     if (result == "true") {
-        // REPLACED: Event-driven change processing instead of blocking wait(5)
-        
         // Verify the checkbox was actually unchecked
-        std::string escaped_selector_verify = escapeSelectorForSingleQuotes(selector);
-        std::string verifyJs = "document.querySelector('" + escaped_selector_verify + "') ? document.querySelector('" + escaped_selector_verify + "').checked : true";
-        std::string actualValue = executeJavascriptSync(verifyJs);
+        std::string actualValue = callPageRuntime("isChecked", {selector});
         
         if (actualValue == "false") {
             return true;
@@ -489,71 +183,127 @@ bool Browser::uncheckElement(const std::string& selector) {
 }
 
 bool Browser::focusElement(const std::string& selector) {
-    std::string js_script = 
-        "(function() { "
-        "  try { "
-        "    var element = document.querySelector('" + escapeSelectorForSingleQuotes(selector) + "'); "
-        "    if (element) { "
-        "      element.focus(); "
-        "      return true; "
-        "    } "
-        "    return false; "
-        "  } catch(e) { "
-        "    return false; "
-        "  } "
-        "})()";
-    
-    std::string result = executeJavascriptSync(js_script);
-    return result == "true";
+    return callPageRuntime("focus", {selector}) == "true";
 }
 
-// ========== Element Query Methods ==========
+std::map<std::string, std::string> Browser::fillForm(const std::string& fields_json) {
+    std::map<std::string, std::string> status;
+    
+    Json::Value fields;
+    Json::Reader reader;
+    if (!reader.parse(fields_json, fields) || !fields.isObject()) {
+        debug_output("fillForm: field map is not a JSON object");
+        return status;
+    }
+    
+    // The raw text goes to the page so fields fill in the order they were written
+    std::string result = callPageRuntime("fillForm", {fields_json});
+    Json::Value reported;
+    if (!reader.parse(result, reported) || !reported.isObject()) {
+        debug_output("fillForm failed: " + result);
+        for (const auto& key : fields.getMemberNames()) {
+            status[key] = "error: " + (result.empty() ? std::string("no result") : result);
+        }
+        return status;
+    }
+    
+    for (const auto& key : reported.getMemberNames()) {
+        status[key] = reported[key].asString();
+    }
+    return status;
+}
 
-bool Browser::elementExists(const std::string& selector) {
-    // Add timeout protection to prevent hanging
-    if (!webView) {
+std::map<std::string, std::string> Browser::fillForm(const std::map<std::string, std::string>& fields) {
+    Json::Value object(Json::objectValue);
+    for (const auto& field : fields) {
+        object[field.first] = field.second;
+    }
+    Json::StreamWriterBuilder builder;
+    builder["indentation"] = "";
+    return fillForm(Json::writeString(builder, object));
+}
+
+// ========== File Selection ==========
+
+bool Browser::selectFiles(const std::string& selector, const std::vector<std::string>& paths, int timeout_ms) {
+    if (paths.empty()) {
         return false;
     }
     
-    // Check if a page is loaded
-    const gchar* uri = webkit_web_view_get_uri(webView);
-    if (!uri || strlen(uri) == 0) {
-        debug_output("No page loaded, elementExists returning false for: " + selector);
-        return false; // No page loaded, element cannot exist
+    // The web process opens the files itself, so hand it absolute paths
+    pending_file_selection_.clear();
+    for (const auto& path : paths) {
+        std::error_code ec;
+        std::filesystem::path absolute = std::filesystem::absolute(path, ec);
+        pending_file_selection_.push_back(ec ? path : absolute.string());
     }
+    file_chooser_answered_ = false;
+    file_chooser_selected_ = 0;
     
-    // Escape selector to prevent injection
-    std::string escaped_selector = selector;
-    size_t pos = 0;
-    while ((pos = escaped_selector.find("'", pos)) != std::string::npos) {
-        escaped_selector.replace(pos, 1, "\\'");
-        pos += 2;
+    std::string opened = callPageRuntime("openFileChooser", {selector});
+    if (opened != "OPENED") {
+        debug_output("selectFiles: " + selector + " " + opened);
+        pending_file_selection_.clear();
+        return false;
     }
     
-    std::string js_script = 
-        "(function() { "
-        "  try { "
-        "    if (!document || !document.querySelector) return 'NO_DOCUMENT'; "
-        "    return document.querySelector(\"" + escaped_selector + "\") !== null; "
-        "  } catch(e) { "
-        "    return 'SELECTOR_ERROR:' + e.message; "
-        "  } "
-        "})()";
+    // Both the chooser request and the input's change arrive asynchronously
+    bool timed_out = false;
+    guint timeout_id = g_timeout_add(timeout_ms, [](gpointer user_data) -> gboolean {
+        *static_cast<bool*>(user_data) = true;
+        return G_SOURCE_REMOVE;
+    }, &timed_out);
     
-    std::string result = executeJavascriptSync(js_script);
+    while (!file_chooser_answered_ && !timed_out) {
+        g_main_context_iteration(g_main_context_default(), TRUE);
+    }
+    pending_file_selection_.clear();
     
-    // Check for various error conditions
-    if (result.empty() || result == "NO_DOCUMENT") {
-        debug_output("Document not ready for selector: " + selector);
-        return false;
+    bool selected = false;
+    while (file_chooser_answered_ && !timed_out) {
+        std::string count = callPageRuntime("fileCount", {selector});
+        if (!count.empty() && std::all_of(count.begin(), count.end(), ::isdigit) &&
+            std::stoul(count) >= file_chooser_selected_) {
+            selected = true;
+            break;
+        }
+        g_main_context_iteration(g_main_context_default(), TRUE);
     }
     
-    if (result.find("SELECTOR_ERROR:") == 0) {
-        debug_output("Invalid CSS selector: " + selector + " (" + result.substr(15) + ")");
-        return false; // Don't throw, just return false
+    if (!timed_out) {
+        g_source_remove(timeout_id);
+    }
+    if (!selected) {
+        debug_output("selectFiles: " + std::string(file_chooser_answered_ ? "files not applied to " : "no file chooser request for ") + selector);
+    }
+    return selected;
+}
+
+void Browser::notifyFileChooser(WebKitFileChooserRequest* request) {
+    if (pending_file_selection_.empty()) {
+        debug_output("File chooser request blocked (headless mode)");
+        webkit_file_chooser_request_cancel(request);
+        return;
     }
     
-    return result == "true";
+    size_t count = webkit_file_chooser_request_get_select_multiple(request) ? pending_file_selection_.size() : 1;
+    std::vector<const gchar*> files;
+    for (size_t i = 0; i < count; ++i) {
+        files.push_back(pending_file_selection_[i].c_str());
+    }
+    files.push_back(nullptr);
+    
+    webkit_file_chooser_request_select_files(request, files.data());
+    debug_output("File chooser answered with " + std::to_string(count) + " file(s)");
+    file_chooser_selected_ = count;
+    file_chooser_answered_ = true;
+    pending_file_selection_.clear();
+}
+
+// ========== Element Query Methods ==========
+
+bool Browser::elementExists(const std::string& selector) {
+    return elementExistsWithValidation(selector) == 1;
 }
 
 int Browser::elementExistsWithValidation(const std::string& selector) {
@@ -569,25 +319,7 @@ int Browser::elementExistsWithValidation(const std::string& selector) {
         return 0; // No page loaded, element cannot exist
     }
     
-    // Escape selector to prevent injection
-    std::string escaped_selector = selector;
-    size_t pos = 0;
-    while ((pos = escaped_selector.find("'", pos)) != std::string::npos) {
-        escaped_selector.replace(pos, 1, "\\'");
-        pos += 2;
-    }
-    
-    std::string js_script = 
-        "(function() { "
-        "  try { "
-        "    if (!document || !document.querySelector) return 'NO_DOCUMENT'; "
-        "    return document.querySelector(\"" + escaped_selector + "\") !== null; "
-        "  } catch(e) { "
-        "    return 'SELECTOR_ERROR:' + e.message; "
-        "  } "
-        "})()";
-    
-    std::string result = executeJavascriptSync(js_script);
+    std::string result = callPageRuntime("exists", {selector});
     
     // Check for various error conditions
     if (result.empty() || result == "NO_DOCUMENT") {
@@ -604,24 +336,7 @@ int Browser::elementExistsWithValidation(const std::string& selector) {
 }
 
 int Browser::countElements(const std::string& selector) {
-    // Escape single quotes in the selector for JavaScript
-    std::string escaped_selector = selector;
-    size_t pos = 0;
-    while ((pos = escaped_selector.find("'", pos)) != std::string::npos) {
-        escaped_selector.replace(pos, 1, "\\'");
-        pos += 2;
-    }
-    
-    std::string js_script = 
-        "(function() { "
-        "  try { "
-        "    return document.querySelectorAll(\"" + escaped_selector + "\").length; "
-        "  } catch(e) { "
-        "    return 'SELECTOR_ERROR:' + e.message; "
-        "  } "
-        "})()";
-    
-    std::string result = executeJavascriptSync(js_script);
+    std::string result = callPageRuntime("count", {selector});
     
     // Check if we got a selector error
     if (result.find("SELECTOR_ERROR:") == 0) {
@@ -636,52 +351,22 @@ int Browser::countElements(const std::string& selector) {
 }
 
 std::string Browser::getElementHtml(const std::string& selector) {
-    std::string js_script = 
-        "(function() { "
-        "  try { "
-        "    var element = document.querySelector('" + escapeSelectorForSingleQuotes(selector) + "'); "
-        "    return element ? element.outerHTML : ''; "
-        "  } catch(e) { "
-        "    return ''; "
-        "  } "
-        "})()";
-    
-    return executeJavascriptSync(js_script);
+    // Streamed so large subtrees are not cut at the result cap
+    std::string html;
+    if (streamElementHtml(selector, [&html](const char* data, size_t length) { html.append(data, length); })) {
+        return html;
+    }
+    return callPageRuntime("html", {selector});
 }
 
 std::string Browser::getInnerText(const std::string& selector) {
-    // Escape single quotes in selector for JavaScript
-    std::string escaped_selector = selector;
-    size_t pos = 0;
-    while ((pos = escaped_selector.find("'", pos)) != std::string::npos) {
-        escaped_selector.replace(pos, 1, "\\'");
-        pos += 2;
-    }
-    
-    std::string js_script = 
-        "(function() { "
-        "try { "
-        "if (document.readyState === 'loading') { "
-        "return 'DOCUMENT_LOADING'; "
-        "} "
-        "var element = document.querySelector(\"" + escaped_selector + "\"); "
-        "if (!element) { "
-        "return 'ELEMENT_NOT_FOUND'; "
-        "} "
-        "var text = element.innerText || element.textContent || ''; "
-        "return text.trim(); "
-        "} catch(e) { "
-        "return 'JS_ERROR: ' + e.message; "
-        "} "
-        "})()";
-    
-    std::string result = executeJavascriptSync(js_script);
+    std::string result = callPageRuntime("innerText", {selector});
     
     // Handle special return values
     if (result == "DOCUMENT_LOADING") {
         // Wait a bit and retry once
         std::this_thread::sleep_for(std::chrono::milliseconds(500));
-        result = executeJavascriptSync(js_script);
+        result = callPageRuntime("innerText", {selector});
     }
     
     if (result == "ELEMENT_NOT_FOUND" || result.substr(0, 9) == "JS_ERROR:") {
@@ -692,25 +377,7 @@ std::string Browser::getInnerText(const std::string& selector) {
 }
 
 std::string Browser::getFirstNonEmptyText(const std::string& selector) {
-    std::string escaped_selector = escapeSelectorForSingleQuotes(selector);
-    
-    std::string js_script = 
-        "(function() { "
-        "  try { "
-        "    var elements = document.querySelectorAll('" + escaped_selector + "'); "
-        "    for (var i = 0; i < elements.length; i++) { "
-        "      var text = (elements[i].innerText || elements[i].textContent || '').trim(); "
-        "      if (text.length > 0) { "
-        "        return text; "
-        "      } "
-        "    } "
-        "    return ''; "
-        "  } catch(e) { "
-        "    return ''; "
-        "  } "
-        "})()";
-    
-    return executeJavascriptSync(js_script);
+    return callPageRuntime("firstText", {selector});
 }
 
 // ========== Attribute Methods ==========
@@ -727,152 +394,162 @@ std::string Browser::getAttribute(const std::string& selector, const std::string
         return "";
     }
     
-    // Escape the selector
-    std::string escaped_selector = selector;
-    size_t pos = 0;
-    while ((pos = escaped_selector.find("'", pos)) != std::string::npos) {
-        escaped_selector.replace(pos, 1, "\\'");
-        pos += 2;
+    // 'value' reads the live property rather than the attribute
+    return callPageRuntime("getAttr", {selector, attribute});
+}
+
+bool Browser::setAttribute(const std::string& selector, const std::string& attribute, const std::string& value) {
+    debug_output("Setting attribute '" + attribute + "' to '" + value + "' on selector '" + selector + "'");
+    
+    std::string result = callPageRuntime("setAttr", {selector, attribute, value});
+    debug_output("JavaScript result: " + result);
+    
+    if (result != "success") {
+        debug_output("setAttribute failed with result: " + result);
+        return false;
     }
     
-    // Escape the attribute name
-    std::string escaped_attribute = attribute;
-    pos = 0;
-    while ((pos = escaped_attribute.find("'", pos)) != std::string::npos) {
-        escaped_attribute.replace(pos, 1, "\\'");
-        pos += 2;
+    // Verify the attribute was actually set
+    std::string actualValue = callPageRuntime("attr", {selector, attribute});
+    debug_output("Verification result: " + actualValue);
+    
+    if (actualValue == value) {
+        debug_output("Attribute verification SUCCESS");
+        return true;
     }
     
-    std::string js_script = 
-        "(function() { "
-        "  if (!document) return ''; "
-        "  var element = document.querySelector(\"" + escaped_selector + "\"); "
-        "  if (!element) return ''; "
-        "  if ('" + escaped_attribute + "' === 'value') { "
-        "    return element.value || ''; "
-        "  } "
-        "  return element.getAttribute('" + escaped_attribute + "') || ''; "
-        "})()";
+    debug_output("Warning: Attribute verification failed. Expected: '" + value + "', Got: '" + actualValue + "'");
     
-    std::string result = executeJavascriptSync(js_script);
-    return result;
+    // Try alternative method with forced DOM update
+    std::string retryResult = callPageRuntime("forceAttr", {selector, attribute, value});
+    debug_output("Retry result: " + retryResult);
+    
+    if (retryResult.find("retry_success:") == 0) {
+        return retryResult.substr(14) == value;
+    }
+    return false;
 }
-bool Browser::setAttribute(const std::string& selector, const std::string& attribute, const std::string& value) {
-    // Small delay to ensure element is ready
-    // REPLACED: Event-driven element ready detection instead of blocking wait(10)
+
+// ========== Element Handles ==========
+
+ElementHandle Browser::query(const std::string& selector) {
+    std::string id = callPageRuntime("acquire", {selector});
     
-    // Escape the selector - this was missing!
-    std::string escaped_selector = selector;
-    size_t pos = 0;
-    while ((pos = escaped_selector.find("'", pos)) != std::string::npos) {
-        escaped_selector.replace(pos, 1, "\\'");
-        pos += 2;
+    if (id.rfind("SELECTOR_ERROR:", 0) == 0) {
+        debug_output("Invalid CSS selector: " + selector + " (" + id.substr(15) + ")");
+        return ElementHandle();
+    }
+    if (id.empty()) {
+        return ElementHandle();
+    }
+    return ElementHandle(id, selector, handle_generation_);
+}
+
+void Browser::releaseHandle(ElementHandle& handle) {
+    if (handle.valid()) {
+        callPageRuntime("release", {handle.id()});
+    }
+    handle = ElementHandle();
+}
+
+bool Browser::elementExists(const ElementHandle& handle) {
+    return handle.valid() && callPageRuntime("exists", {handle.ref()}) == "true";
+}
+
+bool Browser::fillInput(const ElementHandle& handle, const std::string& value) {
+    if (!handle.valid()) {
+        return false;
     }
     
-    // Escape the attribute name
-    std::string escaped_attribute = attribute;
-    pos = 0;
-    while ((pos = escaped_attribute.find("'", pos)) != std::string::npos) {
-        escaped_attribute.replace(pos, 1, "\\'");
-        pos += 2;
+    // Same trusted editing path as the selector overload; the runtime accepts
+    // the handle reference wherever it takes a selector
+    if (typeTrusted(handle.ref(), value)) {
+        return true;
     }
     
-    // Escape the value - improved escaping
-    std::string escaped_value = value;
-    pos = 0;
-    // Escape backslashes first to avoid double-escaping
-    while ((pos = escaped_value.find("\\", pos)) != std::string::npos) {
-        escaped_value.replace(pos, 1, "\\\\");
-        pos += 2;
+    // Fill, verify and fall back to the attribute in one call on the same element
+    std::string result = callPageRuntime("typeText", {handle.ref(), value});
+    debug_output("FillInput (handle " + handle.id() + ") result: '" + result + "'");
+    return result == "FILL_SUCCESS";
+}
+
+bool Browser::clickElement(const ElementHandle& handle) {
+    return handle.valid() && callPageRuntime("click", {handle.ref()}) == "CLICKED_SUCCESS";
+}
+
+bool Browser::focusElement(const ElementHandle& handle) {
+    return handle.valid() && callPageRuntime("focus", {handle.ref()}) == "true";
+}
+
+std::string Browser::getValue(const ElementHandle& handle) {
+    if (!handle.valid()) {
+        return "";
+    }
+    std::string value = callPageRuntime("value", {handle.ref()});
+    return value == "NOT_FOUND" ? "" : value;
+}
+
+std::string Browser::getInnerText(const ElementHandle& handle) {
+    if (!handle.valid()) {
+        return "";
     }
-    // Then escape quotes
-    pos = 0;
-    while ((pos = escaped_value.find("'", pos)) != std::string::npos) {
-        escaped_value.replace(pos, 1, "\\'");
-        pos += 2;
+    std::string result = callPageRuntime("innerText", {handle.ref()});
+    if (result == "ELEMENT_NOT_FOUND" || result == "DOCUMENT_LOADING" || result.substr(0, 9) == "JS_ERROR:") {
+        return "";
     }
+    return result;
+}
+
+std::string Browser::getElementHtml(const ElementHandle& handle) {
+    if (!handle.valid()) {
+        return "";
+    }
+    std::string html;
+    if (streamElementHtml(handle.ref(), [&html](const char* data, size_t length) { html.append(data, length); })) {
+        return html;
+    }
+    return callPageRuntime("html", {handle.ref()});
+}
+
+std::string Browser::getAttribute(const ElementHandle& handle, const std::string& attribute) {
+    return handle.valid() ? callPageRuntime("getAttr", {handle.ref(), attribute}) : "";
+}
+
+bool Browser::setAttribute(const ElementHandle& handle, const std::string& attribute, const std::string& value) {
+    return handle.valid() && callPageRuntime("setAttr", {handle.ref(), attribute, value}) == "success";
+}
+
+// ========== Bulk Extraction ==========
+
+long Browser::extractTable(const TableSpec& spec, const std::function<void(const Json::Value&)>& on_row) {
+    // Keeps each chunk well under the result cap even if every character needs 3 UTF-8 bytes
+    static const std::string CHUNK_CHARS = "30000";
     
-    debug_output("Setting attribute '" + attribute + "' to '" + value + "' on selector '" + selector + "'");
-    
-    std::string js_script = 
-        "(function() { "
-        "  try { "
-        "    var element = document.querySelector(\"" + escaped_selector + "\"); "
-        "    if (element) { "
-        "      element.setAttribute('" + escaped_attribute + "', '" + escaped_value + "'); "
-        "      return 'success'; "
-        "    } "
-        "    return 'element_not_found'; "
-        "  } catch(e) { "
-        "    return 'error: ' + e.message; "
-        "  } "
-        "})()";
-    
-    debug_output("Generated JavaScript: " + js_script);
-    
-    std::string result = executeJavascriptSync(js_script);
-    debug_output("JavaScript result: " + result);
+    std::string id = callPageRuntime("tableBegin", {tableSpecToJson(spec)});
+    if (id.empty() || id.rfind("SELECTOR_ERROR:", 0) == 0) {
+        debug_output("Invalid table spec for rows '" + spec.row_selector + "': " + id);
+        return -1;
+    }
     
-    // Check if the initial execution succeeded
-    if (result == "success") {
-        // REPLACED: Event-driven attribute processing instead of blocking wait(25)
-        
-        // Verify the attribute was actually set using same escaping
-        std::string verifyJs = 
-            "(function() { "
-            "  try { "
-            "    var element = document.querySelector(\"" + escaped_selector + "\"); "
-            "    if (element) { "
-            "      var attr = element.getAttribute('" + escaped_attribute + "'); "
-            "      return attr !== null ? attr : 'null_attribute'; "
-            "    } "
-            "    return 'element_not_found'; "
-            "  } catch(e) { "
-            "    return 'verify_error: ' + e.message; "
-            "  } "
-            "})()";
+    long rows = 0;
+    while (true) {
+        std::string chunk = callPageRuntime("tableNext", {id, CHUNK_CHARS});
         
-        std::string actualValue = executeJavascriptSync(verifyJs);
-        debug_output("Verification result: " + actualValue);
+        Json::Value cells;
+        Json::Reader reader;
+        if (!reader.parse(chunk, cells) || !cells.isArray()) {
+            debug_output("extractTable: unreadable chunk after " + std::to_string(rows) + " rows");
+            callPageRuntime("tableEnd", {id});
+            return -1;
+        }
+        if (cells.empty()) {
+            break;
+        }
         
-        if (actualValue == escaped_value || actualValue == value) {
-            debug_output("Attribute verification SUCCESS");
-            return true;
-        } else {
-            debug_output("Warning: Attribute verification failed. Expected: '" + value + "', Got: '" + actualValue + "'");
-            
-            // Try alternative method with forced DOM update
-            std::string altJs = 
-                "(function() { "
-                "  try { "
-                "    var el = document.querySelector(\"" + escaped_selector + "\"); "
-                "    if (el) { "
-                "      el.setAttribute('" + escaped_attribute + "', '" + escaped_value + "'); "
-                "      // Force DOM update "
-                "      el.offsetHeight; "
-                "      // Double-check it was set "
-                "      var check = el.getAttribute('" + escaped_attribute + "'); "
-                "      return check !== null ? 'retry_success:' + check : 'retry_failed'; "
-                "    } "
-                "    return 'retry_no_element'; "
-                "  } catch(e) { "
-                "    return 'retry_error: ' + e.message; "
-                "  } "
-                "})()";
-            
-            std::string retryResult = executeJavascriptSync(altJs);
-            debug_output("Retry result: " + retryResult);
-            
-            if (retryResult.find("retry_success:") == 0) {
-                // Extract the actual value after "retry_success:"
-                std::string retryValue = retryResult.substr(14);
-                // REPLACED: Event-driven retry completion instead of blocking wait(25)
-                return (retryValue == escaped_value || retryValue == value);
-            }
-            return false;
+        for (const auto& row : cells) {
+            on_row(row);
+            rows++;
         }
-    } else {
-        debug_output("setAttribute failed with result: " + result);
-        return false;
     }
+    return rows;
 }
@@ -0,0 +1,268 @@
+#include "Browser.h"
+#include <webkit/webkit.h>
+#include <libsoup/soup.h>
+#include <ctime>
+
+// External debug flag
+extern bool g_debug;
+
+// --fetch talks HTTP through libsoup directly instead of loading the URL in
+// the view: nothing is parsed, laid out or run, and the body streams to the
+// caller. The request is made to look like the page's own: same
+// User-Agent, Referer and cookies, and cookies it receives go back to WebKit.
+
+namespace {
+
+constexpr gsize FETCH_CHUNK = 64 * 1024;
+
+// Every async step below completes even when cancelled, so waiting for the
+// callback is always safe
+void iterateUntil(const bool& done) {
+    while (!done) {
+        g_main_context_iteration(g_main_context_default(), TRUE);
+    }
+}
+
+Cookie toCookie(SoupCookie* soup_cookie) {
+    Cookie cookie;
+    cookie.name = soup_cookie_get_name(soup_cookie);
+    cookie.value = soup_cookie_get_value(soup_cookie);
+    cookie.domain = soup_cookie_get_domain(soup_cookie) ? soup_cookie_get_domain(soup_cookie) : "";
+    cookie.path = soup_cookie_get_path(soup_cookie) ? soup_cookie_get_path(soup_cookie) : "/";
+    cookie.secure = soup_cookie_get_secure(soup_cookie);
+    cookie.httpOnly = soup_cookie_get_http_only(soup_cookie);
+    GDateTime* expires = soup_cookie_get_expires(soup_cookie);
+    cookie.expires = expires ? g_date_time_to_unix(expires) : -1;
+    return cookie;
+}
+
+struct CookieQuery {
+    bool done = false;
+    GList* cookies = nullptr;
+};
+
+struct SendResult {
+    bool done = false;
+    GInputStream* stream = nullptr;
+    GError* error = nullptr;
+};
+
+struct ReadResult {
+    bool done = false;
+    GBytes* bytes = nullptr;
+    GError* error = nullptr;
+};
+
+// Redirects are followed here rather than by libsoup so that every hop gets
+// its own Cookie header; browsers stop at 20
+constexpr int MAX_REDIRECTS = 20;
+
+// Cookies WebKit would send to url, HttpOnly ones included
+std::vector<Cookie> jarCookies(WebKitCookieManager* manager, const std::string& url, GCancellable* cancellable) {
+    std::vector<Cookie> cookies;
+    if (!manager) {
+        return cookies;
+    }
+    CookieQuery query;
+    webkit_cookie_manager_get_cookies(manager, url.c_str(), cancellable,
+        [](GObject* source, GAsyncResult* result, gpointer user_data) {
+            auto* query = static_cast<CookieQuery*>(user_data);
+            query->cookies = webkit_cookie_manager_get_cookies_finish(WEBKIT_COOKIE_MANAGER(source), result, nullptr);
+            query->done = true;
+        }, &query);
+    iterateUntil(query.done);
+    for (GList* item = query.cookies; item; item = item->next) {
+        cookies.push_back(toCookie(static_cast<SoupCookie*>(item->data)));
+    }
+    g_list_free_full(query.cookies, reinterpret_cast<GDestroyNotify>(soup_cookie_free));
+    return cookies;
+}
+
+std::string resolveLocation(const std::string& base, const char* location) {
+    GError* error = nullptr;
+    char* resolved = g_uri_resolve_relative(base.c_str(), location, G_URI_FLAGS_NONE, &error);
+    if (!resolved) {
+        g_error_free(error);
+        return "";
+    }
+    std::string url = resolved;
+    g_free(resolved);
+    return url;
+}
+
+} // namespace
+
+bool Browser::fetch(const std::string& url, const std::vector<Cookie>& cookies, FileOps::StreamingFileHash::Sink sink,
+                    int timeout_ms, FetchResponse& response) {
+    response = FetchResponse();
+    if (!fetch_session_) {
+        fetch_session_ = soup_session_new();
+    }
+
+    // One deadline for the whole exchange; expiry cancels whichever step is pending
+    GCancellable* cancellable = g_cancellable_new();
+    guint deadline_id = g_timeout_add(timeout_ms, [](gpointer user_data) -> gboolean {
+        g_cancellable_cancel(G_CANCELLABLE(user_data));
+        return G_SOURCE_REMOVE;
+    }, cancellable);
+
+    const char* user_agent = webkit_settings_get_user_agent(webkit_web_view_get_settings(webView));
+    std::string page_url = getCurrentUrl();
+
+    // Set-Cookie from earlier hops, newest first: they outrank both jars
+    std::vector<Cookie> received;
+    std::string hop_url = url;
+    SoupMessage* message = nullptr;
+    GInputStream* stream = nullptr;
+
+    for (int hop = 0;; ++hop) {
+        message = soup_message_new(SOUP_METHOD_GET, hop_url.c_str());
+        if (!message) {
+            response.error = "invalid URL: " + hop_url;
+            break;
+        }
+        soup_message_add_flags(message, SOUP_MESSAGE_NO_REDIRECT);
+
+        // Cookies are matched against this hop's URL, never carried across hosts
+        std::vector<Cookie> request_cookies = received;
+        std::vector<Cookie> jar = jarCookies(cookieManager, hop_url, cancellable);
+        request_cookies.insert(request_cookies.end(), jar.begin(), jar.end());
+        request_cookies.insert(request_cookies.end(), cookies.begin(), cookies.end());
+
+        SoupMessageHeaders* headers = soup_message_get_request_headers(message);
+        if (user_agent) {
+            soup_message_headers_replace(headers, "User-Agent", user_agent);
+        }
+        soup_message_headers_replace(headers, "Accept", "*/*");
+        // Re-evaluated per hop, so a redirect to another origin or down to
+        // http gets the trimmed Referer a browser would send
+        std::string referer = refererFor(page_url, hop_url);
+        if (!referer.empty()) {
+            soup_message_headers_replace(headers, "Referer", referer.c_str());
+        }
+        std::string cookie_header = cookieHeaderFor(request_cookies, hop_url, static_cast<int64_t>(std::time(nullptr)));
+        if (!cookie_header.empty()) {
+            soup_message_headers_replace(headers, "Cookie", cookie_header.c_str());
+        }
+
+        debug_output("Fetching " + hop_url + " with " + std::to_string(request_cookies.size()) + " candidate cookies");
+
+        SendResult sent;
+        soup_session_send_async(fetch_session_, message, G_PRIORITY_DEFAULT, cancellable,
+            [](GObject* source, GAsyncResult* result, gpointer user_data) {
+                auto* sent = static_cast<SendResult*>(user_data);
+                sent->stream = soup_session_send_finish(SOUP_SESSION(source), result, &sent->error);
+                sent->done = true;
+            }, &sent);
+        iterateUntil(sent.done);
+
+        if (!sent.stream) {
+            response.error = sent.error ? sent.error->message : "request failed";
+            if (sent.error) {
+                g_error_free(sent.error);
+            }
+            break;
+        }
+
+        response.status = soup_message_get_status(message);
+        response.reason = soup_message_get_reason_phrase(message) ? soup_message_get_reason_phrase(message) : "";
+        SoupMessageHeaders* response_headers = soup_message_get_response_headers(message);
+
+        // Every hop may set cookies, redirects included
+        GSList* set_cookies = soup_cookies_from_response(message);
+        for (GSList* item = set_cookies; item; item = item->next) {
+            SoupCookie* soup_cookie = static_cast<SoupCookie*>(item->data);
+            Cookie cookie = toCookie(soup_cookie);
+            response.set_cookies.push_back(cookie);
+            received.insert(received.begin(), cookie);
+            if (cookieManager) {
+                webkit_cookie_manager_add_cookie(cookieManager, soup_cookie, nullptr, nullptr, nullptr);
+            }
+        }
+        soup_cookies_free(set_cookies);
+
+        const char* location = soup_message_headers_get_one(response_headers, "Location");
+        if (!SOUP_STATUS_IS_REDIRECTION(response.status) || !location) {
+            const char* content_type = soup_message_headers_get_content_type(response_headers, nullptr);
+            response.content_type = content_type ? content_type : "";
+            goffset length = soup_message_headers_get_content_length(response_headers);
+            response.content_length = length > 0 ? static_cast<uint64_t>(length) : 0;
+            stream = sent.stream;
+            break;
+        }
+
+        g_input_stream_close(sent.stream, nullptr, nullptr);
+        g_object_unref(sent.stream);
+        std::string next_url = resolveLocation(hop_url, location);
+        if (next_url.empty()) {
+            response.error = std::string("invalid redirect: ") + location;
+            break;
+        }
+        if (hop == MAX_REDIRECTS) {
+            response.error = "too many redirects";
+            break;
+        }
+        debug_output("Fetch redirected (HTTP " + std::to_string(response.status) + ") to " + next_url);
+        g_object_unref(message);
+        message = nullptr;
+        hop_url = next_url;
+    }
+
+    if (stream) {
+        if (response.status >= 200 && response.status < 300) {
+            FileOps::Sha256 sha;
+            while (true) {
+                ReadResult read;
+                g_input_stream_read_bytes_async(stream, FETCH_CHUNK, G_PRIORITY_DEFAULT, cancellable,
+                    [](GObject* source, GAsyncResult* result, gpointer user_data) {
+                        auto* read = static_cast<ReadResult*>(user_data);
+                        read->bytes = g_input_stream_read_bytes_finish(G_INPUT_STREAM(source), result, &read->error);
+                        read->done = true;
+                    }, &read);
+                iterateUntil(read.done);
+
+                if (read.error) {
+                    response.error = read.error->message;
+                    g_error_free(read.error);
+                    break;
+                }
+                gsize size = 0;
+                const auto* data = static_cast<const uint8_t*>(g_bytes_get_data(read.bytes, &size));
+                if (size == 0) {
+                    g_bytes_unref(read.bytes);
+                    response.sha256 = sha.finishHex();
+                    break;
+                }
+                sha.update(data, size);
+                bool accepted = !sink || sink(data, size);
+                g_bytes_unref(read.bytes);
+                if (!accepted) {
+                    response.error = "output closed";
+                    break;
+                }
+                response.received_bytes += size;
+            }
+        }
+
+        g_input_stream_close(stream, nullptr, nullptr);
+        g_object_unref(stream);
+    }
+
+    if (g_cancellable_is_cancelled(cancellable)) {
+        // The deadline may also pass just after the last step completed
+        if (!response.error.empty()) {
+            response.error = "timed out after " + std::to_string(timeout_ms) + " ms";
+        }
+    } else {
+        g_source_remove(deadline_id);
+    }
+    g_object_unref(cancellable);
+    if (message) {
+        g_object_unref(message);
+    }
+
+    debug_output("Fetch " + url + ": HTTP " + std::to_string(response.status) + ", " +
+                 std::to_string(response.received_bytes) + " bytes" +
+                 (response.error.empty() ? "" : " (" + response.error + ")"));
+    return response.ok();
+}
@@ -0,0 +1,264 @@
+#include "DomMirror.h"
+#include <algorithm>
+
+namespace {
+
+// Inserting after this id means "append"
+const int APPEND = -1;
+
+bool isVoidElement(const std::string& name) {
+    static const char* const VOID_ELEMENTS[] = {
+        "area", "base", "br", "col", "embed", "hr", "img", "input",
+        "link", "meta", "source", "track", "wbr"
+    };
+    for (const char* tag : VOID_ELEMENTS) {
+        if (name == tag) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void escapeInto(const std::string& text, bool attribute, std::string& out) {
+    for (char c : text) {
+        switch (c) {
+            case '&': out += "&amp;"; break;
+            case '<': out += attribute ? "<" : "&lt;"; break;
+            case '>': out += attribute ? ">" : "&gt;"; break;
+            case '"': out += attribute ? "&quot;" : "\""; break;
+            default: out += c;
+        }
+    }
+}
+
+} // namespace
+
+DomMirror::Node* DomMirror::node(int id) {
+    if (id == 0) {
+        return &document_;
+    }
+    auto it = nodes_.find(id);
+    return it != nodes_.end() ? &it->second : nullptr;
+}
+
+const DomMirror::Node* DomMirror::find(int id) const {
+    return const_cast<DomMirror*>(this)->node(id);
+}
+
+int DomMirror::root() const {
+    for (int child : document_.children) {
+        const Node* n = find(child);
+        if (n && n->type == 1) {
+            return child;
+        }
+    }
+    return 0;
+}
+
+void DomMirror::clear() {
+    document_ = Node();
+    nodes_.clear();
+    sequence_ = 0;
+    loaded_ = false;
+}
+
+// Row: [id, parent, 1, tag, {attrs}] or [id, parent, 3|8, data]
+bool DomMirror::addRow(const Json::Value& row, int previous) {
+    if (!row.isArray() || row.size() < 4 || !row[0].isInt() || !row[1].isInt() || !row[2].isInt()) {
+        return false;
+    }
+    int id = row[0].asInt();
+    Node* parent = node(row[1].asInt());
+    if (id <= 0 || !parent) {
+        return false;
+    }
+    if (nodes_.count(id)) {
+        remove(id);
+        parent = node(row[1].asInt());
+        if (!parent) {
+            return false;
+        }
+    }
+
+    auto& children = parent->children;
+    auto at = children.end();
+    if (previous == 0) {
+        at = children.begin();
+    } else if (previous != APPEND) {
+        auto prev = std::find(children.begin(), children.end(), previous);
+        if (prev != children.end()) {
+            at = prev + 1;
+        }
+    }
+    children.insert(at, id);
+
+    Node& created = nodes_[id];
+    created.parent = row[1].asInt();
+    created.type = row[2].asInt();
+    if (created.type == 1) {
+        created.name = row[3].asString();
+        const Json::Value& attrs = row.get(4u, Json::Value());
+        if (attrs.isObject()) {
+            for (const auto& name : attrs.getMemberNames()) {
+                created.attributes[name] = attrs[name].asString();
+            }
+        }
+    } else {
+        created.text = row[3].asString();
+    }
+    return true;
+}
+
+void DomMirror::remove(int id) {
+    auto it = nodes_.find(id);
+    if (it == nodes_.end()) {
+        return;
+    }
+    Node* parent = node(it->second.parent);
+    if (parent) {
+        auto& siblings = parent->children;
+        siblings.erase(std::remove(siblings.begin(), siblings.end(), id), siblings.end());
+    }
+
+    // Drop the subtree without recursing; pages can nest deeply
+    std::vector<int> pending = {id};
+    while (!pending.empty()) {
+        int current = pending.back();
+        pending.pop_back();
+        auto found = nodes_.find(current);
+        if (found == nodes_.end()) {
+            continue;
+        }
+        pending.insert(pending.end(), found->second.children.begin(), found->second.children.end());
+        nodes_.erase(found);
+    }
+}
+
+bool DomMirror::load(const std::string& snapshot_json) {
+    Json::Value root;
+    Json::Reader reader;
+    clear();
+    if (!reader.parse(snapshot_json, root) || !root.isObject() || !root["nodes"].isArray()) {
+        return false;
+    }
+    for (const auto& row : root["nodes"]) {
+        if (!addRow(row, APPEND)) {
+            clear();
+            return false;
+        }
+    }
+    sequence_ = root.get("seq", 0).asUInt64();
+    loaded_ = true;
+    return true;
+}
+
+bool DomMirror::apply(const std::string& diff_json) {
+    Json::Value diff;
+    Json::Reader reader;
+    if (!loaded_ || !reader.parse(diff_json, diff) || !diff.isObject() || !diff["ops"].isArray()) {
+        return false;
+    }
+    if (diff.get("seq", 0).asUInt64() != sequence_ + 1) {
+        loaded_ = false;
+        return false;
+    }
+
+    for (const auto& op : diff["ops"]) {
+        std::string kind = op.isArray() && op.size() >= 2 ? op[0].asString() : "";
+        if (kind == "remove") {
+            remove(op[1].asInt());
+        } else if (kind == "insert" && op.size() >= 4 && op[3].isArray()) {
+            // The first row is the inserted node; the rest are its descendants in order
+            const Json::Value& rows = op[3];
+            for (Json::ArrayIndex i = 0; i < rows.size(); ++i) {
+                if (!addRow(rows[i], i == 0 ? op[2].asInt() : APPEND)) {
+                    loaded_ = false;
+                    return false;
+                }
+            }
+        } else if (kind == "attr" && op.size() >= 4) {
+            Node* target = node(op[1].asInt());
+            if (target && target->type == 1) {
+                if (op[3].isNull()) {
+                    target->attributes.erase(op[2].asString());
+                } else {
+                    target->attributes[op[2].asString()] = op[3].asString();
+                }
+            }
+        } else if (kind == "text" && op.size() >= 3) {
+            Node* target = node(op[1].asInt());
+            if (target && target->type != 1) {
+                target->text = op[2].asString();
+            }
+        } else {
+            loaded_ = false;
+            return false;
+        }
+    }
+    sequence_++;
+    return true;
+}
+
+void DomMirror::serialize(int id, std::string& out) const {
+    const Node* n = find(id);
+    if (!n) {
+        return;
+    }
+    if (n->type == 3) {
+        // Script and style bodies are raw text
+        const Node* parent = find(n->parent);
+        bool raw = parent && (parent->name == "script" || parent->name == "style");
+        if (raw) {
+            out += n->text;
+        } else {
+            escapeInto(n->text, false, out);
+        }
+        return;
+    }
+    if (n->type == 8) {
+        out += "<!--" + n->text + "-->";
+        return;
+    }
+    if (n->type == 1) {
+        out += '<' + n->name;
+        for (const auto& attr : n->attributes) {
+            out += ' ' + attr.first + "=\"";
+            escapeInto(attr.second, true, out);
+            out += '"';
+        }
+        out += '>';
+        if (isVoidElement(n->name)) {
+            return;
+        }
+    }
+    for (int child : n->children) {
+        serialize(child, out);
+    }
+    if (n->type == 1) {
+        out += "</" + n->name + '>';
+    }
+}
+
+std::string DomMirror::html(int id) const {
+    std::string out;
+    serialize(id, out);
+    return out;
+}
+
+std::string DomMirror::textContent(int id) const {
+    const Node* n = find(id);
+    if (!n) {
+        return "";
+    }
+    if (n->type != 1 && id != 0) {
+        return n->text;
+    }
+    std::string text;
+    for (int child : n->children) {
+        const Node* c = find(child);
+        if (c && c->type != 8) {
+            text += textContent(child);
+        }
+    }
+    return text;
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstdint>
+#include <json/json.h>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Client-side copy of a page's DOM, built from Browser::snapshotDom() and
+// kept current by applying the diffs published after it. Node ids are the
+// page runtime's; id 0 is the document itself.
+class DomMirror {
+public:
+    struct Node {
+        int parent = 0;
+        int type = 0;                 // 1 element, 3 text, 8 comment
+        std::string name;             // lower-case tag for elements
+        std::string text;             // data of text and comment nodes
+        std::map<std::string, std::string> attributes;
+        std::vector<int> children;
+    };
+
+    // Replace the mirror with a snapshot ({"seq":0,"nodes":[...]})
+    bool load(const std::string& snapshot_json);
+
+    // Apply one diff ({"seq":n,"ops":[...]}). Returns false on a malformed
+    // diff or a sequence gap; the mirror is then stale and rejects further
+    // diffs until the next load().
+    bool apply(const std::string& diff_json);
+
+    void clear();
+    size_t size() const { return nodes_.size(); }      // excluding the document
+    uint64_t sequence() const { return sequence_; }
+    int root() const;                                   // document element id, 0 if none
+    const Node* find(int id) const;
+
+    // Serialized markup of the subtree at id (the whole document by default)
+    std::string html(int id = 0) const;
+    std::string textContent(int id) const;
+
+private:
+    Node document_;
+    std::unordered_map<int, Node> nodes_;
+    uint64_t sequence_ = 0;
+    bool loaded_ = false;
+
+    Node* node(int id);
+    bool addRow(const Json::Value& row, int previous);
+    void remove(int id);
+    void serialize(int id, std::string& out) const;
+};
@@ -0,0 +1,382 @@
+#include "Browser.h"
+#include "../FileOps/PathUtils.h"
+#include <webkit/webkit.h>
+#include <filesystem>
+#include <unistd.h>
+
+// External debug flag
+extern bool g_debug;
+
+// Downloads are driven by WebKit itself: the network session announces each
+// one, decide-destination picks the file, and received-data / finished /
+// failed report exact progress and completion. Nothing watches the disk.
+// Each file is hashed as it grows, so its SHA-256 is known at completion.
+// Streamed downloads reuse that read to forward the bytes to a sink.
+
+namespace {
+
+gboolean download_decide_destination(WebKitDownload* download, gchar* suggested_filename, gpointer user_data) {
+    Browser* browser = static_cast<Browser*>(user_data);
+    if (!browser || !browser->isObjectValid()) {
+        return FALSE;
+    }
+    return browser->notifyDownloadDestination(download, suggested_filename) ? TRUE : FALSE;
+}
+
+void download_received_data(WebKitDownload* download, guint64 data_length, gpointer user_data) {
+    Browser* browser = static_cast<Browser*>(user_data);
+    if (browser && browser->isObjectValid()) {
+        browser->notifyDownloadProgress(download);
+    }
+}
+
+void download_failed(WebKitDownload* download, GError* error, gpointer user_data) {
+    Browser* browser = static_cast<Browser*>(user_data);
+    if (browser && browser->isObjectValid()) {
+        browser->notifyDownloadFailed(download, error);
+    }
+}
+
+// Also emitted after failed
+void download_finished(WebKitDownload* download, gpointer user_data) {
+    Browser* browser = static_cast<Browser*>(user_data);
+    if (browser && browser->isObjectValid()) {
+        browser->notifyDownloadFinished(download);
+    }
+}
+
+// Streamed downloads only pass through the file system; keep them off the
+// disk where a tmpfs is available. Each one gets a fresh private (0700)
+// directory with an unpredictable name, "" if none could be made.
+std::string makeStreamScratchDirectory() {
+    std::string base;
+    const char* runtime = g_getenv("XDG_RUNTIME_DIR");
+    std::error_code ec;
+    if (runtime && *runtime && std::filesystem::is_directory(runtime, ec)) {
+        base = runtime;
+    } else if (std::filesystem::is_directory("/dev/shm", ec)) {
+        base = "/dev/shm";
+    } else {
+        base = g_get_tmp_dir();
+    }
+    std::string tmpl = base + "/hweb-stream-XXXXXX";
+    return g_mkdtemp(&tmpl[0]) ? tmpl : "";
+}
+
+} // namespace
+
+void download_started_handler(WebKitNetworkSession* session, WebKitDownload* download, gpointer user_data) {
+    Browser* browser = static_cast<Browser*>(user_data);
+    if (browser && browser->isObjectValid()) {
+        browser->notifyDownloadStarted(download);
+    }
+}
+
+// ========== Download Directory ==========
+
+void Browser::setDownloadDirectory(const std::string& directory) {
+    download_dir_ = directory;
+}
+
+std::string Browser::getDownloadDirectory() const {
+    if (!download_dir_.empty()) {
+        return download_dir_;
+    }
+    if (!config_.file_settings.download_dir.empty()) {
+        return config_.file_settings.download_dir;
+    }
+    return FileOps::PathUtils::getDefaultDownloadDirectory();
+}
+
+std::vector<DownloadRecord> Browser::getDownloads() const {
+    return downloads_;
+}
+
+bool Browser::claimDownload(uint64_t id) {
+    for (auto& record : downloads_) {
+        if (record.id == id) {
+            if (record.claimed) {
+                return false;
+            }
+            record.claimed = true;
+            return true;
+        }
+    }
+    return false;
+}
+
+// ========== Starting and Cancelling ==========
+
+uint64_t Browser::startDownload(const std::string& uri) {
+    WebKitDownload* download = webkit_web_view_download_uri(webView, uri.c_str());
+    if (!download) {
+        return 0;
+    }
+    // Track it now rather than relying on download-started ordering
+    notifyDownloadStarted(download);
+    DownloadRecord* record = findDownload(download);
+    uint64_t id = record ? record->id : 0;
+    g_object_unref(download);
+    return id;
+}
+
+uint64_t Browser::streamDownload(const std::string& uri, FileOps::StreamingFileHash::Sink sink) {
+    uint64_t id = startDownload(uri);
+    for (auto& entry : download_index_) {
+        if (downloads_[entry.second].id == id) {
+            downloads_[entry.second].streamed = true;
+            auto& hash = download_hashes_[entry.first];
+            hash = std::make_unique<FileOps::StreamingFileHash>();
+            hash->setSink(std::move(sink));
+            hash->setReleaseConsumed(true);
+            return id;
+        }
+    }
+    return 0;
+}
+
+bool Browser::cancelDownload(uint64_t id) {
+    for (auto& entry : download_index_) {
+        if (downloads_[entry.second].id == id) {
+            webkit_download_cancel(entry.first);
+            return true;
+        }
+    }
+    return false;
+}
+
+// ========== Signal Notifications ==========
+
+DownloadRecord* Browser::findDownload(WebKitDownload* download) {
+    auto it = download_index_.find(download);
+    return it != download_index_.end() ? &downloads_[it->second] : nullptr;
+}
+
+void Browser::notifyDownloadStarted(WebKitDownload* download) {
+    // The network session is shared; only track downloads of this view
+    if (webkit_download_get_web_view(download) != webView || download_index_.count(download)) {
+        return;
+    }
+    
+    DownloadRecord record;
+    record.id = ++download_counter_;
+    record.started = std::chrono::steady_clock::now();
+    WebKitURIRequest* request = webkit_download_get_request(download);
+    if (request && webkit_uri_request_get_uri(request)) {
+        record.uri = webkit_uri_request_get_uri(request);
+    }
+    
+    g_object_ref(download);
+    download_index_[download] = downloads_.size();
+    downloads_.push_back(record);
+    
+    webkit_download_set_allow_overwrite(download, FALSE);
+    g_signal_connect(download, "decide-destination", G_CALLBACK(download_decide_destination), this);
+    g_signal_connect(download, "received-data", G_CALLBACK(download_received_data), this);
+    g_signal_connect(download, "failed", G_CALLBACK(download_failed), this);
+    g_signal_connect(download, "finished", G_CALLBACK(download_finished), this);
+    
+    debug_output("Download started: " + record.uri);
+}
+
+bool Browser::notifyDownloadDestination(WebKitDownload* download, const char* suggested_filename) {
+    DownloadRecord* record = findDownload(download);
+    if (!record) {
+        return false;
+    }
+    
+    std::string directory;
+    if (record->streamed) {
+        directory = makeStreamScratchDirectory();
+        if (directory.empty()) {
+            // Never fall back to a shared, guessable location
+            record->state = DownloadRecord::State::FAILED;
+            record->error = "cannot create a private scratch directory";
+            record->ended = std::chrono::steady_clock::now();
+            debug_output("Download failed: " + record->uri + " (" + record->error + ")");
+            emitDownloadEvent(BrowserEvents::EventType::DOWNLOAD_FAILED, *record);
+            webkit_download_cancel(download);
+            return true;
+        }
+    } else {
+        directory = getDownloadDirectory();
+        FileOps::PathUtils::createDirectoriesIfNeeded(directory);
+    }
+    
+    std::set<std::string> reserved;
+    for (const auto& other : downloads_) {
+        if (!other.destination.empty()) {
+            reserved.insert(other.destination);
+        }
+    }
+    
+    record->suggested_filename = suggested_filename ? suggested_filename : "";
+    record->destination = uniqueDownloadPath(directory, sanitizeDownloadFilename(record->suggested_filename), reserved);
+    webkit_download_set_destination(download, record->destination.c_str());
+    
+    debug_output("Download destination: " + record->destination);
+    emitDownloadEvent(BrowserEvents::EventType::DOWNLOAD_STARTED, *record);
+    return true;
+}
+
+void Browser::notifyDownloadProgress(WebKitDownload* download) {
+    DownloadRecord* record = findDownload(download);
+    if (!record) {
+        return;
+    }
+    
+    record->received_bytes = webkit_download_get_received_data_length(download);
+    if (record->expected_bytes == 0) {
+        WebKitURIResponse* response = webkit_download_get_response(download);
+        if (response) {
+            record->expected_bytes = webkit_uri_response_get_content_length(response);
+        }
+    }
+    
+    // Hash what has reached the disk so far. WebKit may write to an
+    // intermediate <destination>.wkdownload and rename it when done; the
+    // open descriptor follows the rename.
+    if (!record->destination.empty()) {
+        auto& hash = download_hashes_[download];
+        if (!hash) {
+            hash = std::make_unique<FileOps::StreamingFileHash>();
+        }
+        if (!hash->advance(record->destination + ".wkdownload")) {
+            hash->advance(record->destination);
+        }
+    }
+    
+    emitDownloadEvent(BrowserEvents::EventType::DOWNLOAD_PROGRESS, *record);
+    
+    // Subscribers (the scheduler) may have started queued downloads, which can
+    // move downloads_; look the record up again rather than reuse the pointer
+    record = findDownload(download);
+    if (!record) {
+        return;
+    }
+    
+    // The reader of a stream went away
+    auto hash = download_hashes_.find(download);
+    if (hash != download_hashes_.end() && hash->second->sinkFailed() && !record->done()) {
+        debug_output("Stream sink closed, cancelling download: " + record->uri);
+        webkit_download_cancel(download);
+    }
+}
+
+void Browser::notifyDownloadFailed(WebKitDownload* download, GError* error) {
+    DownloadRecord* record = findDownload(download);
+    if (!record || record->done()) {
+        return;
+    }
+    
+    bool cancelled = error && g_error_matches(error, WEBKIT_DOWNLOAD_ERROR, WEBKIT_DOWNLOAD_ERROR_CANCELLED_BY_USER);
+    record->state = cancelled ? DownloadRecord::State::CANCELLED : DownloadRecord::State::FAILED;
+    record->error = error && error->message ? error->message : "download failed";
+    record->ended = std::chrono::steady_clock::now();
+    debug_output("Download failed: " + record->uri + " (" + record->error + ")");
+    emitDownloadEvent(BrowserEvents::EventType::DOWNLOAD_FAILED, *record);
+}
+
+void Browser::notifyDownloadFinished(WebKitDownload* download) {
+    DownloadRecord* record = findDownload(download);
+    if (!record) {
+        return;
+    }
+    
+    bool finished = !record->done();
+    if (finished) {
+        record->received_bytes = webkit_download_get_received_data_length(download);
+        record->state = DownloadRecord::State::FINISHED;
+        record->ended = std::chrono::steady_clock::now();
+        auto hash = download_hashes_.find(download);
+        record->sha256 = hash != download_hashes_.end() ? hash->second->finish(record->destination)
+                                                        : FileOps::Sha256::fileDigest(record->destination);
+        if (hash != download_hashes_.end() && hash->second->sinkFailed()) {
+            record->state = DownloadRecord::State::FAILED;
+            record->error = "stream sink closed";
+        }
+        debug_output("Download finished: " + record->destination + " (" + std::to_string(record->received_bytes) + " bytes)");
+    }
+    if (record->streamed && !record->destination.empty()) {
+        std::error_code ec;
+        std::filesystem::remove(record->destination + ".wkdownload", ec);
+        std::filesystem::remove(record->destination, ec);
+        std::filesystem::remove(std::filesystem::path(record->destination).parent_path(), ec); // only once empty
+        record->destination.clear();
+    }
+    DownloadRecord snapshot = *record;
+    
+    // WebKit is done with this download; stop listening and drop our reference
+    g_signal_handlers_disconnect_by_data(download, this);
+    download_index_.erase(download);
+    download_hashes_.erase(download);
+    g_object_unref(download);
+    
+    if (finished) {
+        emitDownloadEvent(snapshot.state == DownloadRecord::State::FINISHED ? BrowserEvents::EventType::DOWNLOAD_FINISHED
+                                                                          : BrowserEvents::EventType::DOWNLOAD_FAILED,
+                          snapshot);
+    }
+}
+
+// Subscribers may start or cancel downloads, so they get a copy of the record
+void Browser::emitDownloadEvent(BrowserEvents::EventType type, const DownloadRecord& record) {
+    if (event_bus_) {
+        event_bus_->emit(BrowserEvents::DownloadEvent(type, record));
+    }
+}
+
+void Browser::releaseDownloads() {
+    for (auto& entry : download_index_) {
+        g_signal_handlers_disconnect_by_data(entry.first, this);
+        g_object_unref(entry.first);
+    }
+    download_index_.clear();
+    download_hashes_.clear();
+}
+
+// ========== Waiting ==========
+
+bool Browser::waitForDownload(const std::function<bool(const DownloadRecord&)>& matches, int timeout_ms,
+                              DownloadRecord& result, const std::function<void(const DownloadRecord&)>& progress) {
+    bool timed_out = false;
+    guint timeout_id = g_timeout_add(timeout_ms, [](gpointer user_data) -> gboolean {
+        *static_cast<bool*>(user_data) = true;
+        return G_SOURCE_REMOVE;
+    }, &timed_out);
+    
+    bool found = false;
+    uint64_t reported_id = 0;
+    uint64_t reported_bytes = 0;
+    while (!timed_out) {
+        // Oldest unclaimed match first, so repeated waits walk through the downloads in order
+        DownloadRecord* candidate = nullptr;
+        for (auto& record : downloads_) {
+            if (!record.claimed && matches(record)) {
+                candidate = &record;
+                break;
+            }
+        }
+        
+        if (candidate) {
+            if (progress && (candidate->id != reported_id || candidate->received_bytes != reported_bytes)) {
+                reported_id = candidate->id;
+                reported_bytes = candidate->received_bytes;
+                progress(*candidate);
+            }
+            if (candidate->done()) {
+                candidate->claimed = true;
+                result = *candidate;
+                found = true;
+                break;
+            }
+        }
+        
+        g_main_context_iteration(g_main_context_default(), TRUE);
+    }
+    
+    if (!timed_out) {
+        g_source_remove(timeout_id);
+    }
+    return found;
+}
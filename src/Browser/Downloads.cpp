@@ -0,0 +1,44 @@
+#include "Downloads.h"
+#include <filesystem>
+
+std::string DownloadRecord::filename() const {
+    if (!destination.empty()) {
+        return std::filesystem::path(destination).filename().string();
+    }
+    return suggested_filename;
+}
+
+std::string sanitizeDownloadFilename(const std::string& suggested) {
+    std::string name;
+    for (char c : suggested) {
+        unsigned char byte = static_cast<unsigned char>(c);
+        name += (c == '/' || c == '\\' || byte < 0x20 || byte == 0x7f) ? '_' : c;
+    }
+    
+    // No hidden files and no trailing dots or spaces
+    while (!name.empty() && (name.back() == '.' || name.back() == ' ')) {
+        name.pop_back();
+    }
+    if (!name.empty() && name.front() == '.') {
+        name[0] = '_';
+    }
+    return name.empty() ? "download" : name;
+}
+
+std::string uniqueDownloadPath(const std::string& directory, const std::string& filename,
+                               const std::set<std::string>& reserved) {
+    std::filesystem::path dir(directory);
+    std::filesystem::path candidate = dir / filename;
+    
+    auto taken = [&](const std::filesystem::path& path) {
+        std::error_code ec;
+        return reserved.count(path.string()) > 0 || std::filesystem::exists(path, ec);
+    };
+    
+    std::string stem = std::filesystem::path(filename).stem().string();
+    std::string extension = std::filesystem::path(filename).extension().string();
+    for (int n = 1; taken(candidate); ++n) {
+        candidate = dir / (stem + " (" + std::to_string(n) + ")" + extension);
+    }
+    return candidate.string();
+}
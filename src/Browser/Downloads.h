@@ -0,0 +1,42 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <set>
+#include <string>
+
+// One download started by the web view, as reported by WebKitDownload signals
+struct DownloadRecord {
+    enum class State {
+        IN_PROGRESS,
+        FINISHED,
+        FAILED,
+        CANCELLED
+    };
+
+    uint64_t id = 0;
+    std::string uri;
+    std::string suggested_filename;
+    std::string destination;        // path chosen in decide-destination
+    uint64_t received_bytes = 0;
+    uint64_t expected_bytes = 0;    // 0 when the response has no Content-Length
+    State state = State::IN_PROGRESS;
+    std::string error;
+    std::string sha256;             // hex digest of the file once FINISHED
+    bool claimed = false;           // already returned by a wait
+    bool streamed = false;          // bytes went to a sink; no file is kept
+    std::chrono::steady_clock::time_point started;
+    std::chrono::steady_clock::time_point ended;
+
+    bool done() const { return state != State::IN_PROGRESS; }
+    std::string filename() const;   // last path component of destination, else the suggestion
+};
+
+// File name that is safe to create inside a download directory: path
+// separators and control characters replaced, never empty, "." or ".."
+std::string sanitizeDownloadFilename(const std::string& suggested);
+
+// directory/filename, or "name (1).ext", "name (2).ext", ... if that file
+// exists or is already the destination of another download
+std::string uniqueDownloadPath(const std::string& directory, const std::string& filename,
+                               const std::set<std::string>& reserved = {});
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+// Reference to an element held in the page runtime's handle table.
+// Operations on a handle address the element directly instead of
+// re-running the selector. A handle becomes invalid when the browser
+// starts loading another document.
+class ElementHandle {
+public:
+    using Generation = std::shared_ptr<const std::atomic<uint64_t>>;
+
+    ElementHandle() = default;
+
+    ElementHandle(const std::string& id, const std::string& selector, Generation live_generation)
+        : id_(id), selector_(selector),
+          generation_(live_generation ? live_generation->load() : 0),
+          live_generation_(std::move(live_generation)) {}
+
+    // Non-empty and still pointing into the current document
+    bool valid() const {
+        return !id_.empty() && live_generation_ && live_generation_->load() == generation_;
+    }
+    explicit operator bool() const { return valid(); }
+
+    const std::string& id() const { return id_; }
+    const std::string& selector() const { return selector_; }
+
+    // Form accepted by window.__hweb methods in place of a selector
+    std::string ref() const { return REF_PREFIX + id_; }
+
+    static constexpr const char* REF_PREFIX = "@hweb:";
+
+private:
+    std::string id_;
+    std::string selector_;
+    uint64_t generation_ = 0;
+    Generation live_generation_;
+};
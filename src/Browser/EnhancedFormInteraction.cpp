@@ -13,7 +13,13 @@ bool Browser::fillInputEnhanced(const std::string& selector, const std::string&
         return false;
     }
     
-    // Step 2: Escape the value and selector for JavaScript
+    // Step 2: Trusted editing input works with framework-controlled fields directly
+    if (typeTrusted(selector, value)) {
+        debug_output("Enhanced fill: trusted input succeeded");
+        return true;
+    }
+    
+    // Step 3: Escape the value and selector for JavaScript
     std::string escaped_value = value;
     std::string escaped_selector = selector;
     
@@ -42,7 +48,7 @@ bool Browser::fillInputEnhanced(const std::string& selector, const std::string&
     escape_for_js(escaped_value);
     escape_for_js(escaped_selector);
     
-    // Step 3: Advanced form interaction script for modern frameworks
+    // Step 4: Advanced form interaction script for modern frameworks
     std::string enhanced_js = 
         "(function() { "
         "  try { "
@@ -97,7 +103,7 @@ bool Browser::fillInputEnhanced(const std::string& selector, const std::string&
     std::string result = executeJavascriptSync(enhanced_js);
     debug_output("Enhanced fill result: " + result);
     
-    // Step 4: Verification with retry mechanism
+    // Step 5: Verification with retry mechanism
     if (result == "ENHANCED_FILL_SUCCESS") {
         // Allow time for JavaScript frameworks to process
         std::this_thread::sleep_for(std::chrono::milliseconds(100));
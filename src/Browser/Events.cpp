@@ -215,6 +215,90 @@ void ready_to_show_handler(WebKitWebView* webview, gpointer user_data) {
     browser->checkSignalConditions();
 }
 
+// Script message from the in-page paint-settled probe (window.webkit.messageHandlers.hwebPaint)
+void paint_settled_message_handler(WebKitUserContentManager* manager, JSCValue* value, gpointer user_data) {
+    if (!value || !user_data) {
+        return;
+    }
+    
+    Browser* browser = static_cast<Browser*>(user_data);
+    if (!browser || !browser->isObjectValid()) {
+        return;
+    }
+    
+    std::string payload;
+    if (jsc_value_is_string(value)) {
+        gchar* str = jsc_value_to_string(value);
+        if (str) {
+            payload = str;
+            g_free(str);
+        }
+    }
+    
+    browser->notifyPaintSettled(payload);
+}
+
+// Script message carrying one slice of a streamed result (window.webkit.messageHandlers.hwebChunk)
+void chunk_message_handler(WebKitUserContentManager* manager, JSCValue* value, gpointer user_data) {
+    if (!value || !user_data) {
+        return;
+    }
+    
+    Browser* browser = static_cast<Browser*>(user_data);
+    if (!browser || !browser->isObjectValid() || !jsc_value_is_string(value)) {
+        return;
+    }
+    
+    // Byte length, not strlen: the payload may carry embedded NULs
+    GBytes* bytes = jsc_value_to_string_as_bytes(value);
+    if (bytes) {
+        gsize length = 0;
+        const char* data = static_cast<const char*>(g_bytes_get_data(bytes, &length));
+        browser->notifyChunkMessage(data ? data : "", length);
+        g_bytes_unref(bytes);
+    }
+}
+
+// Script message carrying one batch of DOM mirror changes (window.webkit.messageHandlers.hwebMutation)
+void dom_diff_message_handler(WebKitUserContentManager* manager, JSCValue* value, gpointer user_data) {
+    if (!value || !user_data) {
+        return;
+    }
+    
+    Browser* browser = static_cast<Browser*>(user_data);
+    if (!browser || !browser->isObjectValid() || !jsc_value_is_string(value)) {
+        return;
+    }
+    
+    GBytes* bytes = jsc_value_to_string_as_bytes(value);
+    if (bytes) {
+        gsize length = 0;
+        const char* data = static_cast<const char*>(g_bytes_get_data(bytes, &length));
+        browser->notifyDomDiff(data ? data : "", length);
+        g_bytes_unref(bytes);
+    }
+}
+
+// Script message reporting a file-carrying request of the page (window.webkit.messageHandlers.hwebUpload)
+void upload_message_handler(WebKitUserContentManager* manager, JSCValue* value, gpointer user_data) {
+    if (!value || !user_data) {
+        return;
+    }
+    
+    Browser* browser = static_cast<Browser*>(user_data);
+    if (!browser || !browser->isObjectValid() || !jsc_value_is_string(value)) {
+        return;
+    }
+    
+    GBytes* bytes = jsc_value_to_string_as_bytes(value);
+    if (bytes) {
+        gsize length = 0;
+        const char* data = static_cast<const char*>(g_bytes_get_data(bytes, &length));
+        browser->notifyUploadMessage(data ? data : "", length);
+        g_bytes_unref(bytes);
+    }
+}
+
 // Callback for load-changed signal
 void load_changed_callback(WebKitWebView* web_view, WebKitLoadEvent load_event, gpointer user_data) {
     
@@ -223,6 +307,9 @@ void load_changed_callback(WebKitWebView* web_view, WebKitLoadEvent load_event,
 
 // ========== Setup and Cleanup Methods ==========
 
+// Defined in DownloadTracking.cpp
+void download_started_handler(WebKitNetworkSession* session, WebKitDownload* download, gpointer user_data);
+
 void Browser::setupSignalHandlers() {
     std::lock_guard<std::mutex> lock(signal_mutex);
     
@@ -252,6 +339,42 @@ void Browser::setupSignalHandlers() {
                                       G_CALLBACK(ready_to_show_handler), this);
     connected_signal_ids.push_back(ready_id);
     
+    // Paint-settled probe reports back through a script message handler
+    WebKitUserContentManager* content_manager = webkit_web_view_get_user_content_manager(webView);
+    if (content_manager &&
+        webkit_user_content_manager_register_script_message_handler(content_manager, "hwebPaint", NULL)) {
+        paint_message_signal_id = g_signal_connect(content_manager, "script-message-received::hwebPaint",
+                                                   G_CALLBACK(paint_settled_message_handler), this);
+    }
+    
+    // Large results (page source, element HTML) arrive as slices on their own handler
+    if (content_manager &&
+        webkit_user_content_manager_register_script_message_handler(content_manager, "hwebChunk", NULL)) {
+        chunk_message_signal_id = g_signal_connect(content_manager, "script-message-received::hwebChunk",
+                                                   G_CALLBACK(chunk_message_handler), this);
+    }
+    
+    // DOM mirror diffs, pushed by the page whenever the observed document changes
+    if (content_manager &&
+        webkit_user_content_manager_register_script_message_handler(content_manager, "hwebMutation", NULL)) {
+        mutation_message_signal_id = g_signal_connect(content_manager, "script-message-received::hwebMutation",
+                                                      G_CALLBACK(dom_diff_message_handler), this);
+    }
+    
+    // Upload progress of file-carrying requests, pushed by the page runtime
+    if (content_manager &&
+        webkit_user_content_manager_register_script_message_handler(content_manager, "hwebUpload", NULL)) {
+        upload_message_signal_id = g_signal_connect(content_manager, "script-message-received::hwebUpload",
+                                                    G_CALLBACK(upload_message_handler), this);
+    }
+    
+    // Downloads are announced on the network session, which other views may share
+    WebKitNetworkSession* session = webkit_web_view_get_network_session(webView);
+    if (session) {
+        download_started_signal_id = g_signal_connect(session, "download-started",
+                                                      G_CALLBACK(download_started_handler), this);
+    }
+    
     debug_output("Connected " + std::to_string(connected_signal_ids.size()) + " signal handlers");
 }
 
@@ -270,6 +393,48 @@ void Browser::disconnectSignalHandlers() {
     }
     
     connected_signal_ids.clear();
+    
+    WebKitUserContentManager* content_manager = webkit_web_view_get_user_content_manager(webView);
+    if (content_manager && paint_message_signal_id != 0) {
+        if (g_signal_handler_is_connected(content_manager, paint_message_signal_id)) {
+            g_signal_handler_disconnect(content_manager, paint_message_signal_id);
+        }
+        webkit_user_content_manager_unregister_script_message_handler(content_manager, "hwebPaint", NULL);
+    }
+    paint_message_signal_id = 0;
+    
+    if (content_manager && chunk_message_signal_id != 0) {
+        if (g_signal_handler_is_connected(content_manager, chunk_message_signal_id)) {
+            g_signal_handler_disconnect(content_manager, chunk_message_signal_id);
+        }
+        webkit_user_content_manager_unregister_script_message_handler(content_manager, "hwebChunk", NULL);
+    }
+    chunk_message_signal_id = 0;
+    
+    if (content_manager && mutation_message_signal_id != 0) {
+        if (g_signal_handler_is_connected(content_manager, mutation_message_signal_id)) {
+            g_signal_handler_disconnect(content_manager, mutation_message_signal_id);
+        }
+        webkit_user_content_manager_unregister_script_message_handler(content_manager, "hwebMutation", NULL);
+    }
+    mutation_message_signal_id = 0;
+    
+    if (content_manager && upload_message_signal_id != 0) {
+        if (g_signal_handler_is_connected(content_manager, upload_message_signal_id)) {
+            g_signal_handler_disconnect(content_manager, upload_message_signal_id);
+        }
+        webkit_user_content_manager_unregister_script_message_handler(content_manager, "hwebUpload", NULL);
+    }
+    upload_message_signal_id = 0;
+    
+    WebKitNetworkSession* session = webkit_web_view_get_network_session(webView);
+    if (session && download_started_signal_id != 0) {
+        if (g_signal_handler_is_connected(session, download_started_signal_id)) {
+            g_signal_handler_disconnect(session, download_started_signal_id);
+        }
+    }
+    download_started_signal_id = 0;
+    releaseDownloads();
 }
 
 void Browser::cleanupWaiters() {
@@ -896,6 +1061,63 @@ bool Browser::waitForConditionEvent(const std::string& js_condition, int timeout
     return waitForSignalCondition("load-changed", js_condition, timeout_ms);
 }
 
+void Browser::notifyPaintSettled(const std::string& payload) {
+    if (!is_valid.load()) {
+        return;
+    }
+    
+    // Ignore late reports from a probe whose wait already timed out
+    if (pending_paint_token_.empty() ||
+        payload.find("\"token\":\"" + pending_paint_token_ + "\"") == std::string::npos) {
+        return;
+    }
+    
+    debug_output("Paint settled: " + payload);
+    paint_settled_ = true;
+    pending_paint_token_.clear();
+    
+    if (async_nav_) {
+        async_nav_->emitRenderingComplete();
+    }
+}
+
+bool Browser::waitForPaintSettled(int timeout_ms, int quiet_ms) {
+    if (!async_nav_ || paint_message_signal_id == 0) {
+        return false;
+    }
+    
+    paint_settled_ = false;
+    pending_paint_token_ = newTransferToken();
+    
+    // Arm the in-page probe; it posts back once fonts, images, layout shifts
+    // and a double requestAnimationFrame tick have all settled. Stuck resources
+    // get half the budget, so the quiet period and frame ticks that follow can
+    // still report before the outer deadline.
+    int resource_wait_ms = timeout_ms / 2;
+    executeJavascriptSync(async_nav_->generatePaintSettledScript(pending_paint_token_, quiet_ms, resource_wait_ms));
+    
+    // Block on the GLib main context (no polling sleeps) until the message or the deadline
+    bool timed_out = false;
+    guint timeout_id = g_timeout_add(timeout_ms, [](gpointer user_data) -> gboolean {
+        *static_cast<bool*>(user_data) = true;
+        return G_SOURCE_REMOVE;
+    }, &timed_out);
+    
+    while (!paint_settled_ && !timed_out) {
+        g_main_context_iteration(NULL, TRUE);
+    }
+    
+    if (!timed_out) {
+        g_source_remove(timeout_id);
+    }
+    
+    if (!paint_settled_) {
+        debug_output("Paint-settled probe timed out after " + std::to_string(timeout_ms) + "ms");
+        pending_paint_token_.clear();
+    }
+    return paint_settled_;
+}
+
 bool Browser::waitForPageReadyEvent(int timeout_ms) {
     // CRITICAL REPLACEMENT: Use event-driven readiness detection instead of blocking wait(3000)
     
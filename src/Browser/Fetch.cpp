@@ -0,0 +1,152 @@
+#include "Fetch.h"
+#include <algorithm>
+#include <cctype>
+#include <set>
+#include <tuple>
+
+namespace {
+
+std::string lowercase(std::string text) {
+    std::transform(text.begin(), text.end(), text.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return text;
+}
+
+// RFC 6265 section 5.1.3
+bool domainMatches(const std::string& host, std::string domain) {
+    if (domain.empty()) {
+        return false; // no host to scope it to, so never sent anywhere
+    }
+    domain = lowercase(domain[0] == '.' ? domain.substr(1) : domain);
+    if (host == domain) {
+        return true;
+    }
+    return host.size() > domain.size() &&
+           host.compare(host.size() - domain.size(), domain.size(), domain) == 0 &&
+           host[host.size() - domain.size() - 1] == '.';
+}
+
+// RFC 6265 section 5.1.4
+bool pathMatches(const std::string& request_path, const std::string& cookie_path) {
+    if (cookie_path.empty() || cookie_path == request_path) {
+        return true;
+    }
+    if (request_path.compare(0, cookie_path.size(), cookie_path) != 0) {
+        return false;
+    }
+    return cookie_path.back() == '/' || request_path[cookie_path.size()] == '/';
+}
+
+// scheme://host[:port] of an http(s) URL, lowercased, without userinfo or
+// a default port; "" for anything else
+std::string originOf(const std::string& url) {
+    size_t scheme_end = url.find("://");
+    if (scheme_end == std::string::npos) {
+        return "";
+    }
+    std::string scheme = lowercase(url.substr(0, scheme_end));
+    if (scheme != "http" && scheme != "https") {
+        return "";
+    }
+    size_t authority_start = scheme_end + 3;
+    size_t authority_end = url.find_first_of("/?#", authority_start);
+    std::string authority = url.substr(authority_start, authority_end == std::string::npos ? std::string::npos
+                                                                                           : authority_end - authority_start);
+    size_t at = authority.rfind('@');
+    if (at != std::string::npos) {
+        authority = authority.substr(at + 1);
+    }
+    authority = lowercase(authority);
+    std::string default_port = scheme == "https" ? ":443" : ":80";
+    if (authority.size() > default_port.size() &&
+        authority.compare(authority.size() - default_port.size(), default_port.size(), default_port) == 0) {
+        authority.erase(authority.size() - default_port.size());
+    }
+    if (authority.empty()) {
+        return "";
+    }
+    return scheme + "://" + authority;
+}
+
+} // namespace
+
+std::string refererFor(const std::string& page_url, const std::string& target_url) {
+    std::string page_origin = originOf(page_url);
+    std::string target_origin = originOf(target_url);
+    if (page_origin.empty() || target_origin.empty()) {
+        return "";
+    }
+    if (page_origin.compare(0, 8, "https://") == 0 && target_origin.compare(0, 7, "http://") == 0) {
+        return "";
+    }
+    if (page_origin != target_origin) {
+        return page_origin + "/";
+    }
+    // Same origin: the full URL, minus any credentials and fragment
+    std::string referer = page_url.substr(0, page_url.find('#'));
+    size_t authority_start = referer.find("://") + 3;
+    size_t authority_end = referer.find_first_of("/?", authority_start);
+    size_t at = referer.rfind('@', authority_end == std::string::npos ? std::string::npos : authority_end);
+    if (at != std::string::npos && at >= authority_start) {
+        referer.erase(authority_start, at + 1 - authority_start);
+    }
+    return referer;
+}
+
+std::string cookieHeaderFor(const std::vector<Cookie>& cookies, const std::string& url, int64_t now) {
+    size_t scheme_end = url.find("://");
+    if (scheme_end == std::string::npos) {
+        return "";
+    }
+    std::string scheme = lowercase(url.substr(0, scheme_end));
+    size_t authority_start = scheme_end + 3;
+    size_t authority_end = url.find_first_of("/?#", authority_start);
+    std::string authority = url.substr(authority_start, authority_end == std::string::npos ? std::string::npos
+                                                                                           : authority_end - authority_start);
+    size_t at = authority.rfind('@');
+    if (at != std::string::npos) {
+        authority = authority.substr(at + 1);
+    }
+    // Drop the port, but not the colons of a bracketed IPv6 literal
+    size_t colon = authority.rfind(':');
+    if (colon != std::string::npos && authority.find(']', colon) == std::string::npos) {
+        authority = authority.substr(0, colon);
+    }
+    std::string host = lowercase(authority);
+
+    std::string path = "/";
+    if (authority_end != std::string::npos && url[authority_end] == '/') {
+        size_t path_end = url.find_first_of("?#", authority_end);
+        path = url.substr(authority_end, path_end == std::string::npos ? std::string::npos : path_end - authority_end);
+    }
+    bool secure_channel = scheme == "https" || scheme == "wss";
+
+    std::vector<const Cookie*> matching;
+    // A cookie is identified by name, domain and path (RFC 6265 section
+    // 5.3); same-named cookies scoped elsewhere are distinct and all sent
+    std::set<std::tuple<std::string, std::string, std::string>> seen;
+    for (const auto& cookie : cookies) {
+        if (cookie.name.empty() || (cookie.secure && !secure_channel) ||
+            (cookie.expires > 0 && cookie.expires <= now) ||
+            !domainMatches(host, cookie.domain) || !pathMatches(path, cookie.path)) {
+            continue;
+        }
+        std::string domain = lowercase(cookie.domain[0] == '.' ? cookie.domain.substr(1) : cookie.domain);
+        if (seen.emplace(cookie.name, domain, cookie.path.empty() ? "/" : cookie.path).second) {
+            matching.push_back(&cookie);
+        }
+    }
+
+    std::stable_sort(matching.begin(), matching.end(), [](const Cookie* a, const Cookie* b) {
+        return a->path.size() > b->path.size();
+    });
+
+    std::string header;
+    for (const Cookie* cookie : matching) {
+        if (!header.empty()) {
+            header += "; ";
+        }
+        header += cookie->name + "=" + cookie->value;
+    }
+    return header;
+}
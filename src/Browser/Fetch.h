@@ -0,0 +1,33 @@
+#pragma once
+
+#include "../Session/Session.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Outcome of one direct HTTP request made outside the web view
+struct FetchResponse {
+    unsigned status = 0;            // HTTP status, 0 if no response arrived
+    std::string reason;
+    std::string content_type;
+    uint64_t content_length = 0;    // 0 when the response has no Content-Length
+    uint64_t received_bytes = 0;    // body bytes handed to the sink
+    std::string sha256;             // hex digest of the body once complete
+    std::vector<Cookie> set_cookies;
+    std::string error;              // transport error, "" if the exchange completed
+
+    bool ok() const { return error.empty() && status >= 200 && status < 300; }
+};
+
+// Cookie header value a browser would send to url: cookies whose domain,
+// path and secure flag match and that have not expired at now (Unix
+// seconds), longest path first. Cookies without a domain are never sent.
+// Of cookies sharing a name, domain and path the first wins, so list the
+// more authoritative source first. "" if none match.
+std::string cookieHeaderFor(const std::vector<Cookie>& cookies, const std::string& url, int64_t now);
+
+// Referer a browser would send from page_url to target_url under the
+// strict-origin-when-cross-origin policy: the full URL (without credentials
+// or fragment) to the same origin, only the origin across origins, and
+// nothing from https to http or when either URL is not http(s).
+std::string refererFor(const std::string& page_url, const std::string& target_url);
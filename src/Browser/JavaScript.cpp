@@ -12,6 +12,7 @@
 #include <atomic>
 #include <mutex>
 #include <ctime>
+#include <cstring>
 
 // External debug flag
 extern bool g_debug;
@@ -25,6 +26,34 @@ struct JavaScriptCallbackData {
     JavaScriptCallbackData() : result_ptr(std::make_shared<std::string>()), completed(false) {}
 };
 
+// Convert a JavaScript result to the string form returned by executeJavascriptSync()
+static std::string result_from_jsc_value(JSCValue* value) {
+    if (jsc_value_is_number(value)) {
+        double num_val = jsc_value_to_double(value);
+        if (num_val == floor(num_val)) {
+            return std::to_string((long long)num_val);
+        }
+        return std::to_string(num_val);
+    } else if (jsc_value_is_boolean(value)) {
+        return jsc_value_to_boolean(value) ? "true" : "false";
+    } else if (jsc_value_is_null(value)) {
+        return "null";
+    } else if (jsc_value_is_undefined(value)) {
+        return "undefined";
+    }
+    
+    // Strings, objects and anything else: use the JavaScript string conversion
+    std::string result;
+    char* str_value = jsc_value_to_string(value);
+    if (str_value) {
+        result = str_value;
+        g_free(str_value);
+    } else if (jsc_value_is_object(value)) {
+        result = "[object Object]";
+    }
+    return result;
+}
+
 // Callback for JavaScript evaluation
 void js_eval_callback(GObject* object, GAsyncResult* res, gpointer user_data) {
     // CRITICAL SAFETY: Validate all pointers before any operations
@@ -102,46 +131,7 @@ void js_eval_callback(GObject* object, GAsyncResult* res, gpointer user_data) {
         // DEBUG: Log when we have a valid value
         debug_output("JavaScript callback: Valid value received");
         try {
-            if (jsc_value_is_string(value)) {
-                char* str_value = jsc_value_to_string(value);
-                if (str_value) {
-                    *(callback_data->result_ptr) = str_value;
-                    g_free(str_value);
-                } else {
-                    *(callback_data->result_ptr) = "";
-                }
-            } else if (jsc_value_is_number(value)) {
-                double num_val = jsc_value_to_double(value);
-                if (num_val == floor(num_val)) {
-                    *(callback_data->result_ptr) = std::to_string((long long)num_val);
-                } else {
-                    *(callback_data->result_ptr) = std::to_string(num_val);
-                }
-            } else if (jsc_value_is_boolean(value)) {
-                *(callback_data->result_ptr) = jsc_value_to_boolean(value) ? "true" : "false";
-            } else if (jsc_value_is_null(value)) {
-                *(callback_data->result_ptr) = "null";
-            } else if (jsc_value_is_undefined(value)) {
-                *(callback_data->result_ptr) = "undefined";
-            } else if (jsc_value_is_object(value)) {
-                // Try to convert object to string
-                char* str_value = jsc_value_to_string(value);
-                if (str_value) {
-                    *(callback_data->result_ptr) = str_value;
-                    g_free(str_value);
-                } else {
-                    *(callback_data->result_ptr) = "[object Object]";
-                }
-            } else {
-                // Fallback: try to convert to string
-                char* str_value = jsc_value_to_string(value);
-                if (str_value) {
-                    *(callback_data->result_ptr) = str_value;
-                    g_free(str_value);
-                } else {
-                    *(callback_data->result_ptr) = "";
-                }
-            }
+            *(callback_data->result_ptr) = result_from_jsc_value(value);
         } catch (const std::exception& e) {
             std::cerr << "Error processing JavaScript result: " << e.what() << std::endl;
             *(callback_data->result_ptr) = "";
@@ -162,6 +152,32 @@ void js_eval_callback(GObject* object, GAsyncResult* res, gpointer user_data) {
     }
 }
 
+// Callback for helper runtime calls; owns a reference to the callback data so a
+// call that completes after its caller timed out never touches freed memory
+static void js_call_callback(GObject* object, GAsyncResult* res, gpointer user_data) {
+    auto* holder = static_cast<std::shared_ptr<JavaScriptCallbackData>*>(user_data);
+    std::shared_ptr<JavaScriptCallbackData> callback_data = *holder;
+    delete holder;
+    
+    std::lock_guard<std::mutex> lock(callback_data->completion_mutex);
+    
+    GError* error = NULL;
+    JSCValue* value = webkit_web_view_call_async_javascript_function_finish(WEBKIT_WEB_VIEW(object), res, &error);
+    
+    if (error) {
+        debug_output(std::string("Page runtime call failed: ") + error->message);
+        g_error_free(error);
+        *(callback_data->result_ptr) = "";
+    } else if (value) {
+        *(callback_data->result_ptr) = result_from_jsc_value(value);
+        g_object_unref(value);
+    } else {
+        *(callback_data->result_ptr) = "";
+    }
+    
+    callback_data->completed.store(true);
+}
+
 // ========== JavaScript Execution Methods ==========
 
 void Browser::executeJavascript(const std::string& script, std::string* result) {
@@ -326,3 +342,228 @@ std::string Browser::executeJavascriptSyncSafe(const std::string& script) {
         return "";
     }
 }
+
+// ========== Helper Runtime ==========
+
+void Browser::installPageRuntime() {
+    WebKitUserContentManager* content_manager = webkit_web_view_get_user_content_manager(webView);
+    if (!content_manager) {
+        return;
+    }
+    
+    // Injected into every document before page scripts run, so each page
+    // parses the runtime once instead of once per DOM call
+    WebKitUserScript* script = webkit_user_script_new(
+        PageRuntime::source().c_str(),
+        WEBKIT_USER_CONTENT_INJECT_TOP_FRAME,
+        WEBKIT_USER_SCRIPT_INJECT_AT_DOCUMENT_START,
+        NULL,   // allow list
+        NULL);  // block list
+    webkit_user_content_manager_add_script(content_manager, script);
+    webkit_user_script_unref(script);
+}
+
+std::string Browser::callPageRuntime(const std::string& method, const std::vector<std::string>& args, int timeout_ms) {
+    bool reached = false;
+    return callPageRuntime(method, args, timeout_ms, reached);
+}
+
+std::string Browser::callPageRuntime(const std::string& method, const std::vector<std::string>& args, int timeout_ms,
+                                     bool& reached) {
+    reached = false;
+    if (!webView) {
+        return "";
+    }
+    
+    const gchar* uri = webkit_web_view_get_uri(webView);
+    if (!uri || strlen(uri) == 0) {
+        debug_output("No URI loaded, skipping page runtime call: " + method);
+        return "";
+    }
+    
+    std::string body = PageRuntime::callBody(method, args.size());
+    
+    for (int attempt = 0; attempt < 2; ++attempt) {
+        // Arguments travel as typed GVariant strings and are bound to a0..aN
+        GVariantBuilder builder;
+        g_variant_builder_init(&builder, G_VARIANT_TYPE("a{sv}"));
+        for (size_t i = 0; i < args.size(); ++i) {
+            std::string name = PageRuntime::argName(i);
+            gchar* text = g_utf8_make_valid(args[i].c_str(), args[i].size());
+            g_variant_builder_add(&builder, "{sv}", name.c_str(), g_variant_new_string(text));
+            g_free(text);
+        }
+        
+        auto callback_data = std::make_shared<JavaScriptCallbackData>();
+        webkit_web_view_call_async_javascript_function(
+            webView,
+            body.c_str(),
+            -1,
+            g_variant_builder_end(&builder),
+            NULL,   // world name (main world, so page framework state is visible)
+            NULL,   // source URI
+            NULL,   // cancellable
+            js_call_callback,
+            new std::shared_ptr<JavaScriptCallbackData>(callback_data)
+        );
+        
+        // Block on the main context until the reply or the deadline
+        bool timed_out = false;
+        guint timeout_id = g_timeout_add(timeout_ms, [](gpointer user_data) -> gboolean {
+            *static_cast<bool*>(user_data) = true;
+            return G_SOURCE_REMOVE;
+        }, &timed_out);
+        
+        while (!callback_data->completed.load() && !timed_out) {
+            g_main_context_iteration(g_main_context_default(), TRUE);
+        }
+        
+        if (!timed_out) {
+            g_source_remove(timeout_id);
+        }
+        
+        if (!callback_data->completed.load()) {
+            debug_output("Page runtime call timeout: " + method);
+            reached = true;
+            return "";
+        }
+        
+        std::string result;
+        {
+            std::lock_guard<std::mutex> lock(callback_data->completion_mutex);
+            result = *(callback_data->result_ptr);
+        }
+        
+        if (result == PageRuntime::MISSING_MARKER && attempt == 0) {
+            // Document predates the user script; install the runtime in place and retry
+            debug_output("Installing page runtime into current document");
+            executeJavascriptSync(PageRuntime::source());
+            continue;
+        }
+        
+        reached = result != PageRuntime::MISSING_MARKER;
+        if (result == "undefined" || result == "null" || !reached) {
+            return "";
+        }
+        
+        // Same result cap as executeJavascriptSync()
+        if (result.length() > 100000) {
+            return result.substr(0, 100000);
+        }
+        return result;
+    }
+    
+    return "";
+}
+
+// ========== Chunked Result Transfer ==========
+
+std::string Browser::newTransferToken() {
+    gchar* uuid = g_uuid_string_random();
+    std::string token = uuid;
+    g_free(uuid);
+    return token;
+}
+
+void Browser::notifyChunkMessage(const char* payload, size_t length) {
+    if (!is_valid.load() || active_stream_id_.empty()) {
+        return;
+    }
+    
+    // "<id>:<last>:<data>"
+    const char* id_end = static_cast<const char*>(memchr(payload, ':', length));
+    size_t id_length = id_end ? static_cast<size_t>(id_end - payload) : 0;
+    if (!id_end || length < id_length + 3 || id_end[2] != ':') {
+        return;
+    }
+    
+    // Ignore late slices from a transfer that already timed out
+    if (active_stream_id_.compare(0, std::string::npos, payload, id_length) != 0) {
+        return;
+    }
+    
+    if (active_stream_sink_) {
+        active_stream_sink_(id_end + 3, length - id_length - 3);
+    }
+    if (id_end[1] == '1') {
+        active_stream_done_ = true;
+    }
+}
+
+bool Browser::streamPageRuntime(const std::string& method, const std::vector<std::string>& args,
+                                const ChunkSink& sink, int timeout_ms) {
+    if (chunk_message_signal_id == 0 || !active_stream_id_.empty()) {
+        return false;
+    }
+    
+    active_stream_id_ = newTransferToken();
+    active_stream_sink_ = sink;
+    active_stream_done_ = false;
+    
+    std::vector<std::string> stream_args = {active_stream_id_, method};
+    stream_args.insert(stream_args.end(), args.begin(), args.end());
+    std::string result = callPageRuntime("stream", stream_args, timeout_ms);
+    
+    bool ok = result.rfind("STREAM:", 0) == 0;
+    if (ok && !active_stream_done_) {
+        // Slices can still be queued behind the call's reply
+        bool timed_out = false;
+        guint timeout_id = g_timeout_add(timeout_ms, [](gpointer user_data) -> gboolean {
+            *static_cast<bool*>(user_data) = true;
+            return G_SOURCE_REMOVE;
+        }, &timed_out);
+        
+        while (!active_stream_done_ && !timed_out) {
+            g_main_context_iteration(g_main_context_default(), TRUE);
+        }
+        
+        if (!timed_out) {
+            g_source_remove(timeout_id);
+        }
+        ok = active_stream_done_;
+    }
+    
+    if (!ok) {
+        debug_output("Chunked transfer failed for " + method + ": " + (result.empty() ? "timeout" : result));
+    }
+    
+    active_stream_id_.clear();
+    active_stream_sink_ = nullptr;
+    return ok;
+}
+
+bool Browser::streamPageSource(const ChunkSink& sink) {
+    return streamPageRuntime("pageSource", {}, sink);
+}
+
+bool Browser::streamElementHtml(const std::string& selector, const ChunkSink& sink) {
+    return streamPageRuntime("html", {selector}, sink);
+}
+
+bool Browser::streamReadableContent(bool markdown, const ChunkSink& sink) {
+    return streamPageRuntime("readable", {markdown ? "markdown" : "text"}, sink);
+}
+
+// ========== DOM Mirror ==========
+
+bool Browser::snapshotDom(const ChunkSink& sink) {
+    if (mutation_message_signal_id == 0) {
+        debug_output("snapshotDom: hwebMutation handler not registered");
+        return false;
+    }
+    return streamPageRuntime("domSnapshot", {}, sink);
+}
+
+void Browser::stopDomDiffs() {
+    callPageRuntime("domUnwatch", {});
+}
+
+void Browser::notifyDomDiff(const char* payload, size_t length) {
+    if (!is_valid.load() || !event_bus_) {
+        return;
+    }
+    
+    BrowserEvents::DOMEvent event(BrowserEvents::EventType::DOM_MUTATION, "dom-diff", "diff");
+    event.data.assign(payload, length);
+    event_bus_->emit(event);
+}
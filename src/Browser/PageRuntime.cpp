@@ -0,0 +1,1021 @@
+#include "PageRuntime.h"
+
+namespace PageRuntime {
+
+const std::string& source() {
+    // Return values keep the string protocol the DOM methods already check for
+    static const std::string runtime = R"JS((function() {
+  if (window.__hweb) return;
+
+  // Element handle table: id -> WeakRef, so handles never keep nodes alive
+  var HANDLE_PREFIX = '@hweb:';
+  var handles = new Map();
+  var handleIds = new WeakMap();
+  var nextHandle = 1;
+  var registry = typeof FinalizationRegistry === 'function'
+    ? new FinalizationRegistry(function(id) { handles.delete(id); }) : null;
+
+  function deref(id) {
+    var ref = handles.get(id);
+    var el = ref ? (ref.deref ? ref.deref() : ref) : null;
+    if (el && !el.isConnected) el = null;
+    if (!el) handles.delete(id);
+    return el || null;
+  }
+
+  // Per-document lookup cache. Invalid selectors are remembered for good;
+  // read-only lookups also keep their last match (or count) for as long as
+  // the DOM generation, bumped by a MutationObserver, stays the same.
+  var lookups = new Map();
+  var LOOKUP_LIMIT = 512;
+  var domGeneration = 0;
+  var domObserver = null;
+  // State pseudo-classes (:checked, :focus, ...) change without any mutation
+  var VOLATILE_SELECTOR = /:(?!(?:nth-|first-|last-|only-|not\(|is\(|where\(|has\(|root|empty|scope))/;
+
+  // Returns false when mutations cannot be observed and nothing may be reused
+  function syncGeneration() {
+    if (!domObserver) {
+      if (typeof MutationObserver !== 'function') return false;
+      domObserver = new MutationObserver(function() { domGeneration++; });
+      domObserver.observe(document, { childList: true, subtree: true, attributes: true });
+    }
+    // Mutations made earlier in this task have not been delivered yet
+    if (domObserver.takeRecords().length > 0) domGeneration++;
+    return true;
+  }
+
+  function lookupEntry(selector) {
+    var entry = lookups.get(selector);
+    if (!entry) {
+      if (lookups.size >= LOOKUP_LIMIT) lookups.clear();
+      entry = { error: null, generation: -1, node: undefined, count: undefined,
+                volatile: VOLATILE_SELECTOR.test(selector) };
+      lookups.set(selector, entry);
+    }
+    if (entry.error) throw entry.error;
+    return entry;
+  }
+
+  function run(entry, query) {
+    try { return query(); }
+    catch (e) {
+      if (e && e.name === 'SyntaxError') entry.error = e;
+      throw e;
+    }
+  }
+
+  function isHandle(selector) { return selector.lastIndexOf(HANDLE_PREFIX, 0) === 0; }
+
+  // Selectors may also be handle references ("@hweb:<id>"), which are never valid CSS
+  function q(selector) {
+    if (isHandle(selector)) return deref(selector.substring(HANDLE_PREFIX.length));
+    return run(lookupEntry(selector), function() { return document.querySelector(selector); });
+  }
+
+  // Read-only form of q(): reuses the previous match while the DOM is unchanged
+  function lookup(selector) {
+    if (isHandle(selector)) return q(selector);
+    var tracked = syncGeneration();
+    var entry = lookupEntry(selector);
+    if (!tracked || entry.volatile || entry.generation !== domGeneration ||
+        entry.node === undefined || (entry.node && !entry.node.isConnected)) {
+      entry.node = run(entry, function() { return document.querySelector(selector); });
+      entry.count = undefined;
+      entry.generation = domGeneration;
+    }
+    return entry.node;
+  }
+
+  function countOf(selector) {
+    var tracked = syncGeneration();
+    var entry = lookupEntry(selector);
+    if (!tracked || entry.volatile || entry.generation !== domGeneration || entry.count === undefined) {
+      if (entry.generation !== domGeneration) entry.node = undefined;
+      entry.count = run(entry, function() { return document.querySelectorAll(selector).length; });
+      entry.generation = domGeneration;
+    }
+    return entry.count;
+  }
+
+  // Open table extractions: id -> {rows (static NodeList), fields, pos}
+  var tables = new Map();
+  var nextTable = 1;
+
+  // textContent avoids the per-row layout flush innerText would force
+  function cellValue(row, field) {
+    var el = field.selector ? row.querySelector(field.selector) : row;
+    if (!el) return null;
+    if (!field.attr) return (el.textContent || '').replace(/\s+/g, ' ').trim();
+    // href/src/value read the resolved property, everything else the attribute
+    if (field.attr === 'href' || field.attr === 'src' || field.attr === 'value') {
+      var prop = el[field.attr];
+      if (typeof prop === 'string') return prop;
+    }
+    return el.getAttribute(field.attr);
+  }
+
+  // Form fields are addressed by selector, then by name, then by id
+  function formField(key) {
+    var el = null;
+    try { el = q(key); } catch (e) {}
+    if (!el) {
+      var named = document.getElementsByName(key);
+      el = named.length ? named[0] : document.getElementById(key);
+    }
+    return el;
+  }
+
+  function truthy(value) {
+    return value === true || value === 1 || value === 'true' || value === 'on' || value === '1' || value === 'yes';
+  }
+
+  // Assign through the prototype setter so framework value trackers see a real change
+  function setNativeValue(el, value) {
+    var proto = el.tagName === 'TEXTAREA' ? HTMLTextAreaElement.prototype : HTMLInputElement.prototype;
+    var descriptor = Object.getOwnPropertyDescriptor(proto, 'value');
+    if (descriptor && descriptor.set) descriptor.set.call(el, value);
+    else el.value = value;
+  }
+
+  function fillField(el, value) {
+    var tag = el.tagName;
+    var type = (el.type || '').toLowerCase();
+    if (el.disabled) return 'disabled';
+
+    if (tag === 'INPUT' && (type === 'checkbox' || type === 'radio')) {
+      var group = el.name ? Array.prototype.filter.call(document.getElementsByName(el.name), function(box) {
+        return box.type === el.type;
+      }) : [el];
+      if (type === 'radio' || Array.isArray(value)) {
+        // Pick by value: one radio, or every checkbox listed
+        var wanted = Array.isArray(value) ? value.map(String) : [String(value)];
+        var hits = 0;
+        group.forEach(function(box) {
+          var on = wanted.indexOf(box.value) !== -1 || (group.length === 1 && truthy(value));
+          if (type === 'checkbox' || on) {
+            if (box.checked !== on) { box.checked = on; fire(box, 'input'); fire(box, 'change'); }
+          }
+          if (on) hits++;
+        });
+        return hits > 0 ? 'ok' : 'no_option: ' + wanted.join(',');
+      }
+      var checked = truthy(value);
+      if (el.checked !== checked) { el.checked = checked; fire(el, 'input'); fire(el, 'change'); }
+      return 'ok';
+    }
+
+    if (tag === 'SELECT') {
+      var options = Array.isArray(value) ? value.map(String) : [String(value)];
+      var matched = 0;
+      for (var i = 0; i < el.options.length; i++) {
+        var option = el.options[i];
+        var on = options.indexOf(option.value) !== -1 || options.indexOf(option.text.trim()) !== -1;
+        if (el.multiple) option.selected = on;
+        else if (on && matched === 0) el.selectedIndex = i;
+        if (on) matched++;
+      }
+      if (matched === 0) return 'no_option: ' + options.join(',');
+      fire(el, 'input');
+      fire(el, 'change');
+      return 'ok';
+    }
+
+    if (tag === 'INPUT' && type === 'file') return 'unsupported: file input';
+
+    var text = value === null || value === undefined ? '' : String(value);
+    if (tag === 'INPUT' || tag === 'TEXTAREA') {
+      setNativeValue(el, text);
+      fire(el, 'input');
+      fire(el, 'change');
+      return el.value === text ? 'ok' : 'mismatch: ' + el.value;
+    }
+    if (el.isContentEditable) {
+      el.textContent = text;
+      fire(el, 'input');
+      return 'ok';
+    }
+    return 'unsupported: ' + tag.toLowerCase();
+  }
+
+  // Input types that accept typed text
+  var TEXT_INPUT_TYPES = ['text', 'search', 'email', 'url', 'tel', 'password', 'number'];
+
+  function fire(el, type) { el.dispatchEvent(new Event(type, { bubbles: true })); }
+
+  // Resolves true once selector matches, false after timeout_ms
+  function waitFor(selector, timeout_ms) {
+    return new Promise(function(resolve) {
+      try { if (q(selector)) return resolve(true); } catch (e) { return resolve(false); }
+      if (!timeout_ms) return resolve(false);
+      var observer = new MutationObserver(function() {
+        if (q(selector)) { observer.disconnect(); clearTimeout(timer); resolve(true); }
+      });
+      var timer = setTimeout(function() { observer.disconnect(); resolve(false); }, timeout_ms);
+      observer.observe(document.documentElement || document, { childList: true, subtree: true, attributes: true });
+    });
+  }
+
+  // Readable content: score blocks by the paragraph text they hold (readability
+  // style), then serialize the winner as Markdown or plain text. Uses only
+  // textContent and attributes, so it never forces layout.
+  var SKIP_TAGS = /^(SCRIPT|STYLE|NOSCRIPT|TEMPLATE|SVG|IFRAME|OBJECT|EMBED|CANVAS|BUTTON|INPUT|SELECT|TEXTAREA|NAV|ASIDE|FOOTER|DIALOG)$/i;
+  var POSITIVE_HINT = /article|body|content|entry|main|page|post|text|blog|story/i;
+  var NEGATIVE_HINT = /comment|footer|footnote|header|menu|meta|nav|promo|related|share|sidebar|social|sponsor|banner|cookie|popup|\bads?\b/i;
+
+  function skipped(el) {
+    return SKIP_TAGS.test(el.tagName) || el.hidden || el.getAttribute('aria-hidden') === 'true' ||
+      el.getAttribute('role') === 'navigation';
+  }
+
+  var INLINE_TAGS = /^(A|SPAN|STRONG|B|EM|I|CODE|IMG|SMALL|SUB|SUP|MARK|ABBR|TIME|LABEL)$/;
+
+  function squash(text) { return (text || '').replace(/\s+/g, ' ').trim(); }
+
+  function linkDensity(el) {
+    var total = squash(el.textContent).length;
+    if (!total) return 0;
+    var linked = 0;
+    var links = el.getElementsByTagName('a');
+    for (var i = 0; i < links.length; i++) linked += squash(links[i].textContent).length;
+    return linked / total;
+  }
+
+  function mainContent() {
+    var explicit = document.querySelector('article, main, [role="main"]');
+    if (explicit && squash(explicit.textContent).length > 200) return explicit;
+    if (!document.body) return null;
+
+    var scores = new Map();
+    function credit(el, amount) {
+      if (!el || el === document.documentElement) return;
+      if (!scores.has(el)) {
+        var hints = (el.className && typeof el.className === 'string' ? el.className : '') + ' ' + (el.id || '');
+        scores.set(el, (POSITIVE_HINT.test(hints) ? 25 : 0) - (NEGATIVE_HINT.test(hints) ? 25 : 0));
+      }
+      scores.set(el, scores.get(el) + amount);
+    }
+
+    var blocks = document.body.querySelectorAll('p, pre, td, blockquote, li');
+    for (var i = 0; i < blocks.length; i++) {
+      var text = squash(blocks[i].textContent);
+      if (text.length < 25) continue;
+      var score = 1 + text.split(',').length + Math.min(Math.floor(text.length / 100), 3);
+      credit(blocks[i].parentElement, score);
+      if (blocks[i].parentElement) credit(blocks[i].parentElement.parentElement, score / 2);
+    }
+
+    var best = null;
+    var bestScore = 0;
+    scores.forEach(function(score, el) {
+      var adjusted = score * (1 - linkDensity(el));
+      if (adjusted > bestScore) { best = el; bestScore = adjusted; }
+    });
+    return best || document.body;
+  }
+
+  function serialize(root, markdown) {
+    var out = [];
+
+    function inlineNode(child) {
+      if (child.nodeType === 3) return child.nodeValue.replace(/\s+/g, ' ');
+      if (child.nodeType !== 1 || skipped(child)) return '';
+      var tag = child.tagName;
+      if (tag === 'BR') return '\n';
+      var inner = inline(child);
+      if (!markdown) return inner;
+      if (tag === 'A') {
+        var href = child.href;
+        return href && inner.trim() && href.indexOf('javascript:') !== 0 ? '[' + inner.trim() + '](' + href + ')' : inner;
+      }
+      if (tag === 'STRONG' || tag === 'B') return inner.trim() ? '**' + inner.trim() + '**' : '';
+      if (tag === 'EM' || tag === 'I') return inner.trim() ? '*' + inner.trim() + '*' : '';
+      if (tag === 'CODE') return '`' + child.textContent + '`';
+      if (tag === 'IMG') return child.alt ? '![' + child.alt + '](' + child.src + ')' : '';
+      return inner;
+    }
+
+    function inline(node) {
+      var text = '';
+      for (var child = node.firstChild; child; child = child.nextSibling) text += inlineNode(child);
+      return text;
+    }
+
+    function emit(text, prefix) {
+      text = text.replace(/[ \t]+\n/g, '\n').replace(/\n{3,}/g, '\n\n').trim();
+      if (text) out.push((prefix || '') + text);
+    }
+
+    function list(el, depth, lines) {
+      var n = 0;
+      for (var item = el.firstElementChild; item; item = item.nextElementSibling) {
+        if (item.tagName !== 'LI' || skipped(item)) continue;
+        n++;
+        var marker = el.tagName === 'OL' && markdown ? n + '. ' : '- ';
+        var indent = new Array(depth + 1).join('  ');
+        var text = '';
+        for (var c = item.firstChild; c; c = c.nextSibling) {
+          if (c.nodeType === 1 && (c.tagName === 'UL' || c.tagName === 'OL')) continue;
+          text += inlineNode(c);
+        }
+        if (text.trim()) lines.push(indent + marker + text.trim());
+        for (var sub = item.firstElementChild; sub; sub = sub.nextElementSibling) {
+          if (sub.tagName === 'UL' || sub.tagName === 'OL') list(sub, depth + 1, lines);
+        }
+      }
+    }
+
+    function table(el, lines) {
+      var rows = el.querySelectorAll('tr');
+      for (var r = 0; r < rows.length; r++) {
+        var cells = [];
+        for (var c = rows[r].firstElementChild; c; c = c.nextElementSibling) {
+          var cell = squash(inline(c));
+          cells.push(markdown ? cell.replace(/\|/g, '\\|') : cell);
+        }
+        if (!cells.length) continue;
+        lines.push(markdown ? '| ' + cells.join(' | ') + ' |' : cells.join('\t'));
+        if (markdown && lines.length === 1) lines.push('|' + cells.map(function() { return ' --- '; }).join('|') + '|');
+      }
+    }
+
+    // Lists and tables become one block of single-spaced lines
+    function lineBlock(fill) {
+      var collected = [];
+      fill(collected);
+      if (collected.length) out.push(collected.join('\n'));
+    }
+
+    function blockNode(child) {
+      if (child.nodeType === 3) { if (child.nodeValue.trim()) emit(child.nodeValue.replace(/\s+/g, ' ')); return; }
+      if (child.nodeType !== 1 || skipped(child)) return;
+      var tag = child.tagName;
+      var level = /^H([1-6])$/.exec(tag);
+      if (level) emit(squash(inline(child)), markdown ? new Array(+level[1] + 1).join('#') + ' ' : '');
+      else if (tag === 'P') emit(inline(child));
+      else if (tag === 'UL' || tag === 'OL') lineBlock(function(into) { list(child, 0, into); });
+      else if (tag === 'PRE') {
+        var code = child.textContent.replace(/\n+$/, '');
+        if (code) out.push(markdown ? '```\n' + code + '\n```' : code);
+      }
+      else if (tag === 'BLOCKQUOTE') {
+        var quote = squash(inline(child));
+        if (quote) out.push(markdown ? '> ' + quote : quote);
+      } else if (tag === 'TABLE') lineBlock(function(into) { table(child, into); });
+      else if (tag === 'HR') { if (markdown) out.push('---'); }
+      else if (INLINE_TAGS.test(tag)) emit(inlineNode(child));
+      else block(child);
+    }
+
+    function block(el) {
+      for (var child = el.firstChild; child; child = child.nextSibling) blockNode(child);
+    }
+
+    blockNode(root);
+    return out.join('\n\n');
+  }
+
+  // DOM mirror: nodes get small integer ids, a snapshot sends the node table
+  // once, and later changes go out as diffs through the hwebMutation handler
+  var mirror = null;
+  var MIRROR_FLUSH_MS = 50;
+
+  function mirrorId(node) {
+    var id = mirror.ids.get(node);
+    if (!id) {
+      id = mirror.next++;
+      mirror.ids.set(node, id);
+    }
+    return id;
+  }
+
+  // Rows in document order: [id, parent, 1, tag, {attrs}] for elements,
+  // [id, parent, 3|8, data] for text and comments
+  function mirrorRows(node, parentId, rows) {
+    var type = node.nodeType;
+    if (type !== 1 && type !== 3 && type !== 8) return;
+    var id = mirrorId(node);
+    if (type !== 1) {
+      rows.push([id, parentId, type, node.data]);
+      return;
+    }
+    var attrs = {};
+    for (var i = 0; i < node.attributes.length; i++) attrs[node.attributes[i].name] = node.attributes[i].value;
+    rows.push([id, parentId, 1, node.tagName.toLowerCase(), attrs]);
+    for (var child = node.firstChild; child; child = child.nextSibling) mirrorRows(child, id, rows);
+  }
+
+  function mirrorPrevious(node) {
+    var prev = node.previousSibling;
+    while (prev && !mirror.ids.has(prev)) prev = prev.previousSibling;
+    return prev ? mirror.ids.get(prev) : 0;
+  }
+
+  // Records are folded against the final DOM: removals first, then each new
+  // child in order, then the last value of every touched attribute or text
+  function mirrorFlush() {
+    mirror.timer = 0;
+    var records = mirror.pending.concat(mirror.observer.takeRecords());
+    mirror.pending = [];
+    var ops = [];
+    var added = new Set();
+    var parents = [];
+    var touched = [];
+
+    records.forEach(function(r) {
+      if (r.type !== 'childList') { touched.push(r); return; }
+      r.removedNodes.forEach(function(node) {
+        var id = mirror.ids.get(node);
+        if (id) ops.push(['remove', id]);
+      });
+      r.addedNodes.forEach(function(node) { added.add(node); });
+      if (parents.indexOf(r.target) === -1) parents.push(r.target);
+    });
+
+    parents.forEach(function(parent) {
+      var parentId = parent === document ? 0 : mirror.ids.get(parent);
+      if (parentId === undefined || !parent.isConnected) return;
+      // A subtree inserted in this batch already carries its children
+      for (var up = parent; up; up = up.parentNode) if (added.has(up)) return;
+      for (var child = parent.firstChild; child; child = child.nextSibling) {
+        if (!added.has(child)) continue;
+        var rows = [];
+        mirrorRows(child, parentId, rows);
+        if (rows.length) ops.push(['insert', parentId, mirrorPrevious(child), rows]);
+      }
+    });
+
+    var seen = new Set();
+    touched.forEach(function(r) {
+      var id = mirror.ids.get(r.target);
+      if (!id || !r.target.isConnected) return;
+      var key = r.type === 'attributes' ? id + '@' + r.attributeName : String(id);
+      if (seen.has(key)) return;
+      seen.add(key);
+      if (r.type === 'attributes') ops.push(['attr', id, r.attributeName, r.target.getAttribute(r.attributeName)]);
+      else ops.push(['text', id, r.target.data]);
+    });
+
+    if (ops.length) {
+      window.webkit.messageHandlers.hwebMutation.postMessage(JSON.stringify({ seq: ++mirror.seq, ops: ops }));
+    }
+  }
+
+  // Message handlers are bound once, when the runtime is injected ahead of
+  // any page script, so a page that later swaps postMessage or
+  // JSON.stringify never sees the transfer tokens passed through them
+  var stringify = JSON.stringify;
+  function bindHandler(name) {
+    try {
+      var handler = window.webkit.messageHandlers[name];
+      return handler ? handler.postMessage.bind(handler) : null;
+    } catch (e) { return null; }
+  }
+  var postChunk = bindHandler('hwebChunk');
+  var postUpload = bindHandler('hwebUpload');
+
+  // Upload reporting: XMLHttpRequest and fetch calls whose body carries
+  // files are announced through the hwebUpload handler, with XHR upload
+  // progress at most every UPLOAD_REPORT_MS per request. Every report
+  // carries the host's token, so the host can drop reports a page forges.
+  var uploadsWatched = false;
+  var uploadToken = '';
+  var uploadSeq = 0;
+  var uploadPrefix = Date.now().toString(36) + Math.random().toString(36).slice(2, 6);
+  var UPLOAD_REPORT_MS = 100;
+
+  function uploadParts(body) {
+    var names = [], size = 0;
+    var add = function(v) {
+      if (typeof File === 'function' && v instanceof File) { names.push(v.name); size += v.size; }
+    };
+    if (typeof FormData === 'function' && body instanceof FormData) body.forEach(add);
+    else add(body);
+    return names.length ? { names: names, size: size } : null;
+  }
+
+  function uploadReporter(url, parts) {
+    var id = uploadPrefix + ':' + (++uploadSeq);
+    return function(state, sent, total, status) {
+      try {
+        postUpload(stringify({
+          token: uploadToken, id: id, url: String(url || ''), files: parts.names,
+          state: state, sent: sent, total: total, status: status || 0
+        }));
+      } catch (e) {}
+    };
+  }
+
+  function watchUploads() {
+    var urls = new WeakMap();
+    var open = XMLHttpRequest.prototype.open;
+    var send = XMLHttpRequest.prototype.send;
+    XMLHttpRequest.prototype.open = function(method, url) {
+      urls.set(this, url);
+      return open.apply(this, arguments);
+    };
+    XMLHttpRequest.prototype.send = function(body) {
+      var parts = uploadParts(body);
+      if (parts) {
+        var xhr = this, last = 0;
+        var report = uploadReporter(urls.get(xhr), parts);
+        report('progress', 0, parts.size);
+        xhr.upload.addEventListener('progress', function(e) {
+          var now = Date.now();
+          if (now - last < UPLOAD_REPORT_MS && e.loaded < e.total) return;
+          last = now;
+          report('progress', e.loaded, e.lengthComputable ? e.total : 0);
+        });
+        xhr.addEventListener('loadend', function() {
+          var ok = xhr.status >= 200 && xhr.status < 400;
+          report(ok ? 'done' : 'failed', 0, 0, xhr.status);
+        });
+      }
+      return send.apply(this, arguments);
+    };
+
+    if (typeof window.fetch === 'function') {
+      var fetch = window.fetch;
+      window.fetch = function(input, init) {
+        var parts = init && uploadParts(init.body);
+        if (!parts) return fetch.apply(this, arguments);
+        // fetch exposes no upload progress, only the start and the response
+        var report = uploadReporter(typeof input === 'string' ? input : input && input.url, parts);
+        report('progress', 0, parts.size);
+        return fetch.apply(this, arguments).then(function(response) {
+          report(response.ok ? 'done' : 'failed', 0, 0, response.status);
+          return response;
+        }, function(error) {
+          report('failed', 0, 0, 0);
+          throw error;
+        });
+      };
+    }
+  }
+
+  var H = {
+    version: 1,
+
+    exists: function(selector) {
+      try {
+        if (!document || !document.querySelector) return 'NO_DOCUMENT';
+        return lookup(selector) !== null;
+      } catch (e) { return 'SELECTOR_ERROR:' + e.message; }
+    },
+
+    count: function(selector) {
+      try { return countOf(selector); }
+      catch (e) { return 'SELECTOR_ERROR:' + e.message; }
+    },
+
+    fill: function(selector, value) {
+      try {
+        var el = q(selector);
+        if (!el) return 'ELEMENT_NOT_FOUND';
+        el.focus();
+        el.click();
+        el.value = '';
+        el.value = value;
+        fire(el, 'focus');
+        fire(el, 'input');
+        fire(el, 'keydown');
+        fire(el, 'keyup');
+        fire(el, 'change');
+        if (el._valueTracker) el._valueTracker.setValue(value);
+        return 'FILL_SUCCESS';
+      } catch (e) { return 'FILL_ERROR: ' + e.message; }
+    },
+
+    // Focus a text control (and select its contents when replacing) so that
+    // trusted editing commands from the host land in it
+    prepareInput: function(selector, replace) {
+      try {
+        var el = q(selector);
+        if (!el) return 'ELEMENT_NOT_FOUND';
+        var textControl = el.tagName === 'TEXTAREA' ||
+          (el.tagName === 'INPUT' && TEXT_INPUT_TYPES.indexOf(el.type) !== -1);
+        if (!textControl && !el.isContentEditable) return 'NOT_EDITABLE';
+        if (el.disabled || el.readOnly) return 'NOT_EDITABLE';
+        el.focus();
+        if (textControl) {
+          if (replace === 'true') {
+            try { el.select(); } catch (e) { el.value = ''; }
+          } else {
+            try { el.setSelectionRange(el.value.length, el.value.length); } catch (e) {}
+          }
+        } else {
+          var range = document.createRange();
+          range.selectNodeContents(el);
+          if (replace !== 'true') range.collapse(false);
+          var selection = window.getSelection();
+          selection.removeAllRanges();
+          selection.addRange(range);
+        }
+        return document.activeElement === el || el.contains(document.activeElement) ? 'READY' : 'NOT_FOCUSED';
+      } catch (e) { return 'JS_ERROR: ' + e.message; }
+    },
+
+    // After trusted input: check the result and commit it the way a blur would
+    settleInput: function(selector, check, expected) {
+      try {
+        var el = q(selector);
+        if (!el) return 'ELEMENT_NOT_FOUND';
+        var actual = el.isContentEditable ? el.textContent : el.value;
+        if (check === 'true' && actual !== expected) return 'VALUE_MISMATCH: ' + actual;
+        if (!el.isContentEditable) fire(el, 'change');
+        return 'true';
+      } catch (e) { return 'JS_ERROR: ' + e.message; }
+    },
+
+    value: function(selector) {
+      try {
+        var el = lookup(selector);
+        return el ? String(el.value) : 'NOT_FOUND';
+      } catch (e) { return 'NOT_FOUND'; }
+    },
+
+    forceValue: function(selector, value) {
+      try {
+        var el = q(selector);
+        if (!el) return 'retry_failed';
+        el.setAttribute('value', value);
+        el.value = value;
+        return 'retry_success';
+      } catch (e) { return 'retry_error'; }
+    },
+
+    click: function(selector) {
+      try {
+        var el = q(selector);
+        if (!el) return 'ELEMENT_NOT_FOUND';
+        var rect = el.getBoundingClientRect();
+        if (rect.width <= 0 || rect.height <= 0) return 'ELEMENT_NOT_VISIBLE';
+        el.click();
+        return 'CLICKED_SUCCESS';
+      } catch (e) { return 'JS_ERROR: ' + e.message; }
+    },
+
+    submit: function(selector) {
+      try {
+        var form = q(selector);
+        if (!form) return false;
+        form.submit();
+        return true;
+      } catch (e) { return false; }
+    },
+
+    search: function(query) {
+      try {
+        var inputs = document.querySelectorAll("input[type='search'], input[name*='search'], input[placeholder*='search']");
+        if (inputs.length === 0) return false;
+        inputs[0].value = query;
+        fire(inputs[0], 'input');
+        var form = inputs[0].closest('form');
+        if (!form) return false;
+        form.submit();
+        return true;
+      } catch (e) { return false; }
+    },
+
+    select: function(selector, value) {
+      try {
+        var el = q(selector);
+        if (!el) return 'false';
+        el.focus();
+        el.value = value;
+        fire(el, 'change');
+        fire(el, 'blur');
+        return 'true';
+      } catch (e) { return 'error: ' + e.message; }
+    },
+
+    selectByOption: function(selector, value) {
+      try {
+        var el = q(selector);
+        if (el) {
+          for (var i = 0; i < el.options.length; i++) {
+            if (el.options[i].value === value) {
+              el.selectedIndex = i;
+              fire(el, 'change');
+              return 'retry_success';
+            }
+          }
+        }
+        return 'retry_failed';
+      } catch (e) { return 'retry_error'; }
+    },
+
+    setChecked: function(selector, checked) {
+      try {
+        var el = q(selector);
+        if (!el) return 'false';
+        el.focus();
+        el.checked = (checked === 'true');
+        fire(el, 'change');
+        fire(el, 'click');
+        fire(el, 'blur');
+        return 'true';
+      } catch (e) { return 'error: ' + e.message; }
+    },
+
+    isChecked: function(selector) {
+      try {
+        var el = lookup(selector);
+        return el ? el.checked : 'NOT_FOUND';
+      } catch (e) { return 'NOT_FOUND'; }
+    },
+
+    focus: function(selector) {
+      try {
+        var el = q(selector);
+        if (!el) return false;
+        el.focus();
+        return true;
+      } catch (e) { return false; }
+    },
+
+    html: function(selector) {
+      try {
+        var el = lookup(selector);
+        return el ? el.outerHTML : '';
+      } catch (e) { return ''; }
+    },
+
+    innerText: function(selector) {
+      try {
+        if (document.readyState === 'loading') return 'DOCUMENT_LOADING';
+        var el = lookup(selector);
+        if (!el) return 'ELEMENT_NOT_FOUND';
+        return (el.innerText || el.textContent || '').trim();
+      } catch (e) { return 'JS_ERROR: ' + e.message; }
+    },
+
+    firstText: function(selector) {
+      try {
+        var els = run(lookupEntry(selector), function() { return document.querySelectorAll(selector); });
+        for (var i = 0; i < els.length; i++) {
+          var text = (els[i].innerText || els[i].textContent || '').trim();
+          if (text.length > 0) return text;
+        }
+        return '';
+      } catch (e) { return ''; }
+    },
+
+    getAttr: function(selector, name) {
+      try {
+        var el = lookup(selector);
+        if (!el) return '';
+        if (name === 'value') return el.value || '';
+        return el.getAttribute(name) || '';
+      } catch (e) { return ''; }
+    },
+
+    setAttr: function(selector, name, value) {
+      try {
+        var el = q(selector);
+        if (!el) return 'element_not_found';
+        el.setAttribute(name, value);
+        return 'success';
+      } catch (e) { return 'error: ' + e.message; }
+    },
+
+    attr: function(selector, name) {
+      try {
+        var el = lookup(selector);
+        if (!el) return 'element_not_found';
+        var v = el.getAttribute(name);
+        return v !== null ? v : 'null_attribute';
+      } catch (e) { return 'verify_error: ' + e.message; }
+    },
+
+    // Clicking a file input makes WebKit ask the UI process for files
+    // (run-file-chooser); the browser answers with the pending paths
+    openFileChooser: function(selector) {
+      try {
+        var el = q(selector);
+        if (!el) return 'ELEMENT_NOT_FOUND';
+        if (el.tagName !== 'INPUT' || (el.type || '').toLowerCase() !== 'file') return 'NOT_FILE_INPUT';
+        if (el.disabled) return 'DISABLED';
+        el.click();
+        return 'OPENED';
+      } catch (e) { return 'SELECTOR_ERROR:' + e.message; }
+    },
+
+    fileCount: function(selector) {
+      try {
+        var el = q(selector);
+        return el && el.files ? el.files.length : -1;
+      } catch (e) { return -1; }
+    },
+
+    // The first token wins for the life of the document
+    uploadWatch: function(token) {
+      postUpload = postUpload || bindHandler('hwebUpload');
+      if (!postUpload) return 'UNAVAILABLE';
+      if (!uploadsWatched) {
+        uploadToken = String(token);
+        watchUploads();
+        uploadsWatched = true;
+      }
+      return uploadToken === String(token) ? 'WATCHING' : 'TOKEN_MISMATCH';
+    },
+
+    acquire: function(selector) {
+      try {
+        var el = lookup(selector);
+        if (!el) return '';
+        var id = handleIds.get(el);
+        if (id && handles.has(id)) return id;
+        id = String(nextHandle++);
+        handles.set(id, typeof WeakRef === 'function' ? new WeakRef(el) : el);
+        handleIds.set(el, id);
+        if (registry) registry.register(el, id);
+        return id;
+      } catch (e) { return 'SELECTOR_ERROR:' + e.message; }
+    },
+
+    release: function(id) {
+      return handles.delete(id);
+    },
+
+    pageSource: function() {
+      return document.documentElement ? document.documentElement.outerHTML : '';
+    },
+
+    // Run another method and post its string result to the host in slices
+    // ("<id>:<last>:<data>") instead of returning it; replies 'STREAM:<slices>'.
+    // id is a random token from the host, which drops slices without it.
+    stream: function(id, method) {
+      postChunk = postChunk || bindHandler('hwebChunk');
+      if (!postChunk) return 'STREAM_UNAVAILABLE';
+      var fn = H[method];
+      if (typeof fn !== 'function' || method === 'stream') return 'STREAM_ERROR:unknown method ' + method;
+      var value;
+      try { value = fn.apply(null, Array.prototype.slice.call(arguments, 2)); }
+      catch (e) { return 'STREAM_ERROR:' + e.message; }
+      value = value === null || value === undefined ? '' : String(value);
+
+      var SLICE = 262144;
+      var slices = 0;
+      var pos = 0;
+      do {
+        var end = Math.min(pos + SLICE, value.length);
+        // Never split a surrogate pair across two messages
+        if (end < value.length) {
+          var code = value.charCodeAt(end - 1);
+          if (code >= 0xD800 && code <= 0xDBFF) end--;
+        }
+        postChunk(id + (end >= value.length ? ':1:' : ':0:') + value.substring(pos, end));
+        slices++;
+        pos = end;
+      } while (pos < value.length);
+      return 'STREAM:' + slices;
+    },
+
+    // Fill many fields at once: {"key": value} -> JSON {"key": status}, in key order
+    fillForm: function(json) {
+      var fields = JSON.parse(json);
+      var status = {};
+      Object.keys(fields).forEach(function(key) {
+        try {
+          var el = formField(key);
+          status[key] = el ? fillField(el, fields[key]) : 'not_found';
+        } catch (e) { status[key] = 'error: ' + e.message; }
+      });
+      return JSON.stringify(status);
+    },
+
+    // Start a table extraction; rows are read later, chunk by chunk, via tableNext
+    tableBegin: function(specJson) {
+      try {
+        var spec = JSON.parse(specJson);
+        var id = String(nextTable++);
+        tables.set(id, { rows: document.querySelectorAll(spec.rows), fields: spec.fields, pos: 0 });
+        return id;
+      } catch (e) { return 'SELECTOR_ERROR:' + e.message; }
+    },
+
+    // Next rows as a JSON array of cell arrays, at most maxChars long unless a
+    // single row is larger. '[]' means the extraction is finished and closed.
+    tableNext: function(id, maxChars) {
+      var t = tables.get(id);
+      if (!t) return '[]';
+      var limit = Number(maxChars) || 32000;
+      var out = [];
+      var size = 2;
+      while (t.pos < t.rows.length) {
+        var row = t.rows[t.pos];
+        var cells = [];
+        for (var i = 0; i < t.fields.length; i++) cells.push(cellValue(row, t.fields[i]));
+        var json = JSON.stringify(cells);
+        if (out.length > 0 && size + json.length + 1 > limit) break;
+        out.push(json);
+        size += json.length + 1;
+        t.pos++;
+      }
+      if (out.length === 0) tables.delete(id);
+      return '[' + out.join(',') + ']';
+    },
+
+    tableEnd: function(id) {
+      return tables.delete(id);
+    },
+
+    // Node table of the whole document; changes stream as diffs until domUnwatch
+    domSnapshot: function() {
+      var handlers = window.webkit && window.webkit.messageHandlers;
+      if (!handlers || !handlers.hwebMutation) throw new Error('hwebMutation handler missing');
+      H.domUnwatch();
+      mirror = { ids: new WeakMap(), next: 1, seq: 0, pending: [], timer: 0, observer: null };
+      var rows = [];
+      if (document.documentElement) mirrorRows(document.documentElement, 0, rows);
+      mirror.observer = new MutationObserver(function(records) {
+        Array.prototype.push.apply(mirror.pending, records);
+        if (!mirror.timer) mirror.timer = setTimeout(mirrorFlush, MIRROR_FLUSH_MS);
+      });
+      mirror.observer.observe(document, { childList: true, subtree: true, attributes: true, characterData: true });
+      return JSON.stringify({ seq: 0, nodes: rows });
+    },
+
+    domUnwatch: function() {
+      if (!mirror) return false;
+      if (mirror.timer) clearTimeout(mirror.timer);
+      mirror.observer.disconnect();
+      mirror = null;
+      return true;
+    },
+
+    // Main content of the page as 'markdown' or plain 'text'
+    readable: function(format) {
+      var markdown = format === 'markdown';
+      var root = mainContent();
+      if (!root) return '';
+      var body = serialize(root, markdown);
+      var title = squash(document.title);
+      var hasHeading = root.querySelector && root.querySelector('h1');
+      if (!title || hasHeading) return body;
+      return (markdown ? '# ' + title : title) + '\n\n' + body;
+    },
+
+    typeText: function(selector, value) {
+      var result = H.fill(selector, value);
+      if (result !== 'FILL_SUCCESS') return result;
+      if (H.value(selector) === value) return result;
+      return H.forceValue(selector, value) === 'retry_success' ? result : 'FILL_VERIFY_FAILED';
+    },
+
+    // Execute a compiled command list: [{op, args, wait}] -> JSON [{value} | {error}]
+    runBatch: async function(json) {
+      var steps = JSON.parse(json);
+      var results = [];
+      for (var i = 0; i < steps.length; i++) {
+        var step = steps[i];
+        try {
+          if (step.wait > 0) await waitFor(step.args[0], step.wait);
+          var fn = H[step.op];
+          if (typeof fn !== 'function') throw new Error('unknown step ' + step.op);
+          results.push({ value: String(fn.apply(null, step.args)) });
+        } catch (e) {
+          results.push({ error: String(e && e.message ? e.message : e) });
+        }
+      }
+      return JSON.stringify(results);
+    },
+
+    forceAttr: function(selector, name, value) {
+      try {
+        var el = q(selector);
+        if (!el) return 'retry_no_element';
+        el.setAttribute(name, value);
+        el.offsetHeight;
+        var check = el.getAttribute(name);
+        return check !== null ? 'retry_success:' + check : 'retry_failed';
+      } catch (e) { return 'retry_error: ' + e.message; }
+    }
+  };
+
+  Object.defineProperty(window, '__hweb', {
+    value: Object.freeze(H), writable: false, enumerable: false, configurable: false
+  });
+})();
+)JS";
+    return runtime;
+}
+
+std::string argName(size_t index) {
+    return "a" + std::to_string(index);
+}
+
+std::string callBody(const std::string& method, size_t arg_count) {
+    std::string args;
+    for (size_t i = 0; i < arg_count; ++i) {
+        if (i > 0) {
+            args += ", ";
+        }
+        args += argName(i);
+    }
+    return "if (!window.__hweb) return '" + std::string(MISSING_MARKER) + "'; "
+           "return window.__hweb." + method + "(" + args + ");";
+}
+
+} // namespace PageRuntime
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+// In-page helper runtime (window.__hweb) used by the DOM methods.
+// It is installed once per document as a WebKitUserScript and invoked with
+// typed arguments, so selectors and values are never spliced into source.
+
+namespace PageRuntime {
+
+    // Returned by a call when the document has no runtime (e.g. it was
+    // loaded before the user script was registered)
+    constexpr const char* MISSING_MARKER = "__HWEB_RUNTIME_MISSING__";
+
+    // Source of the runtime; safe to evaluate more than once per document
+    const std::string& source();
+
+    // Function body for webkit_web_view_call_async_javascript_function.
+    // Arguments are bound by name as a0..aN, so the body only depends on the
+    // method and arity and WebKit can reuse its compiled code.
+    std::string callBody(const std::string& method, size_t arg_count);
+
+    // Argument name bound to the given position
+    std::string argName(size_t index);
+}
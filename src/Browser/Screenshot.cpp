@@ -1,10 +1,21 @@
 #include "Browser.h"
 #include "../FileOps/PathUtils.h"
+#include "../FileOps/DirectoryHandle.h"
 #include <gtk/gtk.h>
 #include <webkit/webkit.h>
 #include <gdk/gdk.h>
 #include <cairo/cairo.h>
 #include <iostream>
+#include <cstring>
+#include <cstdio>
+#include <fstream>
+#include <thread>
+#include <chrono>
+#include <future>
+#include <deque>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
 
 // External debug flag
 extern bool g_debug;
@@ -14,13 +25,198 @@ struct ScreenshotData {
     std::string filename;
     GMainLoop* loop;
     bool success;
+    bool perceptual_hash;
+    ScreenshotStore* store;       // optional content-addressed store
+    ScreenshotInfo previous;      // last capture, for in-process dedup
+    ScreenshotInfo info;          // filled in by the callback
+    ScreenshotBuffer* buffer;     // in-memory target; filename is ignored when set
+    bool raw;                     // hand over ARGB32 pixels instead of PNG
 };
 
+// Growable g_malloc buffer filled by cairo's PNG stream encoder
+struct PngStreamBuffer {
+    guchar* data;
+    size_t size;
+    size_t capacity;
+};
+
+static cairo_status_t png_stream_writer(void* closure, const unsigned char* bytes, unsigned int length) {
+    PngStreamBuffer* stream = static_cast<PngStreamBuffer*>(closure);
+    
+    if (stream->size + length > stream->capacity) {
+        size_t capacity = stream->capacity ? stream->capacity : 64 * 1024;
+        while (capacity < stream->size + length) {
+            capacity *= 2;
+        }
+        guchar* grown = static_cast<guchar*>(g_try_realloc(stream->data, capacity));
+        if (!grown) {
+            return CAIRO_STATUS_NO_MEMORY;
+        }
+        stream->data = grown;
+        stream->capacity = capacity;
+    }
+    
+    memcpy(stream->data + stream->size, bytes, length);
+    stream->size += length;
+    return CAIRO_STATUS_SUCCESS;
+}
+
+// Encode pixels as PNG into data->buffer, or hand the raw pixels over directly.
+// Takes ownership of pixels.
+static bool deliver_screenshot_buffer(ScreenshotData* data, guchar* pixels, int width, int height, size_t stride) {
+    ScreenshotBuffer* buffer = data->buffer;
+    buffer->width = width;
+    buffer->height = height;
+    buffer->stride = stride;
+    buffer->raw = data->raw;
+    buffer->hash = data->info.hash;
+    
+    if (data->raw) {
+        buffer->reset(pixels, height * stride, g_free);
+        return true;
+    }
+    
+    bool ok = false;
+    cairo_surface_t* surface = cairo_image_surface_create_for_data(
+        pixels, CAIRO_FORMAT_ARGB32, width, height, stride);
+    
+    if (surface) {
+        PngStreamBuffer stream = {nullptr, 0, 0};
+        cairo_status_t status = cairo_surface_write_to_png_stream(surface, png_stream_writer, &stream);
+        
+        if (status == CAIRO_STATUS_SUCCESS) {
+            buffer->reset(stream.data, stream.size, g_free);
+            buffer->stride = 0;
+            ok = true;
+            debug_output("Screenshot encoded in memory: " + std::to_string(stream.size) + " bytes");
+        } else {
+            std::cerr << "Failed to encode PNG: " << cairo_status_to_string(status) << std::endl;
+            g_free(stream.data);
+        }
+        cairo_surface_destroy(surface);
+    } else {
+        std::cerr << "Failed to create cairo surface" << std::endl;
+    }
+    
+    g_free(pixels);
+    return ok;
+}
+
+// Encode ARGB32 pixels to a PNG file
+static bool write_png_file(const std::string& filename, guchar* pixels, int width, int height, size_t stride) {
+    // Create cairo surface from the pixel data
+    cairo_surface_t* surface = cairo_image_surface_create_for_data(
+        pixels, CAIRO_FORMAT_ARGB32, width, height, stride);
+    
+    if (!surface) {
+        std::cerr << "Failed to create cairo surface" << std::endl;
+        return false;
+    }
+    
+    // Save surface to PNG file. The old file may be a hard link shared with
+    // the store or earlier captures, so it is replaced rather than rewritten.
+    cairo_status_t status = CAIRO_STATUS_SUCCESS;
+    bool ok = ScreenshotStore::replaceFile(filename, [&](const std::string& temp_path) {
+        status = cairo_surface_write_to_png(surface, temp_path.c_str());
+        return status == CAIRO_STATUS_SUCCESS;
+    });
+    
+    if (ok) {
+        debug_output("Screenshot saved successfully: " + filename + 
+                   " (" + std::to_string(width) + "x" + std::to_string(height) + ")");
+    } else {
+        std::cerr << "Failed to write PNG: " << cairo_status_to_string(status) << std::endl;
+    }
+    
+    // Cleanup cairo surface
+    cairo_surface_destroy(surface);
+    return ok;
+}
+
+static cairo_status_t png_fd_writer(void* closure, const unsigned char* bytes, unsigned int length) {
+    int fd = *static_cast<int*>(closure);
+    while (length > 0) {
+        ssize_t written = write(fd, bytes, length);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return CAIRO_STATUS_WRITE_ERROR;
+        }
+        bytes += written;
+        length -= static_cast<unsigned int>(written);
+    }
+    return CAIRO_STATUS_SUCCESS;
+}
+
+// Encode ARGB32 pixels to name inside an already open output directory;
+// burst and sweep captures write every frame this way
+static bool write_png_at(const FileOps::DirectoryHandle& directory, const std::string& name,
+                         guchar* pixels, int width, int height, size_t stride) {
+    // Encode into a temporary entry and rename it over name, so an existing
+    // (possibly hard-linked) file is replaced instead of truncated; the pid
+    // keeps concurrent hweb processes off each other's temporary entry
+    std::string temp_name = name + ".tmp-" + std::to_string(getpid());
+    int fd = directory.openFile(temp_name, O_WRONLY | O_CREAT | O_TRUNC);
+    if (fd < 0) {
+        std::cerr << "Failed to open " << directory.pathFor(temp_name) << ": " << strerror(errno) << std::endl;
+        return false;
+    }
+    
+    cairo_surface_t* surface = cairo_image_surface_create_for_data(
+        pixels, CAIRO_FORMAT_ARGB32, width, height, stride);
+    cairo_status_t status = cairo_surface_write_to_png_stream(surface, png_fd_writer, &fd);
+    cairo_surface_destroy(surface);
+    
+    bool ok = close(fd) == 0 && status == CAIRO_STATUS_SUCCESS && directory.rename(temp_name, name);
+    if (!ok) {
+        directory.remove(temp_name);
+    }
+    if (ok) {
+        debug_output("Screenshot saved successfully: " + directory.pathFor(name) +
+                   " (" + std::to_string(width) + "x" + std::to_string(height) + ")");
+    } else {
+        std::cerr << "Failed to write PNG: " << cairo_status_to_string(status) << std::endl;
+    }
+    return ok;
+}
+
+// Write pixels to data->filename, skipping the encode when the frame is unchanged
+static bool write_screenshot_file(ScreenshotData* data, guchar* pixels, int width, int height, size_t stride) {
+    ScreenshotInfo& info = data->info;
+    ScreenshotStore* store = data->store;
+    const ScreenshotInfo& previous = data->previous;
+    
+    if (store && store->materialize(info.hash, data->filename)) {
+        info.deduplicated = true;
+        debug_output("Screenshot unchanged, linked from store: " + store->blobPath(info.hash));
+        return true;
+    }
+    if (previous.success && !previous.filename.empty() && previous.hash == info.hash &&
+        ScreenshotStore::linkOrCopy(previous.filename, data->filename)) {
+        info.deduplicated = true;
+        debug_output("Screenshot unchanged, linked to previous capture: " + previous.filename);
+        return true;
+    }
+    
+    if (!write_png_file(data->filename, pixels, width, height, stride)) {
+        return false;
+    }
+    
+    if (store && !store->ingest(info.hash, data->filename)) {
+        debug_output("Failed to add screenshot to store: " + store->root());
+    }
+    return true;
+}
+
 // Callback for screenshot completion
 void screenshot_callback(GObject* source_object, GAsyncResult* res, gpointer user_data) {
     ScreenshotData* data = static_cast<ScreenshotData*>(user_data);
     GError* error = NULL;
     
+    ScreenshotInfo& info = data->info;
+    info.filename = data->filename;
+    
     // Get the snapshot result from WebKit
     GdkTexture* texture = webkit_web_view_get_snapshot_finish(
         WEBKIT_WEB_VIEW(source_object), res, &error);
@@ -46,32 +242,25 @@ void screenshot_callback(GObject* source_object, GAsyncResult* res, gpointer use
             // Download texture data to our buffer
             gdk_texture_download(texture, pixels, stride);
             
-            // Create cairo surface from the pixel data
-            cairo_surface_t* surface = cairo_image_surface_create_for_data(
-                pixels, CAIRO_FORMAT_ARGB32, width, height, stride);
+            // Hash raw pixels before encoding so identical frames can skip PNG work
+            info.width = width;
+            info.height = height;
+            info.hash = ScreenshotStore::toHex(ScreenshotStore::hashPixels(pixels, width, height, stride));
+            if (data->perceptual_hash) {
+                info.perceptual_hash = ScreenshotStore::toHex(
+                    ScreenshotStore::perceptualHash(pixels, width, height, stride));
+            }
+            debug_output("Screenshot pixel hash: " + info.hash);
             
-            if (surface) {
-                // Save surface to PNG file
-                cairo_status_t status = cairo_surface_write_to_png(surface, data->filename.c_str());
-                
-                if (status == CAIRO_STATUS_SUCCESS) {
-                    data->success = true;
-                    debug_output("Screenshot saved successfully: " + data->filename + 
-                               " (" + std::to_string(width) + "x" + std::to_string(height) + ")");
-                } else {
-                    std::cerr << "Failed to write PNG: " << cairo_status_to_string(status) << std::endl;
-                    data->success = false;
-                }
-                
-                // Cleanup cairo surface
-                cairo_surface_destroy(surface);
+            if (data->buffer) {
+                // Buffer takes ownership of the pixels
+                data->success = deliver_screenshot_buffer(data, pixels, width, height, stride);
             } else {
-                std::cerr << "Failed to create cairo surface" << std::endl;
-                data->success = false;
+                data->success = write_screenshot_file(data, pixels, width, height, stride);
+                
+                // Free pixel buffer
+                g_free(pixels);
             }
-            
-            // Free pixel buffer
-            g_free(pixels);
         } else {
             std::cerr << "Failed to allocate pixel buffer" << std::endl;
             data->success = false;
@@ -84,6 +273,8 @@ void screenshot_callback(GObject* source_object, GAsyncResult* res, gpointer use
         data->success = false;
     }
     
+    info.success = data->success;
+    
     // Signal completion
     if (g_main_loop_is_running(data->loop)) {
         g_main_loop_quit(data->loop);
@@ -92,6 +283,28 @@ void screenshot_callback(GObject* source_object, GAsyncResult* res, gpointer use
 
 // ========== Screenshot Methods ==========
 
+ScreenshotStore* Browser::getScreenshotStore() {
+    if (!screenshot_store_ && !config_.screenshot_store_dir.empty()) {
+        if (!FileOps::PathUtils::createDirectoriesIfNeeded(config_.screenshot_store_dir)) {
+            std::cerr << "Error: Cannot create screenshot store: " + config_.screenshot_store_dir << std::endl;
+            return nullptr;
+        }
+        screenshot_store_ = std::make_unique<ScreenshotStore>(config_.screenshot_store_dir);
+    }
+    return screenshot_store_.get();
+}
+
+void Browser::prepareForScreenshot() {
+    // Ensure proper offscreen viewport and rendering
+    ensureProperViewportForScreenshots();
+    
+    // Capture as soon as the page reports two quiet frames (no mutations,
+    // layout shifts, pending fonts or images) instead of sleeping
+    if (!waitForPaintSettled(2000)) {
+        debug_output("Warning: Page did not settle before screenshot");
+    }
+}
+
 void Browser::takeScreenshot(const std::string& filename) {
     debug_output("Starting headless visible area screenshot: " + filename);
     
@@ -108,34 +321,17 @@ void Browser::takeScreenshot(const std::string& filename) {
         return;
     }
     
-    // Ensure proper offscreen viewport and rendering
-    ensureProperViewportForScreenshots();
-    
-    // Wait for rendering to complete using event-driven approach
-    if (async_nav_) {
-        auto future = async_nav_->waitForRenderingComplete(2000);
-        if (future.wait_for(std::chrono::milliseconds(2000)) != std::future_status::ready || !future.get()) {
-            // Fallback to readiness check or brief wait
-            if (readiness_tracker_ && readiness_tracker_->isFullyReady()) {
-                // Already ready, proceed
-            } else {
-                wait(250); // Reduced fallback wait
-            }
-        }
-    } else {
-        wait(250); // Reduced fallback wait
-    }
-    
-    // Check if page is ready
-    std::string readyState = executeJavascriptSync("(function() { try { return document.readyState; } catch(e) { return 'error'; } })()");
-    if (readyState != "complete" && readyState != "interactive") {
-        debug_output("Warning: Page not ready for screenshot (state: " + readyState + ")");
-    }
+    prepareForScreenshot();
     
     ScreenshotData data;
     data.filename = filename;
     data.loop = main_loop;
     data.success = false;
+    data.perceptual_hash = config_.screenshot_perceptual_hash;
+    data.store = getScreenshotStore();
+    data.previous = last_screenshot_;
+    data.buffer = nullptr;
+    data.raw = false;
     
     // Take visible area snapshot using WebKit API (completely offscreen)
     webkit_web_view_get_snapshot(
@@ -149,6 +345,7 @@ void Browser::takeScreenshot(const std::string& filename) {
     
     // Wait for screenshot completion
     g_main_loop_run(main_loop);
+    last_screenshot_ = data.info;
     
     if (!data.success) {
         std::cerr << "Visible area screenshot failed, trying full page as fallback..." << std::endl;
@@ -172,29 +369,7 @@ void Browser::takeFullPageScreenshot(const std::string& filename) {
         return;
     }
     
-    // Ensure proper offscreen viewport and rendering
-    ensureProperViewportForScreenshots();
-    
-    // Wait for rendering to complete using event-driven approach
-    if (async_nav_) {
-        auto future = async_nav_->waitForRenderingComplete(2000);
-        if (future.wait_for(std::chrono::milliseconds(2000)) != std::future_status::ready || !future.get()) {
-            // Fallback to readiness check or brief wait
-            if (readiness_tracker_ && readiness_tracker_->isFullyReady()) {
-                // Already ready, proceed
-            } else {
-                wait(250); // Reduced fallback wait
-            }
-        }
-    } else {
-        wait(250); // Reduced fallback wait
-    }
-    
-    // Check if page is ready
-    std::string readyState = executeJavascriptSync("(function() { try { return document.readyState; } catch(e) { return 'error'; } })()");
-    if (readyState != "complete" && readyState != "interactive") {
-        debug_output("Warning: Page not ready for screenshot (state: " + readyState + ")");
-    }
+    prepareForScreenshot();
     
     // Get page dimensions for debugging
     std::string pageDimensions = executeJavascriptSync(
@@ -211,6 +386,11 @@ void Browser::takeFullPageScreenshot(const std::string& filename) {
     data.filename = filename;
     data.loop = main_loop;
     data.success = false;
+    data.perceptual_hash = config_.screenshot_perceptual_hash;
+    data.store = getScreenshotStore();
+    data.previous = last_screenshot_;
+    data.buffer = nullptr;
+    data.raw = false;
     
     // Take full document snapshot using WebKit API (completely offscreen)
     webkit_web_view_get_snapshot(
@@ -224,8 +404,255 @@ void Browser::takeFullPageScreenshot(const std::string& filename) {
     
     // Wait for screenshot completion
     g_main_loop_run(main_loop);
+    last_screenshot_ = data.info;
     
     if (!data.success) {
         std::cerr << "Failed to take full page screenshot" << std::endl;
     }
 }
+
+bool Browser::captureScreenshotBuffer(ScreenshotBuffer& out, bool full_page, bool raw) {
+    debug_output(std::string("Starting in-memory ") + (full_page ? "full page" : "visible area") + " screenshot");
+    
+    prepareForScreenshot();
+    
+    ScreenshotInfo info;
+    bool success = snapshotToBuffer(out, full_page, raw, &info);
+    last_screenshot_ = info;
+    
+    if (!success) {
+        std::cerr << "Failed to capture screenshot to memory" << std::endl;
+    }
+    return success;
+}
+
+bool Browser::snapshotToBuffer(ScreenshotBuffer& out, bool full_page, bool raw, ScreenshotInfo* info) {
+    ScreenshotData data;
+    data.loop = main_loop;
+    data.success = false;
+    data.perceptual_hash = config_.screenshot_perceptual_hash;
+    data.store = nullptr;
+    data.buffer = &out;
+    data.raw = raw;
+    
+    // Same offscreen snapshot as the file variants, encoded straight into memory
+    webkit_web_view_get_snapshot(
+        webView, 
+        full_page ? WEBKIT_SNAPSHOT_REGION_FULL_DOCUMENT : WEBKIT_SNAPSHOT_REGION_VISIBLE,
+        WEBKIT_SNAPSHOT_OPTIONS_NONE, 
+        NULL,  // cancellable
+        screenshot_callback, 
+        &data
+    );
+    
+    // Wait for screenshot completion
+    g_main_loop_run(main_loop);
+    
+    if (info) {
+        *info = data.info;
+    }
+    if (!data.success) {
+        out.reset();
+    }
+    return data.success;
+}
+
+// ========== Burst Recording ==========
+
+int Browser::recordScreenshots(const ScreenshotRecordingOptions& options) {
+    debug_output("Starting screenshot recording into " + options.output_dir);
+    
+    if (!FileOps::PathUtils::isSecurePath(options.output_dir)) {
+        std::cerr << "Error: Cannot use recording directory: " + options.output_dir << std::endl;
+        return -1;
+    }
+    FileOps::DirectoryHandle output_dir(options.output_dir);
+    if (!output_dir.isOpen()) {
+        std::cerr << "Error: Cannot use recording directory: " + options.output_dir << std::endl;
+        return -1;
+    }
+    
+    // Viewport setup and the rendering wait are paid once for the whole burst
+    prepareForScreenshot();
+    
+    // Latest event trigger, set from event bus handlers and consumed by the capture loop
+    struct PendingTrigger {
+        std::mutex mutex;
+        std::string name;
+    };
+    auto pending = std::make_shared<PendingTrigger>();
+    std::vector<size_t> subscriptions;
+    
+    if (options.capture_on_events && event_bus_) {
+        static const std::vector<std::pair<BrowserEvents::EventType, const char*>> trigger_events = {
+            {BrowserEvents::EventType::NAVIGATION_STARTED, "navigation-started"},
+            {BrowserEvents::EventType::NAVIGATION_COMPLETED, "navigation-completed"},
+            {BrowserEvents::EventType::URL_CHANGED, "url-changed"},
+            {BrowserEvents::EventType::DOM_CONTENT_LOADED, "dom-content-loaded"},
+            {BrowserEvents::EventType::DOM_MUTATION, "dom-mutation"},
+            {BrowserEvents::EventType::SPA_NAVIGATION, "spa-navigation"},
+            {BrowserEvents::EventType::SPA_ROUTE_CHANGED, "spa-route-changed"},
+            {BrowserEvents::EventType::PAGE_LOAD_COMPLETE, "page-load-complete"},
+            {BrowserEvents::EventType::RENDERING_COMPLETE, "rendering-complete"}
+        };
+        
+        for (const auto& entry : trigger_events) {
+            std::string name = entry.second;
+            subscriptions.push_back(event_bus_->subscribe(entry.first,
+                [pending, name](const BrowserEvents::Event&) {
+                    std::lock_guard<std::mutex> lock(pending->mutex);
+                    pending->name = name;
+                }));
+        }
+    }
+    
+    FrameRing ring(options.max_frames);
+    auto start = std::chrono::steady_clock::now();
+    auto deadline = start + std::chrono::milliseconds(options.duration_ms);
+    auto next_tick = start;
+    
+    while (std::chrono::steady_clock::now() < deadline) {
+        auto now = std::chrono::steady_clock::now();
+        std::string trigger;
+        
+        if (options.interval_ms > 0 && now >= next_tick) {
+            trigger = "interval";
+            next_tick += std::chrono::milliseconds(options.interval_ms);
+            if (next_tick < now) {
+                // Capture is slower than the interval; don't queue up a backlog
+                next_tick = now + std::chrono::milliseconds(options.interval_ms);
+            }
+        } else {
+            std::lock_guard<std::mutex> lock(pending->mutex);
+            trigger.swap(pending->name);
+        }
+        
+        if (trigger.empty()) {
+            // Let WebKit make progress until the next tick or event
+            while (g_main_context_pending(NULL)) {
+                g_main_context_iteration(NULL, FALSE);
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+            continue;
+        }
+        
+        RecordedFrame frame;
+        frame.trigger = trigger;
+        frame.timestamp_ms = std::chrono::duration_cast<std::chrono::milliseconds>(now - start).count();
+        
+        // Keep raw pixels; PNG encoding is deferred until the recording ends
+        if (snapshotToBuffer(frame.pixels, options.full_page, true, nullptr)) {
+            ring.push(std::move(frame), options.skip_duplicates);
+        }
+    }
+    
+    for (size_t id : subscriptions) {
+        event_bus_->unsubscribe(id);
+    }
+    
+    // Encode the recorded frames as a numbered image sequence plus a manifest
+    Json::Value manifest;
+    manifest["interval_ms"] = options.interval_ms;
+    manifest["duration_ms"] = options.duration_ms;
+    manifest["dropped"] = static_cast<Json::UInt64>(ring.dropped());
+    manifest["frames"] = Json::Value(Json::arrayValue);
+    
+    int written = 0;
+    for (size_t i = 0; i < ring.size(); ++i) {
+        RecordedFrame& frame = ring.at(i);
+        
+        char suffix[32];
+        snprintf(suffix, sizeof(suffix), "-%04zu.png", i + 1);
+        std::string name = options.prefix + suffix;
+        
+        if (!write_png_at(output_dir, name, frame.pixels.data(), frame.pixels.width,
+                          frame.pixels.height, frame.pixels.stride)) {
+            continue;
+        }
+        written++;
+        
+        Json::Value entry;
+        entry["file"] = FileOps::PathUtils::joinPaths({options.output_dir, name});
+        entry["t_ms"] = static_cast<Json::Int64>(frame.timestamp_ms);
+        entry["trigger"] = frame.trigger;
+        entry["hash"] = frame.pixels.hash;
+        entry["repeats"] = frame.repeats;
+        manifest["frames"].append(entry);
+        
+        // Release each frame as soon as it's encoded
+        frame.pixels.reset();
+    }
+    
+    Json::StreamWriterBuilder builder;
+    std::string manifest_json = Json::writeString(builder, manifest) + "\n";
+    if (!output_dir.writeFile(options.prefix + ".json", manifest_json.data(), manifest_json.size())) {
+        std::cerr << "Failed to write recording manifest: " + output_dir.pathFor(options.prefix + ".json") << std::endl;
+    }
+    
+    debug_output("Screenshot recording finished: " + std::to_string(written) + " frames, " +
+                 std::to_string(ring.dropped()) + " dropped");
+    return written;
+}
+
+// ========== Viewport Sweep ==========
+
+int Browser::captureViewportSweep(const ScreenshotSweepOptions& options) {
+    debug_output("Starting viewport sweep into " + options.output_dir);
+    
+    if (options.viewports.empty()) {
+        std::cerr << "Error: No viewports given for screenshot sweep" << std::endl;
+        return -1;
+    }
+    if (!FileOps::PathUtils::isSecurePath(options.output_dir)) {
+        std::cerr << "Error: Cannot use sweep directory: " + options.output_dir << std::endl;
+        return -1;
+    }
+    FileOps::DirectoryHandle output_dir(options.output_dir);
+    if (!output_dir.isOpen()) {
+        std::cerr << "Error: Cannot use sweep directory: " + options.output_dir << std::endl;
+        return -1;
+    }
+    
+    auto original_viewport = getViewport();
+    
+    // WebKit renders on this thread, so the page is resized and captured serially
+    // on the one loaded DOM; PNG encoding of each frame overlaps the next relayout
+    size_t max_encoders = std::max(1u, std::thread::hardware_concurrency());
+    std::deque<std::future<bool>> encoders;
+    int written = 0;
+    
+    for (const auto& viewport : options.viewports) {
+        setViewport(viewport.first, viewport.second);
+        prepareForScreenshot();
+        
+        ScreenshotBuffer frame;
+        ScreenshotInfo info;
+        if (!snapshotToBuffer(frame, options.full_page, true, &info)) {
+            std::cerr << "Failed to capture viewport " << viewport.first << "x" << viewport.second << std::endl;
+            continue;
+        }
+        
+        std::string name = options.prefix + "-" + std::to_string(viewport.first) + "x" +
+                           std::to_string(viewport.second) + ".png";
+        
+        if (encoders.size() >= max_encoders) {
+            written += encoders.front().get() ? 1 : 0;
+            encoders.pop_front();
+        }
+        encoders.push_back(std::async(std::launch::async,
+            [frame = std::move(frame), name, &output_dir]() mutable {
+                return write_png_at(output_dir, name, frame.data(), frame.width, frame.height, frame.stride);
+            }));
+    }
+    
+    for (auto& encoder : encoders) {
+        written += encoder.get() ? 1 : 0;
+    }
+    
+    // Leave the page at the size it had before the sweep
+    setViewport(original_viewport.first, original_viewport.second);
+    
+    debug_output("Viewport sweep finished: " + std::to_string(written) + " of " +
+                 std::to_string(options.viewports.size()) + " images written");
+    return written;
+}
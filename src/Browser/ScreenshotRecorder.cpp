@@ -0,0 +1,86 @@
+#include "ScreenshotRecorder.h"
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+
+FrameRing::FrameRing(size_t capacity) : slots_(capacity > 0 ? capacity : 1) {
+}
+
+bool FrameRing::push(RecordedFrame&& frame, bool coalesce_duplicates) {
+    if (coalesce_duplicates && count_ > 0) {
+        RecordedFrame& newest = at(count_ - 1);
+        if (!newest.pixels.hash.empty() && newest.pixels.hash == frame.pixels.hash) {
+            newest.repeats += frame.repeats;
+            return false;
+        }
+    }
+
+    size_t slot = (head_ + count_) % slots_.size();
+    if (count_ == slots_.size()) {
+        // Full: overwrite the oldest frame
+        head_ = (head_ + 1) % slots_.size();
+        dropped_++;
+    } else {
+        count_++;
+    }
+    slots_[slot] = std::move(frame);
+    return true;
+}
+
+RecordedFrame& FrameRing::at(size_t index) {
+    if (index >= count_) {
+        throw std::out_of_range("FrameRing index out of range");
+    }
+    return slots_[(head_ + index) % slots_.size()];
+}
+
+const RecordedFrame& FrameRing::at(size_t index) const {
+    if (index >= count_) {
+        throw std::out_of_range("FrameRing index out of range");
+    }
+    return slots_[(head_ + index) % slots_.size()];
+}
+
+void FrameRing::clear() {
+    for (auto& slot : slots_) {
+        slot = RecordedFrame();
+    }
+    head_ = 0;
+    count_ = 0;
+    dropped_ = 0;
+}
+
+std::vector<std::pair<int, int>> parseViewportList(const std::string& spec, int default_height) {
+    std::vector<std::pair<int, int>> viewports;
+    std::stringstream stream(spec);
+    std::string entry;
+
+    while (std::getline(stream, entry, ',')) {
+        size_t x = entry.find('x');
+        int width = 0;
+        int height = default_height;
+        try {
+            size_t used = 0;
+            width = std::stoi(entry.substr(0, x), &used);
+            if (used != (x == std::string::npos ? entry.size() : x)) {
+                return {};
+            }
+            if (x != std::string::npos) {
+                height = std::stoi(entry.substr(x + 1), &used);
+                if (used != entry.size() - x - 1) {
+                    return {};
+                }
+            }
+        } catch (const std::exception&) {
+            return {};
+        }
+        if (width <= 0 || height <= 0) {
+            return {};
+        }
+        // Repeated sizes would encode the same file twice; keep the first
+        if (std::find(viewports.begin(), viewports.end(), std::make_pair(width, height)) == viewports.end()) {
+            viewports.emplace_back(width, height);
+        }
+    }
+    return viewports;
+}
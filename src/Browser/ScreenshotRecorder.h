@@ -0,0 +1,65 @@
+#pragma once
+
+#include "ScreenshotStore.h"
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Options for a burst/recording capture session
+struct ScreenshotRecordingOptions {
+    std::string output_dir = "frames";
+    std::string prefix = "frame";
+    int duration_ms = 5000;
+    int interval_ms = 100;             // 0 = capture only on events
+    bool capture_on_events = false;    // also capture on navigation/DOM events
+    bool full_page = false;
+    bool skip_duplicates = true;       // coalesce consecutive identical frames
+    size_t max_frames = 60;            // ring capacity; oldest frames are dropped
+};
+
+// One captured frame held as raw ARGB32 pixels until the recording ends
+struct RecordedFrame {
+    ScreenshotBuffer pixels;
+    long long timestamp_ms = 0;        // relative to the start of the recording
+    std::string trigger;               // "interval" or the event that caused it
+    int repeats = 1;                   // identical captures coalesced into this frame
+};
+
+// Fixed-capacity ring of recorded frames; encoding is deferred until drained
+class FrameRing {
+public:
+    explicit FrameRing(size_t capacity);
+
+    // Returns false when the frame was coalesced into the newest one
+    bool push(RecordedFrame&& frame, bool coalesce_duplicates);
+
+    size_t size() const { return count_; }
+    size_t capacity() const { return slots_.size(); }
+    size_t dropped() const { return dropped_; }
+
+    // Frames in capture order, oldest first
+    RecordedFrame& at(size_t index);
+    const RecordedFrame& at(size_t index) const;
+
+    void clear();
+
+private:
+    std::vector<RecordedFrame> slots_;
+    size_t head_ = 0;     // index of the oldest frame
+    size_t count_ = 0;
+    size_t dropped_ = 0;
+};
+
+// Options for capturing one loaded page at several viewport sizes
+struct ScreenshotSweepOptions {
+    std::string output_dir = "viewports";
+    std::string prefix = "viewport";
+    std::vector<std::pair<int, int>> viewports;   // width x height
+    bool full_page = false;
+};
+
+// Parse "375,768x1024,1280" into sizes; entries without a height use
+// default_height. Repeated sizes are kept once, in first-seen order.
+// Returns an empty list if any entry is malformed.
+std::vector<std::pair<int, int>> parseViewportList(const std::string& spec, int default_height);
@@ -0,0 +1,255 @@
+#include "ScreenshotStore.h"
+#include <cstring>
+#include <filesystem>
+#include <unistd.h>
+
+namespace {
+
+constexpr uint64_t PRIME64_1 = 0x9E3779B185EBCA87ULL;
+constexpr uint64_t PRIME64_2 = 0xC2B2AE3D27D4EB4FULL;
+constexpr uint64_t PRIME64_3 = 0x165667B19E3779F9ULL;
+constexpr uint64_t PRIME64_4 = 0x85EBCA77C2B2AE63ULL;
+constexpr uint64_t PRIME64_5 = 0x27D4EB2F165667C5ULL;
+
+inline uint64_t rotl64(uint64_t x, int r) {
+    return (x << r) | (x >> (64 - r));
+}
+
+inline uint64_t read64(const unsigned char* p) {
+    uint64_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+inline uint32_t read32(const unsigned char* p) {
+    uint32_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+inline uint64_t xxhRound(uint64_t acc, uint64_t input) {
+    acc += input * PRIME64_2;
+    acc = rotl64(acc, 31);
+    return acc * PRIME64_1;
+}
+
+inline uint64_t xxhMergeRound(uint64_t acc, uint64_t val) {
+    acc ^= xxhRound(0, val);
+    return acc * PRIME64_1 + PRIME64_4;
+}
+
+// Luminance of one ARGB32 pixel (stored as B, G, R, A in memory on little-endian)
+inline unsigned int luma(const unsigned char* px) {
+    return (px[2] * 77u + px[1] * 150u + px[0] * 29u) >> 8;
+}
+
+} // namespace
+
+ScreenshotStore::ScreenshotStore(const std::string& root_dir) : root_dir_(root_dir) {
+}
+
+// ========== Pixel Hashing ==========
+
+uint64_t ScreenshotStore::xxh64(const void* data, size_t length, uint64_t seed) {
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    const unsigned char* const end = p + length;
+    uint64_t h;
+
+    if (length >= 32) {
+        const unsigned char* const limit = end - 32;
+        uint64_t v1 = seed + PRIME64_1 + PRIME64_2;
+        uint64_t v2 = seed + PRIME64_2;
+        uint64_t v3 = seed;
+        uint64_t v4 = seed - PRIME64_1;
+
+        do {
+            v1 = xxhRound(v1, read64(p)); p += 8;
+            v2 = xxhRound(v2, read64(p)); p += 8;
+            v3 = xxhRound(v3, read64(p)); p += 8;
+            v4 = xxhRound(v4, read64(p)); p += 8;
+        } while (p <= limit);
+
+        h = rotl64(v1, 1) + rotl64(v2, 7) + rotl64(v3, 12) + rotl64(v4, 18);
+        h = xxhMergeRound(h, v1);
+        h = xxhMergeRound(h, v2);
+        h = xxhMergeRound(h, v3);
+        h = xxhMergeRound(h, v4);
+    } else {
+        h = seed + PRIME64_5;
+    }
+
+    h += static_cast<uint64_t>(length);
+
+    while (p + 8 <= end) {
+        h ^= xxhRound(0, read64(p));
+        h = rotl64(h, 27) * PRIME64_1 + PRIME64_4;
+        p += 8;
+    }
+    if (p + 4 <= end) {
+        h ^= static_cast<uint64_t>(read32(p)) * PRIME64_1;
+        h = rotl64(h, 23) * PRIME64_2 + PRIME64_3;
+        p += 4;
+    }
+    while (p < end) {
+        h ^= (*p) * PRIME64_5;
+        h = rotl64(h, 11) * PRIME64_1;
+        p++;
+    }
+
+    h ^= h >> 33;
+    h *= PRIME64_2;
+    h ^= h >> 29;
+    h *= PRIME64_3;
+    h ^= h >> 32;
+    return h;
+}
+
+uint64_t ScreenshotStore::hashPixels(const unsigned char* pixels, int width, int height, size_t stride) {
+    if (!pixels || width <= 0 || height <= 0) {
+        return 0;
+    }
+
+    uint64_t seed = (static_cast<uint64_t>(width) << 32) | static_cast<uint32_t>(height);
+    size_t row_bytes = static_cast<size_t>(width) * 4;
+
+    // ARGB32 rows are normally tightly packed; hash the whole buffer in one pass
+    if (stride == row_bytes) {
+        return xxh64(pixels, row_bytes * height, seed);
+    }
+
+    // Otherwise chain row hashes so stride padding never affects the result
+    uint64_t h = seed;
+    for (int y = 0; y < height; ++y) {
+        h = xxh64(pixels + y * stride, row_bytes, h);
+    }
+    return h;
+}
+
+uint64_t ScreenshotStore::perceptualHash(const unsigned char* pixels, int width, int height, size_t stride) {
+    if (!pixels || width <= 0 || height <= 0) {
+        return 0;
+    }
+
+    // Average luminance of each cell in an 8x8 grid, sampled on a sparse lattice
+    const int grid = 8;
+    const int samples = 8;
+    unsigned int cells[grid * grid];
+    unsigned long long total = 0;
+
+    for (int gy = 0; gy < grid; ++gy) {
+        for (int gx = 0; gx < grid; ++gx) {
+            unsigned int sum = 0;
+            for (int sy = 0; sy < samples; ++sy) {
+                int y = static_cast<int>((static_cast<long long>(gy * samples + sy) * height) / (grid * samples));
+                const unsigned char* row = pixels + y * stride;
+                for (int sx = 0; sx < samples; ++sx) {
+                    int x = static_cast<int>((static_cast<long long>(gx * samples + sx) * width) / (grid * samples));
+                    sum += luma(row + x * 4);
+                }
+            }
+            cells[gy * grid + gx] = sum / (samples * samples);
+            total += cells[gy * grid + gx];
+        }
+    }
+
+    unsigned int mean = static_cast<unsigned int>(total / (grid * grid));
+    uint64_t bits = 0;
+    for (int i = 0; i < grid * grid; ++i) {
+        if (cells[i] >= mean) {
+            bits |= (1ULL << i);
+        }
+    }
+    return bits;
+}
+
+int ScreenshotStore::hammingDistance(uint64_t a, uint64_t b) {
+    uint64_t diff = a ^ b;
+    int count = 0;
+    while (diff) {
+        diff &= diff - 1;
+        count++;
+    }
+    return count;
+}
+
+std::string ScreenshotStore::toHex(uint64_t value) {
+    static const char digits[] = "0123456789abcdef";
+    std::string hex(16, '0');
+    for (int i = 15; i >= 0; --i) {
+        hex[i] = digits[value & 0xF];
+        value >>= 4;
+    }
+    return hex;
+}
+
+// ========== Store Operations ==========
+
+std::string ScreenshotStore::blobPath(const std::string& hash) const {
+    std::string shard = hash.size() >= 2 ? hash.substr(0, 2) : "00";
+    return (std::filesystem::path(root_dir_) / shard / (hash + ".png")).string();
+}
+
+bool ScreenshotStore::contains(const std::string& hash) const {
+    std::error_code ec;
+    return !hash.empty() && std::filesystem::is_regular_file(blobPath(hash), ec);
+}
+
+bool ScreenshotStore::materialize(const std::string& hash, const std::string& destination) const {
+    if (!contains(hash)) {
+        return false;
+    }
+    return linkOrCopy(blobPath(hash), destination);
+}
+
+bool ScreenshotStore::ingest(const std::string& hash, const std::string& source) const {
+    if (hash.empty() || contains(hash)) {
+        return !hash.empty();
+    }
+
+    std::error_code ec;
+    std::filesystem::path blob(blobPath(hash));
+    std::filesystem::create_directories(blob.parent_path(), ec);
+    if (ec) {
+        return false;
+    }
+    return linkOrCopy(source, blob.string());
+}
+
+bool ScreenshotStore::linkOrCopy(const std::string& source, const std::string& destination) {
+    std::error_code ec;
+
+    if (std::filesystem::exists(destination, ec)) {
+        if (std::filesystem::equivalent(source, destination, ec)) {
+            return true;
+        }
+        std::filesystem::remove(destination, ec);
+    }
+
+    std::filesystem::create_hard_link(source, destination, ec);
+    if (!ec) {
+        return true;
+    }
+
+    // Hard links fail across filesystems; fall back to a plain copy
+    ec.clear();
+    std::filesystem::copy_file(source, destination,
+                               std::filesystem::copy_options::overwrite_existing, ec);
+    return !ec;
+}
+
+bool ScreenshotStore::replaceFile(const std::string& destination,
+                                  const std::function<bool(const std::string& temp_path)>& writer) {
+    std::string temp_path = destination + ".tmp-" + std::to_string(getpid());
+    std::error_code ec;
+
+    if (!writer(temp_path)) {
+        std::filesystem::remove(temp_path, ec);
+        return false;
+    }
+    std::filesystem::rename(temp_path, destination, ec);
+    if (ec) {
+        std::filesystem::remove(temp_path, ec);
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <utility>
+
+// Metadata describing the most recent screenshot taken by a Browser
+struct ScreenshotInfo {
+    std::string filename;
+    std::string hash;              // xxh64 of the raw ARGB32 pixels (16 hex chars)
+    std::string perceptual_hash;   // 8x8 average hash, empty unless enabled
+    int width = 0;
+    int height = 0;
+    bool deduplicated = false;     // true when PNG encoding was skipped
+    bool success = false;
+};
+
+// Owned screenshot bytes (PNG or raw ARGB32) captured without a temp file.
+// release() transfers ownership so bindings can wrap the memory zero-copy.
+class ScreenshotBuffer {
+public:
+    using Deleter = void (*)(void*);
+
+    ScreenshotBuffer() = default;
+    ~ScreenshotBuffer() { reset(); }
+
+    ScreenshotBuffer(const ScreenshotBuffer&) = delete;
+    ScreenshotBuffer& operator=(const ScreenshotBuffer&) = delete;
+
+    ScreenshotBuffer(ScreenshotBuffer&& other) noexcept { *this = std::move(other); }
+    ScreenshotBuffer& operator=(ScreenshotBuffer&& other) noexcept {
+        if (this != &other) {
+            reset(other.data_, other.size_, other.deleter_);
+            width = other.width;
+            height = other.height;
+            stride = other.stride;
+            raw = other.raw;
+            hash = std::move(other.hash);
+            other.data_ = nullptr;
+            other.size_ = 0;
+            other.deleter_ = nullptr;
+        }
+        return *this;
+    }
+
+    void reset(unsigned char* data = nullptr, size_t size = 0, Deleter deleter = nullptr) {
+        if (data_ && deleter_) {
+            deleter_(data_);
+        }
+        data_ = data;
+        size_ = size;
+        deleter_ = deleter;
+    }
+
+    // Caller takes ownership and must free the memory with deleter()
+    unsigned char* release() {
+        unsigned char* data = data_;
+        data_ = nullptr;
+        size_ = 0;
+        return data;
+    }
+
+    unsigned char* data() const { return data_; }
+    size_t size() const { return size_; }
+    Deleter deleter() const { return deleter_; }
+    bool empty() const { return data_ == nullptr || size_ == 0; }
+
+    int width = 0;
+    int height = 0;
+    size_t stride = 0;   // row stride for raw buffers, 0 for PNG
+    bool raw = false;
+    std::string hash;
+
+private:
+    unsigned char* data_ = nullptr;
+    size_t size_ = 0;
+    Deleter deleter_ = nullptr;
+};
+
+// Content-addressed store for encoded screenshots.
+// Frames are keyed by the hash of their raw pixels so identical captures
+// can be hard-linked instead of being re-encoded and re-written.
+class ScreenshotStore {
+public:
+    explicit ScreenshotStore(const std::string& root_dir);
+
+    // ========== Pixel Hashing ==========
+
+    // XXH64 of a contiguous byte range
+    static uint64_t xxh64(const void* data, size_t length, uint64_t seed = 0);
+
+    // Hash of an ARGB32 pixel buffer; dimensions are folded into the seed
+    static uint64_t hashPixels(const unsigned char* pixels, int width, int height, size_t stride);
+
+    // 64-bit average hash (8x8 luminance grid) for near-duplicate detection
+    static uint64_t perceptualHash(const unsigned char* pixels, int width, int height, size_t stride);
+
+    static int hammingDistance(uint64_t a, uint64_t b);
+    static std::string toHex(uint64_t value);
+
+    // ========== Store Operations ==========
+
+    // Path of the stored PNG for a hash: <root>/<first two hex chars>/<hash>.png
+    std::string blobPath(const std::string& hash) const;
+    bool contains(const std::string& hash) const;
+
+    // Place the stored PNG for hash at destination (hard link, copy fallback)
+    bool materialize(const std::string& hash, const std::string& destination) const;
+
+    // Record an already-encoded PNG under its hash (hard link, copy fallback)
+    bool ingest(const std::string& hash, const std::string& source) const;
+
+    const std::string& root() const { return root_dir_; }
+
+    // Replace destination with a hard link to source, copying across filesystems
+    static bool linkOrCopy(const std::string& source, const std::string& destination);
+
+    // Have writer fill a temporary sibling of destination, then rename it
+    // over destination. Captures share inodes with the store and with each
+    // other, so a new capture must replace the name, never truncate the file.
+    static bool replaceFile(const std::string& destination,
+                            const std::function<bool(const std::string& temp_path)>& writer);
+
+private:
+    std::string root_dir_;
+};
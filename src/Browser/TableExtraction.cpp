@@ -0,0 +1,152 @@
+#include "TableExtraction.h"
+#include <cctype>
+
+namespace {
+
+bool isAttributeName(const std::string& name) {
+    if (name.empty()) {
+        return false;
+    }
+    for (char c : name) {
+        if (!std::isalnum(static_cast<unsigned char>(c)) && c != '-' && c != '_' && c != ':' && c != '.') {
+            return false;
+        }
+    }
+    return true;
+}
+
+// "td.price" -> text, "a@href" -> attribute, "@data-id" -> attribute of the row
+void splitFieldString(const std::string& text, TableField& field) {
+    size_t at = text.rfind('@');
+    if (at != std::string::npos && isAttributeName(text.substr(at + 1))) {
+        field.selector = text.substr(0, at);
+        field.attribute = text.substr(at + 1);
+    } else {
+        field.selector = text;
+    }
+}
+
+bool parseField(const std::string& name, const Json::Value& value, TableField& field, std::string& error) {
+    field.name = name;
+    if (value.isString()) {
+        splitFieldString(value.asString(), field);
+        return true;
+    }
+    if (value.isObject()) {
+        field.selector = value.get("selector", "").asString();
+        field.attribute = value.get("attr", "").asString();
+        return true;
+    }
+    error = "field '" + name + "' must be a selector string or an object";
+    return false;
+}
+
+std::string csvCell(const std::string& value) {
+    if (value.find_first_of(",\"\r\n") == std::string::npos) {
+        return value;
+    }
+    std::string quoted = "\"";
+    for (char c : value) {
+        if (c == '"') {
+            quoted += '"';
+        }
+        quoted += c;
+    }
+    return quoted + "\"";
+}
+
+} // namespace
+
+bool parseTableSpec(const std::string& text, TableSpec& spec, std::string& error) {
+    Json::Value root;
+    Json::Reader reader;
+    if (!reader.parse(text, root) || !root.isObject()) {
+        error = "spec is not a JSON object";
+        return false;
+    }
+
+    spec = TableSpec();
+    spec.row_selector = root.get("rows", "").asString();
+    if (spec.row_selector.empty()) {
+        error = "spec needs a \"rows\" selector";
+        return false;
+    }
+
+    const Json::Value& fields = root["fields"];
+    if (fields.isArray()) {
+        for (const auto& item : fields) {
+            if (!item.isObject() || item.get("name", "").asString().empty()) {
+                error = "array fields need a \"name\"";
+                return false;
+            }
+            TableField field;
+            if (!parseField(item["name"].asString(), item, field, error)) {
+                return false;
+            }
+            spec.fields.push_back(field);
+        }
+    } else if (fields.isObject()) {
+        for (const auto& name : fields.getMemberNames()) {
+            TableField field;
+            if (!parseField(name, fields[name], field, error)) {
+                return false;
+            }
+            spec.fields.push_back(field);
+        }
+    }
+
+    if (spec.fields.empty()) {
+        error = "spec needs at least one field";
+        return false;
+    }
+    return true;
+}
+
+std::string tableSpecToJson(const TableSpec& spec) {
+    Json::Value root;
+    root["rows"] = spec.row_selector;
+    root["fields"] = Json::Value(Json::arrayValue);
+    for (const auto& field : spec.fields) {
+        Json::Value item;
+        item["selector"] = field.selector;
+        item["attr"] = field.attribute;
+        root["fields"].append(item);
+    }
+
+    Json::StreamWriterBuilder builder;
+    builder["indentation"] = "";
+    return Json::writeString(builder, root);
+}
+
+std::string formatTableRow(const TableSpec& spec, const Json::Value& cells, TableFormat format) {
+    if (format == TableFormat::CSV) {
+        std::string line;
+        for (Json::ArrayIndex i = 0; i < spec.fields.size(); ++i) {
+            if (i > 0) {
+                line += ',';
+            }
+            const Json::Value& cell = cells.isArray() ? cells[i] : Json::Value();
+            line += cell.isString() ? csvCell(cell.asString()) : "";
+        }
+        return line;
+    }
+
+    Json::Value record(Json::objectValue);
+    for (Json::ArrayIndex i = 0; i < spec.fields.size(); ++i) {
+        record[spec.fields[i].name] = cells.isArray() ? cells[i] : Json::Value();
+    }
+    Json::StreamWriterBuilder builder;
+    builder["indentation"] = "";
+    return Json::writeString(builder, record);
+}
+
+std::string formatTableHeader(const TableSpec& spec) {
+    std::string line;
+    for (size_t i = 0; i < spec.fields.size(); ++i) {
+        if (i > 0) {
+            line += ',';
+        }
+        line += csvCell(spec.fields[i].name);
+    }
+    return line;
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <json/json.h>
+#include <string>
+#include <vector>
+
+// One output column: text (or an attribute) of the first match of
+// `selector` inside each row. An empty selector addresses the row itself.
+struct TableField {
+    std::string name;
+    std::string selector;
+    std::string attribute;   // empty = normalized text content
+};
+
+// Declarative table extraction: one row per match of row_selector
+struct TableSpec {
+    std::string row_selector;
+    std::vector<TableField> fields;
+};
+
+enum class TableFormat {
+    NDJSON,
+    CSV
+};
+
+// Parse {"rows": "<selector>", "fields": ...}. Fields are either an array of
+// {"name", "selector", "attr"} objects (column order kept) or an object of
+// name -> "selector[@attr]" / {"selector", "attr"} (columns sorted by name).
+// Returns false and sets error if the spec is malformed.
+bool parseTableSpec(const std::string& text, TableSpec& spec, std::string& error);
+
+// Compact JSON handed to the page runtime
+std::string tableSpecToJson(const TableSpec& spec);
+
+// One output line (without newline) for a row of cell values; null cells
+// are missing elements
+std::string formatTableRow(const TableSpec& spec, const Json::Value& cells, TableFormat format);
+
+// CSV header line (without newline)
+std::string formatTableHeader(const TableSpec& spec);
@@ -0,0 +1,102 @@
+#include "Browser.h"
+#include <set>
+
+// External debug flag
+extern bool g_debug;
+
+// Uploads are reported by the page itself: the runtime's uploadWatch hooks
+// announce each file-carrying request and its progress through the
+// hwebUpload message handler, so nothing polls the page for state.
+
+// ========== Watching ==========
+
+bool Browser::watchUploads() {
+    if (upload_message_signal_id == 0) {
+        debug_output("watchUploads: hwebUpload handler not registered");
+        return false;
+    }
+    if (upload_token_.empty()) {
+        upload_token_ = newTransferToken();
+    }
+    return callPageRuntime("uploadWatch", {upload_token_}) == "WATCHING";
+}
+
+std::vector<UploadTransfer> Browser::getUploads() const {
+    return uploads_;
+}
+
+void Browser::notifyUploadMessage(const char* payload, size_t length) {
+    if (!is_valid.load()) {
+        return;
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    UploadTransfer* transfer = applyUploadMessage(uploads_, std::string(payload, length), now, upload_token_);
+    if (!transfer) {
+        debug_output("Malformed or unauthenticated upload report ignored");
+        return;
+    }
+    last_upload_report_ = now;
+
+    if (transfer->done()) {
+        debug_output("Upload " + std::string(transfer->state == UploadTransfer::State::FINISHED ? "finished: " : "failed: ") +
+                     transfer->url + " (" + std::to_string(transfer->sent_bytes) + " bytes, HTTP " +
+                     std::to_string(transfer->http_status) + ")");
+    }
+}
+
+// ========== Waiting ==========
+
+bool Browser::waitForUploads(const std::vector<std::string>& filenames, size_t first, int quiet_ms, int timeout_ms) {
+    bool timed_out = false;
+    guint timeout_id = g_timeout_add(timeout_ms, [](gpointer user_data) -> gboolean {
+        *static_cast<bool*>(user_data) = true;
+        return G_SOURCE_REMOVE;
+    }, &timed_out);
+
+    // Re-armed whenever the page goes quiet, so the loop wakes when quiet_ms is up
+    guint quiet_id = 0;
+    auto since = std::chrono::steady_clock::now();
+    auto quiet = std::chrono::milliseconds(quiet_ms);
+
+    bool carried = false;
+    while (!timed_out) {
+        std::set<std::string> pending(filenames.begin(), filenames.end());
+        bool in_flight = false;
+        for (size_t i = first; i < uploads_.size(); ++i) {
+            if (!uploads_[i].done()) {
+                in_flight = true;
+                continue;
+            }
+            for (const auto& name : uploads_[i].files) {
+                pending.erase(name);
+            }
+        }
+        if (pending.empty()) {
+            carried = true;
+            break;
+        }
+
+        if (!in_flight && quiet_id == 0) {
+            auto idle = std::chrono::steady_clock::now() - std::max(since, last_upload_report_);
+            if (idle >= quiet) {
+                break;
+            }
+            auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(quiet - idle).count();
+            quiet_id = g_timeout_add(static_cast<guint>(remaining) + 1, [](gpointer user_data) -> gboolean {
+                *static_cast<guint*>(user_data) = 0;
+                return G_SOURCE_REMOVE;
+            }, &quiet_id);
+        }
+
+        g_main_context_iteration(g_main_context_default(), TRUE);
+    }
+
+    if (quiet_id != 0) {
+        g_source_remove(quiet_id);
+    }
+    if (!timed_out) {
+        g_source_remove(timeout_id);
+    }
+    return carried;
+}
@@ -0,0 +1,113 @@
+#include "Uploads.h"
+#include <algorithm>
+#include <json/json.h>
+#include <memory>
+
+bool UploadTransfer::carries(const std::string& filename) const {
+    return std::find(files.begin(), files.end(), filename) != files.end();
+}
+
+int64_t UploadTransfer::elapsedMs() const {
+    auto end = done() ? ended : last_report;
+    return std::chrono::duration_cast<std::chrono::milliseconds>(end - started).count();
+}
+
+double UploadTransfer::throughput() const {
+    int64_t ms = elapsedMs();
+    return ms > 0 ? static_cast<double>(sent_bytes) * 1000.0 / static_cast<double>(ms) : 0.0;
+}
+
+UploadTransfer* applyUploadMessage(std::vector<UploadTransfer>& transfers, const std::string& message,
+                                   std::chrono::steady_clock::time_point now, const std::string& token) {
+    Json::Value report;
+    Json::CharReaderBuilder builder;
+    std::unique_ptr<Json::CharReader> reader(builder.newCharReader());
+    std::string errors;
+    if (!reader->parse(message.data(), message.data() + message.size(), &report, &errors) ||
+        !report.isObject() || !report["id"].isString() || report["id"].asString().empty()) {
+        return nullptr;
+    }
+    if (!token.empty() && report["token"].asString() != token) {
+        return nullptr;
+    }
+
+    std::string id = report["id"].asString();
+    auto it = std::find_if(transfers.rbegin(), transfers.rend(),
+                           [&](const UploadTransfer& transfer) { return transfer.id == id; });
+    UploadTransfer* transfer = nullptr;
+    if (it != transfers.rend()) {
+        transfer = &*it;
+    } else {
+        UploadTransfer added;
+        added.id = id;
+        added.url = report["url"].asString();
+        for (const auto& name : report["files"]) {
+            added.files.push_back(name.asString());
+        }
+        added.started = now;
+        added.last_report = now;
+        transfers.push_back(added);
+        transfer = &transfers.back();
+    }
+
+    if (transfer->done()) {
+        return transfer;
+    }
+
+    auto stall = std::chrono::duration_cast<std::chrono::milliseconds>(now - transfer->last_report).count();
+    transfer->longest_stall_ms = std::max<int64_t>(transfer->longest_stall_ms, stall);
+    transfer->last_report = now;
+
+    if (report["sent"].isNumeric()) {
+        transfer->sent_bytes = std::max<uint64_t>(transfer->sent_bytes, report["sent"].asUInt64());
+    }
+    if (report["total"].isNumeric() && report["total"].asUInt64() > 0) {
+        transfer->total_bytes = report["total"].asUInt64();
+    }
+    if (report["status"].isNumeric()) {
+        transfer->http_status = report["status"].asInt();
+    }
+
+    std::string state = report["state"].asString();
+    if (state == "done" || state == "failed") {
+        transfer->state = state == "done" ? UploadTransfer::State::FINISHED : UploadTransfer::State::FAILED;
+        transfer->ended = now;
+        if (state == "done") {
+            transfer->sent_bytes = std::max(transfer->sent_bytes, transfer->total_bytes);
+        }
+    }
+    return transfer;
+}
+
+std::vector<long> matchUploadTransfers(const std::vector<UploadTransfer>& transfers, size_t first,
+                                       const std::vector<std::string>& names) {
+    std::vector<long> matched(names.size(), -1);
+    std::vector<bool> done(names.size(), false);
+    for (size_t i = 0; i < names.size(); ++i) {
+        if (done[i]) {
+            continue;
+        }
+        // Every file of this name, in selection order
+        std::vector<size_t> files;
+        for (size_t j = i; j < names.size(); ++j) {
+            if (names[j] == names[i]) {
+                files.push_back(j);
+                done[j] = true;
+            }
+        }
+        // Every time a transfer carried the name, oldest first
+        std::vector<long> carried;
+        for (size_t t = first; t < transfers.size(); ++t) {
+            for (const auto& name : transfers[t].files) {
+                if (name == names[i]) {
+                    carried.push_back(static_cast<long>(t));
+                }
+            }
+        }
+        size_t skip = carried.size() > files.size() ? carried.size() - files.size() : 0;
+        for (size_t k = 0; k < files.size() && skip + k < carried.size(); ++k) {
+            matched[files[k]] = carried[skip + k];
+        }
+    }
+    return matched;
+}
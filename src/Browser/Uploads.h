@@ -0,0 +1,51 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// One request carrying files (XMLHttpRequest or fetch) sent by the page,
+// as reported through the hwebUpload script message handler
+struct UploadTransfer {
+    enum class State {
+        IN_PROGRESS,
+        FINISHED,
+        FAILED
+    };
+
+    std::string id;                     // assigned by the page runtime
+    std::string url;
+    std::vector<std::string> files;     // names of the File parts of the body
+    uint64_t sent_bytes = 0;
+    uint64_t total_bytes = 0;           // request body size once known, else the files' size
+    State state = State::IN_PROGRESS;
+    int http_status = 0;
+    int64_t longest_stall_ms = 0;       // widest gap between two progress reports
+    std::chrono::steady_clock::time_point started;
+    std::chrono::steady_clock::time_point last_report;
+    std::chrono::steady_clock::time_point ended;
+
+    bool done() const { return state != State::IN_PROGRESS; }
+    bool carries(const std::string& filename) const;
+    int64_t elapsedMs() const;          // start to end, or to the last report while in flight
+    double throughput() const;          // bytes sent per second, 0 before any time has passed
+};
+
+// Applies one hwebUpload message
+// ({"token", "id", "url", "files", "sent", "total", "state": progress|done|failed, "status"})
+// to transfers, adding the transfer on its first message. A non-empty token
+// must match the message's. Returns the updated transfer, or nullptr if the
+// message is malformed or carries another token.
+UploadTransfer* applyUploadMessage(std::vector<UploadTransfer>& transfers, const std::string& message,
+                                   std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now(),
+                                   const std::string& token = "");
+
+// Pairs each selected file, by name and in selection order, with the
+// transfer at index first or later that carried it. Pages only see file
+// names, so files sharing a name take that name's last occurrences in
+// order, one each; with a single file this is simply the latest transfer
+// carrying it. Returns a transfer index per file, or -1 for files no
+// transfer carried.
+std::vector<long> matchUploadTransfers(const std::vector<UploadTransfer>& transfers, size_t first,
+                                       const std::vector<std::string>& names);
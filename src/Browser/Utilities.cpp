@@ -52,6 +52,12 @@ std::string Browser::getPageLoadState() const {
 // ========== Page Source ==========
 
 std::string Browser::getPageSource() {
+    // Pull the document in slices so multi-MB pages are not truncated
+    std::string source;
+    if (streamPageSource([&source](const char* data, size_t length) { source.append(data, length); })) {
+        return source;
+    }
+    
     // Enhanced implementation with WebKit content loading synchronization
     std::string js = "(function() { "
                     "if (!document || !document.documentElement) return ''; "
@@ -419,8 +419,11 @@ bool Browser::waitForElementCount(const std::string& selector, const std::string
         pos += 2;
     }
     
+    // The page runtime reuses its cached count until the DOM actually changes
     std::string condition = "(function() { "
-        "var count = document.querySelectorAll('" + escaped_selector + "').length; ";
+        "var count = window.__hweb ? window.__hweb.count('" + escaped_selector + "') "
+        ": document.querySelectorAll('" + escaped_selector + "').length; "
+        "if (typeof count !== 'number') return false; ";
     
     if (operator_str == ">") {
         condition += "return count > " + std::to_string(expected_count) + ";";
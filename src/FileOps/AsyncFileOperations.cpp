@@ -1,6 +1,7 @@
 #include "AsyncFileOperations.h"
 #include "../Debug.h"
 #include "PathUtils.h"
+#include "InotifyReactor.h"
 #include <algorithm>
 #include <regex>
 #include <filesystem>
@@ -28,8 +29,7 @@ FileSystemWatcher::FileSystemWatcher(const std::string& directory)
     directory_handle_ = INVALID_HANDLE_VALUE;
     memset(&overlapped_, 0, sizeof(overlapped_));
 #elif defined(__linux__)
-    inotify_fd_ = -1;
-    watch_descriptor_ = -1;
+    reactor_token_ = -1;
 #elif defined(__APPLE__)
     kqueue_fd_ = -1;
     dir_fd_ = -1;
@@ -51,7 +51,9 @@ bool FileSystemWatcher::startWatching() {
     }
     
     monitoring_active_ = true;
+#ifndef __linux__
     watcher_thread_ = std::thread(&FileSystemWatcher::watcherLoop, this);
+#endif
     
     debug_output("Started file system watching for: " + watch_directory_);
     return true;
@@ -234,51 +236,6 @@ void FileSystemWatcher::processNativeEvents() {
     
     std::this_thread::sleep_for(std::chrono::milliseconds(50));
     
-#elif defined(__linux__)
-    // Linux inotify implementation
-    struct pollfd pfd = {inotify_fd_, POLLIN, 0};
-    int poll_result = poll(&pfd, 1, 100); // 100ms timeout
-    
-    if (poll_result > 0) {
-        char buffer[1024];
-        ssize_t length = read(inotify_fd_, buffer, sizeof(buffer));
-        
-        if (length > 0) {
-            int offset = 0;
-            while (offset < length) {
-                struct inotify_event* event = (struct inotify_event*)(buffer + offset);
-                
-                if (event->len > 0) {
-                    std::string filename = event->name;
-                    std::string full_path = watch_directory_ + "/" + filename;
-                    
-                    FileEventType event_type = FileEventType::MODIFIED;
-                    if (event->mask & IN_CREATE) {
-                        event_type = FileEventType::CREATED;
-                    } else if (event->mask & IN_DELETE) {
-                        event_type = FileEventType::DELETED;
-                    } else if (event->mask & IN_MOVED_TO) {
-                        event_type = FileEventType::MOVED_TO;
-                    }
-                    
-                    FileEvent file_event(full_path, event_type);
-                    // Get file size if file exists
-                    try {
-                        if (std::filesystem::exists(full_path)) {
-                            file_event.file_size = std::filesystem::file_size(full_path);
-                        }
-                    } catch (...) {
-                        file_event.file_size = 0;
-                    }
-                    
-                    emitFileEvent(file_event);
-                }
-                
-                offset += sizeof(struct inotify_event) + event->len;
-            }
-        }
-    }
-    
 #elif defined(__APPLE__)
     // macOS kqueue implementation
     struct kevent events[10];
@@ -320,17 +277,34 @@ bool FileSystemWatcher::initializePlatformWatcher() {
     return directory_handle_ != INVALID_HANDLE_VALUE;
     
 #elif defined(__linux__)
-    inotify_fd_ = inotify_init1(IN_NONBLOCK);
-    if (inotify_fd_ == -1) {
-        return false;
-    }
-    
-    watch_descriptor_ = inotify_add_watch(
-        inotify_fd_, 
-        watch_directory_.c_str(),
-        IN_CREATE | IN_DELETE | IN_MODIFY | IN_MOVED_TO | IN_MOVED_FROM
-    );
-    return watch_descriptor_ != -1;
+    // Events arrive on the reactor thread as the kernel reports them
+    reactor_token_ = InotifyReactor::instance().addWatch(
+        watch_directory_,
+        IN_CREATE | IN_DELETE | IN_MODIFY | IN_MOVED_TO | IN_MOVED_FROM,
+        [this](const std::string& filename, uint32_t mask) {
+            if (filename.empty()) {
+                return;
+            }
+            std::string full_path = watch_directory_ + "/" + filename;
+            
+            FileEventType event_type = FileEventType::MODIFIED;
+            if (mask & IN_CREATE) {
+                event_type = FileEventType::CREATED;
+            } else if (mask & IN_DELETE) {
+                event_type = FileEventType::DELETED;
+            } else if (mask & IN_MOVED_TO) {
+                event_type = FileEventType::MOVED_TO;
+            }
+            
+            FileEvent file_event(full_path, event_type);
+            // Get file size if file exists
+            std::error_code ec;
+            auto size = std::filesystem::file_size(full_path, ec);
+            file_event.file_size = ec ? 0 : static_cast<size_t>(size);
+            
+            emitFileEvent(file_event);
+        });
+    return reactor_token_ != -1;
     
 #elif defined(__APPLE__)
     kqueue_fd_ = kqueue();
@@ -362,13 +336,9 @@ void FileSystemWatcher::cleanupPlatformWatcher() {
     }
     
 #elif defined(__linux__)
-    if (watch_descriptor_ != -1) {
-        inotify_rm_watch(inotify_fd_, watch_descriptor_);
-        watch_descriptor_ = -1;
-    }
-    if (inotify_fd_ != -1) {
-        close(inotify_fd_);
-        inotify_fd_ = -1;
+    if (reactor_token_ != -1) {
+        InotifyReactor::instance().removeWatch(reactor_token_);
+        reactor_token_ = -1;
     }
     
 #elif defined(__APPLE__)
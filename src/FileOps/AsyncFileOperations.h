@@ -16,7 +16,6 @@
     #include <windows.h>
 #elif defined(__linux__)
     #include <sys/inotify.h>
-    #include <poll.h>
 #elif defined(__APPLE__)
     #include <sys/event.h>
 #endif
@@ -71,8 +70,7 @@ private:
     OVERLAPPED overlapped_;
     char buffer_[1024];
 #elif defined(__linux__)
-    int inotify_fd_;
-    int watch_descriptor_;
+    int reactor_token_;         // watch on the shared InotifyReactor; no thread of our own
 #elif defined(__APPLE__)
     int kqueue_fd_;
     int dir_fd_;
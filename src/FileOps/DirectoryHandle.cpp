@@ -0,0 +1,144 @@
+#include "DirectoryHandle.h"
+#include <cerrno>
+#include <cstdio>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utility>
+
+namespace FileOps {
+
+    namespace {
+
+        constexpr int DIRECTORY_FLAGS = O_RDONLY | O_DIRECTORY | O_CLOEXEC;
+
+        // Walk path from the root (or the working directory) one component
+        // at a time, creating what is missing. Returns a descriptor or -1.
+        int openCreating(const std::string& path) {
+            int current = ::open(path[0] == '/' ? "/" : ".", DIRECTORY_FLAGS);
+            size_t start = 0;
+            while (current >= 0 && start < path.size()) {
+                size_t end = path.find('/', start);
+                if (end == std::string::npos) {
+                    end = path.size();
+                }
+                std::string component = path.substr(start, end - start);
+                start = end + 1;
+                if (component.empty() || component == ".") {
+                    continue;
+                }
+
+                int next = ::openat(current, component.c_str(), DIRECTORY_FLAGS);
+                if (next < 0 && errno == ENOENT) {
+                    // Another writer may create it first; that is fine
+                    if (::mkdirat(current, component.c_str(), 0755) == 0 || errno == EEXIST) {
+                        next = ::openat(current, component.c_str(), DIRECTORY_FLAGS);
+                    }
+                }
+                int saved = errno;
+                ::close(current);
+                errno = saved;
+                current = next;
+            }
+            return current;
+        }
+
+    } // namespace
+
+    DirectoryHandle::DirectoryHandle(const std::string& path, bool create) : path_(path) {
+        if (path.empty()) {
+            error_ = ENOENT;
+            return;
+        }
+        // An existing directory costs one syscall
+        fd_ = ::open(path.c_str(), DIRECTORY_FLAGS);
+        if (fd_ < 0 && errno == ENOENT && create) {
+            fd_ = openCreating(path);
+        }
+        error_ = fd_ < 0 ? errno : 0;
+    }
+
+    DirectoryHandle::~DirectoryHandle() {
+        close();
+    }
+
+    DirectoryHandle::DirectoryHandle(DirectoryHandle&& other) noexcept
+        : fd_(other.fd_), error_(other.error_), path_(std::move(other.path_)) {
+        other.fd_ = -1;
+    }
+
+    DirectoryHandle& DirectoryHandle::operator=(DirectoryHandle&& other) noexcept {
+        if (this != &other) {
+            close();
+            fd_ = other.fd_;
+            error_ = other.error_;
+            path_ = std::move(other.path_);
+            other.fd_ = -1;
+        }
+        return *this;
+    }
+
+    void DirectoryHandle::close() {
+        if (fd_ >= 0) {
+            ::close(fd_);
+            fd_ = -1;
+        }
+    }
+
+    std::string DirectoryHandle::pathFor(const std::string& name) const {
+        if (path_.empty() || path_.back() == '/') {
+            return path_ + name;
+        }
+        return path_ + "/" + name;
+    }
+
+    bool DirectoryHandle::isPlainName(const std::string& name) {
+        return !name.empty() && name != "." && name != ".." &&
+               name.find('/') == std::string::npos && name.find('\0') == std::string::npos;
+    }
+
+    int DirectoryHandle::openFile(const std::string& name, int flags, mode_t mode) const {
+        if (fd_ < 0 || !isPlainName(name)) {
+            errno = fd_ < 0 ? EBADF : EINVAL;
+            return -1;
+        }
+        return ::openat(fd_, name.c_str(), flags | O_CLOEXEC, mode);
+    }
+
+    bool DirectoryHandle::writeFile(const std::string& name, const void* data, size_t size) const {
+        int file = openFile(name, O_WRONLY | O_CREAT | O_TRUNC);
+        if (file < 0) {
+            return false;
+        }
+        const char* bytes = static_cast<const char*>(data);
+        bool ok = true;
+        while (size > 0) {
+            ssize_t written = ::write(file, bytes, size);
+            if (written < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                ok = false;
+                break;
+            }
+            bytes += written;
+            size -= static_cast<size_t>(written);
+        }
+        return ::close(file) == 0 && ok;
+    }
+
+    bool DirectoryHandle::exists(const std::string& name) const {
+        struct stat st;
+        return fd_ >= 0 && isPlainName(name) && ::fstatat(fd_, name.c_str(), &st, 0) == 0;
+    }
+
+    bool DirectoryHandle::rename(const std::string& from, const std::string& to) const {
+        return fd_ >= 0 && isPlainName(from) && isPlainName(to) &&
+               ::renameat(fd_, from.c_str(), fd_, to.c_str()) == 0;
+    }
+
+    bool DirectoryHandle::remove(const std::string& name) const {
+        return fd_ >= 0 && isPlainName(name) && ::unlinkat(fd_, name.c_str(), 0) == 0;
+    }
+
+} // namespace FileOps
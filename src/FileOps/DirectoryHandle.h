@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <sys/types.h>
+
+namespace FileOps {
+
+    /**
+     * Open descriptor on an output directory
+     * Files are created relative to the descriptor with openat(), so writing
+     * thousands of files into one directory costs one open per file instead
+     * of re-resolving and re-checking the directory path each time. The
+     * directory (and any missing parents) is created with mkdirat() on open.
+     */
+    class DirectoryHandle {
+    public:
+        DirectoryHandle() = default;
+        explicit DirectoryHandle(const std::string& path, bool create = true);
+        ~DirectoryHandle();
+
+        DirectoryHandle(DirectoryHandle&& other) noexcept;
+        DirectoryHandle& operator=(DirectoryHandle&& other) noexcept;
+        DirectoryHandle(const DirectoryHandle&) = delete;
+        DirectoryHandle& operator=(const DirectoryHandle&) = delete;
+
+        bool isOpen() const { return fd_ >= 0; }
+        int fd() const { return fd_; }
+        const std::string& path() const { return path_; }
+
+        // errno of the failed open, 0 when the handle is open
+        int error() const { return error_; }
+
+        // Full path of an entry, for messages and manifests
+        std::string pathFor(const std::string& name) const;
+
+        /**
+         * Open an entry of this directory; returns a descriptor or -1
+         * name must be a single component: no separators and no "..",
+         * so it can never resolve outside the directory.
+         */
+        int openFile(const std::string& name, int flags, mode_t mode = 0644) const;
+
+        // Create or truncate name and write data to it
+        bool writeFile(const std::string& name, const void* data, size_t size) const;
+
+        bool exists(const std::string& name) const;
+        bool rename(const std::string& from, const std::string& to) const;
+        bool remove(const std::string& name) const;
+
+        // A single path component that is safe to resolve against the handle
+        static bool isPlainName(const std::string& name);
+
+    private:
+        int fd_ = -1;
+        int error_ = 0;
+        std::string path_;
+
+        void close();
+    };
+
+} // namespace FileOps
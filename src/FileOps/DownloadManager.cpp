@@ -6,6 +6,9 @@
 
 #include "DownloadManager.h"
 #include "AsyncFileOperations.h"
+#include "DownloadScheduler.h"
+#include "InotifyReactor.h"
+#include "Sha256.h"
 #include "../Debug.h"
 #include <algorithm>
 #include <regex>
@@ -22,7 +25,6 @@
     #include <sys/inotify.h>
     #include <sys/stat.h>
     #include <unistd.h>
-    #include <poll.h>
 #elif defined(__APPLE__)
     #include <sys/event.h>
     #include <sys/stat.h>
@@ -54,7 +56,7 @@ namespace FileOps {
             std::string filepath = existing_files[0];
             debug_output("File already exists: " + filepath);
             
-            if (verifyDownloadIntegrity(filepath, cmd.expected_size)) {
+            if (verifyDownloadIntegrity(filepath, cmd.expected_size) && verifyExpectedDigest(filepath, cmd)) {
                 // CRITICAL FIX: Call completion hook for existing files too
                 if (completion_hook_) {
                     completion_hook_(filepath);
@@ -99,6 +101,9 @@ namespace FileOps {
                 if (cmd.verify_integrity && !verifyDownloadIntegrity(found_file, cmd.expected_size)) {
                     return DownloadResult::INTEGRITY_CHECK_FAILED;
                 }
+                if (!verifyExpectedDigest(found_file, cmd)) {
+                    return DownloadResult::INTEGRITY_CHECK_FAILED;
+                }
                 
                 // Call completion hook if set
                 if (completion_hook_) {
@@ -171,6 +176,184 @@ namespace FileOps {
         return DownloadResult::TIMEOUT;
     }
     
+    // ========== WebKit Download Tracking ==========
+    
+    DownloadResult DownloadManager::waitForDownload(Browser& browser, const DownloadCommand& cmd,
+                                                    DownloadRecord* completed) {
+        debug_output("Waiting for WebKit download matching: " + cmd.filename_pattern);
+        
+        std::string download_dir = cmd.download_dir.empty() ? default_download_dir_ : cmd.download_dir;
+        if (!download_dir.empty()) {
+            browser.setDownloadDirectory(download_dir);
+        }
+        
+        auto matches = [&](const DownloadRecord& record) {
+            return fileMatchesPattern(record.filename(), cmd.filename_pattern);
+        };
+        auto progress = [&](const DownloadRecord& record) {
+            if (progress_callback_ && record.expected_bytes > 0) {
+                int percent = static_cast<int>(record.received_bytes * 100 / record.expected_bytes);
+                progress_callback_(record.destination, std::min(percent, 100));
+            }
+        };
+        
+        updateDownloadStats(false, false);
+        DownloadRecord record;
+        if (!browser.waitForDownload(matches, cmd.timeout_ms, record, progress)) {
+            updateDownloadStats(false, true);
+            return DownloadResult::TIMEOUT;
+        }
+        
+        if (record.state != DownloadRecord::State::FINISHED) {
+            debug_output("Download " + record.uri + " ended without a file: " + record.error);
+            updateDownloadStats(false, true);
+            return DownloadResult::DOWNLOAD_FAILED;
+        }
+        
+        if (cmd.verify_integrity && !verifyDownloadIntegrity(record.destination, cmd.expected_size)) {
+            updateDownloadStats(false, true);
+            return DownloadResult::INTEGRITY_CHECK_FAILED;
+        }
+        
+        // The digest was computed while the file was written
+        if (!cmd.expected_sha256.empty() && !Sha256::digestMatches(record.sha256, cmd.expected_sha256)) {
+            debug_output("SHA-256 mismatch for " + record.destination + ": " + record.sha256);
+            updateDownloadStats(false, true);
+            return DownloadResult::INTEGRITY_CHECK_FAILED;
+        }
+        
+        if (completed) {
+            *completed = record;
+        }
+        if (completion_hook_) {
+            completion_hook_(record.destination);
+        }
+        updateDownloadStats(true, false);
+        return DownloadResult::SUCCESS;
+    }
+    
+    DownloadResult DownloadManager::waitForMultipleDownloads(
+        Browser& browser,
+        const std::vector<std::string>& patterns,
+        const std::string& download_dir,
+        int timeout_ms,
+        std::vector<DownloadRecord>* completed) {
+        
+        // All patterns are tracked at once under one timeout; each claims its
+        // own download, so two patterns matching the same name need two files
+        DownloadScheduler scheduler(browser, *this);
+        for (const auto& pattern : patterns) {
+            scheduler.expect(pattern);
+        }
+        return runScheduler(scheduler, download_dir, timeout_ms, completed);
+    }
+    
+    DownloadResult DownloadManager::downloadAll(
+        Browser& browser,
+        const std::vector<std::string>& uris,
+        const std::string& download_dir,
+        int timeout_ms,
+        std::vector<DownloadRecord>* completed) {
+        
+        DownloadScheduler scheduler(browser, *this);
+        for (const auto& uri : uris) {
+            scheduler.enqueue(uri);
+        }
+        return runScheduler(scheduler, download_dir, timeout_ms, completed);
+    }
+    
+    DownloadResult DownloadManager::streamDownload(
+        Browser& browser,
+        const std::string& uri,
+        StreamingFileHash::Sink sink,
+        int timeout_ms,
+        DownloadRecord* completed) {
+        
+        debug_output("Streaming WebKit download: " + uri);
+        updateDownloadStats(false, false);
+        
+        uint64_t id = browser.streamDownload(uri, std::move(sink));
+        if (id == 0) {
+            updateDownloadStats(false, true);
+            return DownloadResult::DOWNLOAD_FAILED;
+        }
+        
+        auto matches = [id](const DownloadRecord& record) {
+            return record.id == id;
+        };
+        auto progress = [&](const DownloadRecord& record) {
+            if (progress_callback_ && record.expected_bytes > 0) {
+                int percent = static_cast<int>(record.received_bytes * 100 / record.expected_bytes);
+                progress_callback_(record.uri, std::min(percent, 100));
+            }
+        };
+        
+        DownloadRecord record;
+        if (!browser.waitForDownload(matches, timeout_ms, record, progress)) {
+            // Nobody reads the scratch file any more; stop it and keep it from later waits
+            browser.cancelDownload(id);
+            browser.claimDownload(id);
+            updateDownloadStats(false, true);
+            return DownloadResult::TIMEOUT;
+        }
+        
+        if (record.state != DownloadRecord::State::FINISHED) {
+            debug_output("Stream of " + record.uri + " ended early: " + record.error);
+            updateDownloadStats(false, true);
+            return DownloadResult::DOWNLOAD_FAILED;
+        }
+        
+        if (completed) {
+            *completed = record;
+        }
+        updateDownloadStats(true, false);
+        return DownloadResult::SUCCESS;
+    }
+    
+    DownloadResult DownloadManager::runScheduler(
+        DownloadScheduler& scheduler,
+        const std::string& download_dir,
+        int timeout_ms,
+        std::vector<DownloadRecord>* completed) {
+        
+        scheduler.setMaxConcurrent(max_concurrent_downloads_);
+        scheduler.setDiskBudget(disk_budget_bytes_);
+        scheduler.setDownloadDirectory(download_dir.empty() ? default_download_dir_ : download_dir);
+        if (progress_callback_) {
+            scheduler.setProgressCallback([this](const DownloadProgress& progress) {
+                if (progress.expected_size > 0) {
+                    progress_callback_(progress.filepath, static_cast<int>(progress.getProgressPercent()));
+                }
+            });
+        }
+        
+        for (size_t i = 0; i < scheduler.jobs().size(); ++i) {
+            updateDownloadStats(false, false);
+        }
+        scheduler.waitForAll(timeout_ms);
+        
+        DownloadResult first_failure = DownloadResult::SUCCESS;
+        for (const auto& job : scheduler.jobs()) {
+            if (job.result == DownloadResult::SUCCESS) {
+                if (completed) {
+                    completed->push_back(job.record);
+                }
+                if (completion_hook_) {
+                    completion_hook_(job.record.destination);
+                }
+                updateDownloadStats(true, false);
+            } else {
+                debug_output("Download " + (job.uri.empty() ? job.pattern : job.uri) + ": " +
+                             downloadResultToString(job.result));
+                updateDownloadStats(false, true);
+                if (first_failure == DownloadResult::SUCCESS) {
+                    first_failure = job.result;
+                }
+            }
+        }
+        return first_failure;
+    }
+    
     void DownloadManager::startAsyncDownloadMonitoring(
         const DownloadCommand& cmd,
         std::function<void(DownloadResult, const std::string&)> callback) {
@@ -302,41 +485,65 @@ namespace FileOps {
             return false;
         }
         
-        if (!initializePlatformWatcher(directory)) {
+        // Changes arrive on a watcher thread; hand them to this thread and
+        // wake the main context so it checks them straight away
+        std::mutex changes_mutex;
+        std::vector<std::string> changed_files;
+        auto on_change = [&](const std::string& filepath, const std::string& event_type) {
+            if (event_type == "created" || event_type == "modified" || event_type == "moved") {
+                std::lock_guard<std::mutex> lock(changes_mutex);
+                changed_files.push_back(filepath);
+                g_main_context_wakeup(g_main_context_default());
+            }
+        };
+        
+        if (!initializePlatformWatcher(directory, on_change)) {
             debug_output("Failed to initialize native file watcher");
             return false;
         }
         
-        std::atomic<bool> found_file{false};
-                auto start_time = std::chrono::system_clock::now();
-        auto timeout = std::chrono::milliseconds(timeout_ms);
-        
-        auto watcher_thread = std::thread([this, &found_file, file_found_callback, pattern]() {
-            processFileSystemEvents([&](const std::string& filepath, const std::string& event_type) {
-                if (event_type == "created" || event_type == "modified") {
-                    if (fileMatchesPattern(filepath, pattern) && !isBrowserTempFile(filepath)) {
-                        file_found_callback(filepath);
-                        found_file = true;
-                    }
-                }
+        #ifndef __linux__
+            auto watcher_thread = std::thread([this, &on_change]() {
+                processFileSystemEvents(on_change);
             });
-        });
+        #endif
         
-        // SIGNAL-BASED APPROACH: Wait for file to be found or timeout
-        while (!found_file && (std::chrono::system_clock::now() - start_time < timeout)) {
-            // Process GTK main loop events instead of blocking sleep
-            GMainContext *context = g_main_context_default();
-            while (g_main_context_pending(context)) {
-                g_main_context_iteration(context, FALSE);
+        bool timed_out = false;
+        guint timeout_id = g_timeout_add(timeout_ms, [](gpointer user_data) -> gboolean {
+            *static_cast<bool*>(user_data) = true;
+            return G_SOURCE_REMOVE;
+        }, &timed_out);
+        
+        bool found_file = false;
+        while (!found_file && !timed_out) {
+            std::vector<std::string> batch;
+            {
+                std::lock_guard<std::mutex> lock(changes_mutex);
+                batch.swap(changed_files);
+            }
+            for (const auto& filepath : batch) {
+                if (fileMatchesPattern(filepath, pattern) && !isBrowserTempFile(filepath)) {
+                    file_found_callback(filepath);
+                    found_file = true;
+                    break;
+                }
+            }
+            if (!found_file) {
+                g_main_context_iteration(g_main_context_default(), TRUE);
             }
-            std::this_thread::sleep_for(std::chrono::milliseconds(25));
+        }
+        
+        if (!timed_out) {
+            g_source_remove(timeout_id);
         }
         
         // Clean up watcher
         cleanupPlatformWatcher();
-        if (watcher_thread.joinable()) {
-            watcher_thread.join();
-        }
+        #ifndef __linux__
+            if (watcher_thread.joinable()) {
+                watcher_thread.join();
+            }
+        #endif
         
         return found_file;
     }
@@ -430,6 +637,18 @@ namespace FileOps {
         return false;
     }
     
+    bool DownloadManager::verifyExpectedDigest(const std::string& filepath, const DownloadCommand& cmd) {
+        if (cmd.expected_sha256.empty()) {
+            return true;
+        }
+        std::string actual = Sha256::fileDigest(filepath);
+        if (!Sha256::digestMatches(actual, cmd.expected_sha256)) {
+            debug_output("SHA-256 mismatch for " + filepath + ": " + actual);
+            return false;
+        }
+        return true;
+    }
+    
     bool DownloadManager::verifyDownloadIntegrity(const std::string& filepath, size_t expected_size) {
         if (!integrity_verification_enabled_) {
             return true;
@@ -546,7 +765,7 @@ namespace FileOps {
         const std::string& directory,
         std::function<void(const std::string&, const std::string&)> change_callback) {
         
-        return initializePlatformWatcher(directory);
+        return initializePlatformWatcher(directory, change_callback);
     }
     
     void DownloadManager::stopNativeFileWatcher() {
@@ -689,6 +908,14 @@ namespace FileOps {
         integrity_verification_enabled_ = enabled;
     }
     
+    void DownloadManager::setMaxConcurrentDownloads(size_t count) {
+        max_concurrent_downloads_ = std::max<size_t>(count, 1);
+    }
+    
+    void DownloadManager::setDiskBudget(uint64_t bytes) {
+        disk_budget_bytes_ = bytes;
+    }
+    
     void DownloadManager::setPollingInterval(int interval_ms) {
         polling_interval_ms_ = interval_ms;
     }
@@ -704,6 +931,8 @@ namespace FileOps {
             case DownloadResult::PERMISSION_DENIED: return "PERMISSION_DENIED";
             case DownloadResult::DIRECTORY_NOT_FOUND: return "DIRECTORY_NOT_FOUND";
             case DownloadResult::PATTERN_MATCH_FAILED: return "PATTERN_MATCH_FAILED";
+            case DownloadResult::DOWNLOAD_FAILED: return "DOWNLOAD_FAILED";
+            case DownloadResult::DISK_BUDGET_EXCEEDED: return "DISK_BUDGET_EXCEEDED";
             default: return "UNKNOWN";
         }
     }
@@ -734,6 +963,10 @@ namespace FileOps {
                 return "Download directory not found";
             case DownloadResult::PATTERN_MATCH_FAILED:
                 return "Pattern matching failed for: " + pattern;
+            case DownloadResult::DOWNLOAD_FAILED:
+                return "Download failed or was cancelled: " + pattern;
+            case DownloadResult::DISK_BUDGET_EXCEEDED:
+                return "Download budget or free disk space exceeded: " + pattern;
             default:
                 return "Unknown download error";
         }
@@ -789,7 +1022,9 @@ namespace FileOps {
     
     // ========== Platform-Specific Implementation ==========
     
-    bool DownloadManager::initializePlatformWatcher(const std::string& directory) {
+    bool DownloadManager::initializePlatformWatcher(
+        const std::string& directory,
+        std::function<void(const std::string&, const std::string&)> callback) {
         #ifdef _WIN32
             // Windows implementation using ReadDirectoryChangesW
             directory_handle_ = CreateFileA(
@@ -805,19 +1040,24 @@ namespace FileOps {
             return directory_handle_ != INVALID_HANDLE_VALUE;
             
         #elif defined(__linux__)
-            // Linux implementation using inotify
-            inotify_fd_ = inotify_init1(IN_NONBLOCK);
-            if (inotify_fd_ == -1) {
-                return false;
-            }
-            
-            watch_descriptor_ = inotify_add_watch(
-                inotify_fd_, 
-                directory.c_str(),
-                IN_CREATE | IN_MODIFY | IN_MOVED_TO
-            );
+            // Linux implementation using the process-wide inotify reactor
+            cleanupPlatformWatcher();
+            reactor_token_ = InotifyReactor::instance().addWatch(
+                directory,
+                IN_CREATE | IN_MODIFY | IN_MOVED_TO,
+                [directory, callback](const std::string& filename, uint32_t mask) {
+                    if (!callback || filename.empty()) {
+                        return;
+                    }
+                    std::string event_type = "created";
+                    if (mask & IN_CREATE) event_type = "created";
+                    else if (mask & IN_MODIFY) event_type = "modified";
+                    else if (mask & IN_MOVED_TO) event_type = "moved";
+                    
+                    callback(PathUtils::joinPaths({directory, filename}), event_type);
+                });
             
-            return watch_descriptor_ != -1;
+            return reactor_token_ != -1;
             
         #elif defined(__APPLE__)
             // macOS implementation using kqueue
@@ -855,13 +1095,9 @@ namespace FileOps {
             }
             
         #elif defined(__linux__)
-            if (watch_descriptor_ != -1) {
-                inotify_rm_watch(inotify_fd_, watch_descriptor_);
-                watch_descriptor_ = -1;
-            }
-            if (inotify_fd_ != -1) {
-                close(inotify_fd_);
-                inotify_fd_ = -1;
+            if (reactor_token_ != -1) {
+                InotifyReactor::instance().removeWatch(reactor_token_);
+                reactor_token_ = -1;
             }
             
         #elif defined(__APPLE__)
@@ -898,32 +1134,6 @@ namespace FileOps {
                 std::this_thread::sleep_for(std::chrono::milliseconds(100));
             }
             
-        #elif defined(__linux__)
-            // Linux inotify event processing
-            char buffer[1024];
-            
-            while (monitoring_active_) {
-                struct pollfd pfd = {inotify_fd_, POLLIN, 0};
-                int poll_result = poll(&pfd, 1, 100); // 100ms timeout
-                
-                if (poll_result > 0) {
-                    ssize_t length = read(inotify_fd_, buffer, sizeof(buffer));
-                    if (length > 0) {
-                        struct inotify_event* event = (struct inotify_event*)buffer;
-                        if (event->len > 0) {
-                            std::string filename = event->name;
-                            std::string event_type = "created";
-                            
-                            if (event->mask & IN_CREATE) event_type = "created";
-                            else if (event->mask & IN_MODIFY) event_type = "modified";
-                            else if (event->mask & IN_MOVED_TO) event_type = "moved";
-                            
-                            callback(filename, event_type);
-                        }
-                    }
-                }
-            }
-            
         #elif defined(__APPLE__)
             // macOS kqueue event processing
             struct kevent events[10];
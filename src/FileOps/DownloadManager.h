@@ -2,6 +2,7 @@
 
 #include "Types.h"
 #include "PathUtils.h"
+#include "../Browser/Browser.h"
 #include <string>
 #include <vector>
 #include <functional>
@@ -12,13 +13,16 @@
 
 namespace FileOps {
     
+    class DownloadScheduler;
+    
     class DownloadManager {
     public:
         // ========== Main Download Interface ==========
         
         /**
          * Wait for a file download to complete
-         * Monitors download directory for file appearance and completion
+         * Monitors download directory for file appearance and completion;
+         * for files written by something other than the browser
          */
         DownloadResult waitForDownload(const DownloadCommand& cmd);
         
@@ -32,6 +36,55 @@ namespace FileOps {
             int timeout_ms = 60000
         );
         
+        /**
+         * Wait for a download started by the browser to finish
+         * Driven by WebKit's download signals: the file name, exact byte
+         * counts and failures come from WebKit, so no directory watching or
+         * size-stability wait is needed. Downloads that began before the
+         * call are matched too. The finished download, including its
+         * SHA-256, is copied to completed when given.
+         */
+        DownloadResult waitForDownload(Browser& browser, const DownloadCommand& cmd,
+                                       DownloadRecord* completed = nullptr);
+        
+        /**
+         * Wait for one browser download per pattern within a shared timeout
+         * All patterns are tracked concurrently by a DownloadScheduler
+         */
+        DownloadResult waitForMultipleDownloads(
+            Browser& browser,
+            const std::vector<std::string>& patterns,
+            const std::string& download_dir = "",
+            int timeout_ms = 60000,
+            std::vector<DownloadRecord>* completed = nullptr
+        );
+        
+        /**
+         * Download every URI through the browser, at most
+         * setMaxConcurrentDownloads() at a time, within one shared timeout
+         */
+        DownloadResult downloadAll(
+            Browser& browser,
+            const std::vector<std::string>& uris,
+            const std::string& download_dir = "",
+            int timeout_ms = 60000,
+            std::vector<DownloadRecord>* completed = nullptr
+        );
+        
+        /**
+         * Download uri through the browser and hand its bytes to sink as
+         * they arrive instead of keeping a file in the download directory.
+         * A sink returning false cancels the download. The finished
+         * download, including its SHA-256, is copied to completed when given.
+         */
+        DownloadResult streamDownload(
+            Browser& browser,
+            const std::string& uri,
+            StreamingFileHash::Sink sink,
+            int timeout_ms = 60000,
+            DownloadRecord* completed = nullptr
+        );
+        
         /**
          * Start asynchronous download monitoring
          * Returns immediately and calls callback when download completes
@@ -279,6 +332,16 @@ namespace FileOps {
          */
         void setIntegrityVerificationEnabled(bool enabled);
         
+        /**
+         * Limit how many scheduled browser downloads run at once
+         */
+        void setMaxConcurrentDownloads(size_t count);
+        
+        /**
+         * Limit the total bytes one batch may write (0 = no limit)
+         */
+        void setDiskBudget(uint64_t bytes);
+        
         /**
          * Set custom file change detection interval
          * Frequency of polling when native watching unavailable
@@ -357,6 +420,8 @@ namespace FileOps {
         std::chrono::milliseconds stability_check_duration_ = std::chrono::milliseconds(2000);
         bool integrity_verification_enabled_ = true;
         int polling_interval_ms_ = 500;
+        size_t max_concurrent_downloads_ = 4;
+        uint64_t disk_budget_bytes_ = 0;
         
         std::atomic<bool> monitoring_active_{false};
         std::vector<std::thread> monitoring_threads_;
@@ -375,19 +440,37 @@ namespace FileOps {
             void* directory_handle_ = nullptr;
             void* completion_port_ = nullptr;
         #elif defined(__linux__)
-            int inotify_fd_ = -1;
-            int watch_descriptor_ = -1;
+            int reactor_token_ = -1;    // watch on the shared InotifyReactor
         #elif defined(__APPLE__)
             int kqueue_fd_ = -1;
         #endif
         
         // ========== Internal Helper Methods ==========
         
+        /**
+         * Configure and run a batch, then fold job results into stats
+         */
+        DownloadResult runScheduler(
+            DownloadScheduler& scheduler,
+            const std::string& download_dir,
+            int timeout_ms,
+            std::vector<DownloadRecord>* completed
+        );
+        
+        /**
+         * Compare a file's SHA-256 with the command's expected digest, if any
+         */
+        bool verifyExpectedDigest(const std::string& filepath, const DownloadCommand& cmd);
+        
         /**
          * Initialize platform-specific file watching
-         * Sets up native OS file system monitoring
+         * Sets up native OS file system monitoring; on Linux the callback is
+         * registered with the shared InotifyReactor and called from its thread
          */
-        bool initializePlatformWatcher(const std::string& directory);
+        bool initializePlatformWatcher(
+            const std::string& directory,
+            std::function<void(const std::string&, const std::string&)> callback = nullptr
+        );
         
         /**
          * Cleanup platform-specific resources
@@ -397,7 +480,8 @@ namespace FileOps {
         
         /**
          * Process file system events from native watcher
-         * Handles platform-specific event structures
+         * Handles platform-specific event structures; unused on Linux, where
+         * the reactor delivers events
          */
         void processFileSystemEvents(
             std::function<void(const std::string&, const std::string&)> callback
@@ -0,0 +1,247 @@
+#include "DownloadScheduler.h"
+#include "Sha256.h"
+#include "../Debug.h"
+#include <algorithm>
+#include <filesystem>
+#include <glib.h>
+
+namespace FileOps {
+    
+    DownloadScheduler::DownloadScheduler(Browser& browser, DownloadManager& manager)
+        : browser_(browser), manager_(manager) {
+        auto bus = browser_.getEventBus();
+        if (!bus) {
+            return;
+        }
+        for (auto type : {BrowserEvents::EventType::DOWNLOAD_STARTED, BrowserEvents::EventType::DOWNLOAD_PROGRESS,
+                          BrowserEvents::EventType::DOWNLOAD_FINISHED, BrowserEvents::EventType::DOWNLOAD_FAILED}) {
+            subscriptions_.push_back(bus->subscribe(type, [this](const BrowserEvents::Event& event) {
+                auto* download_event = dynamic_cast<const BrowserEvents::DownloadEvent*>(&event);
+                if (download_event) {
+                    update(download_event->download);
+                }
+            }));
+        }
+    }
+    
+    DownloadScheduler::~DownloadScheduler() {
+        auto bus = browser_.getEventBus();
+        if (bus) {
+            for (size_t id : subscriptions_) {
+                bus->unsubscribe(id);
+            }
+        }
+    }
+    
+    // ========== Configuration ==========
+    
+    void DownloadScheduler::setMaxConcurrent(size_t count) {
+        max_concurrent_ = std::max<size_t>(count, 1);
+    }
+    
+    void DownloadScheduler::setDiskBudget(uint64_t bytes) {
+        disk_budget_ = bytes;
+    }
+    
+    void DownloadScheduler::setDownloadDirectory(const std::string& directory) {
+        download_dir_ = directory;
+    }
+    
+    void DownloadScheduler::setProgressCallback(std::function<void(const DownloadProgress&)> callback) {
+        progress_callback_ = callback;
+    }
+    
+    // ========== Jobs ==========
+    
+    size_t DownloadScheduler::enqueue(const std::string& uri, const std::string& expected_sha256) {
+        Job job;
+        job.uri = uri;
+        job.expected_sha256 = expected_sha256;
+        jobs_.push_back(job);
+        return jobs_.size() - 1;
+    }
+    
+    size_t DownloadScheduler::expect(const std::string& pattern, const std::string& expected_sha256) {
+        Job job;
+        job.pattern = pattern;
+        job.expected_sha256 = expected_sha256;
+        jobs_.push_back(job);
+        return jobs_.size() - 1;
+    }
+    
+    size_t DownloadScheduler::activeCount() const {
+        return std::count_if(jobs_.begin(), jobs_.end(), [](const Job& job) {
+            return job.download_id != 0 && !job.done;
+        });
+    }
+    
+    uint64_t DownloadScheduler::committedBytes() const {
+        uint64_t total = 0;
+        for (const auto& job : jobs_) {
+            if (job.download_id == 0 || (job.done && job.result != DownloadResult::SUCCESS)) {
+                continue;
+            }
+            total += std::max(job.record.received_bytes, job.record.expected_bytes);
+        }
+        return total;
+    }
+    
+    bool DownloadScheduler::allDone() const {
+        return std::all_of(jobs_.begin(), jobs_.end(), [](const Job& job) { return job.done; });
+    }
+    
+    // ========== Scheduling ==========
+    
+    DownloadScheduler::Job* DownloadScheduler::jobFor(const DownloadRecord& record) {
+        for (auto& job : jobs_) {
+            if (job.download_id == record.id) {
+                return &job;
+            }
+        }
+        
+        // Page downloads are matched by name, so only once the destination is chosen
+        if (record.destination.empty()) {
+            return nullptr;
+        }
+        for (auto& job : jobs_) {
+            if (!job.pattern.empty() && job.download_id == 0 && !job.done &&
+                manager_.fileMatchesPattern(record.filename(), job.pattern) &&
+                browser_.claimDownload(record.id)) {
+                job.download_id = record.id;
+                debug_output("Scheduler matched " + record.filename() + " to pattern " + job.pattern);
+                return &job;
+            }
+        }
+        return nullptr;
+    }
+    
+    void DownloadScheduler::update(const DownloadRecord& record) {
+        Job* job = jobFor(record);
+        if (!job || job->done) {
+            return;
+        }
+        job->record = record;
+        
+        if (progress_callback_) {
+            DownloadProgress progress;
+            progress.filepath = record.destination;
+            progress.current_size = record.received_bytes;
+            progress.expected_size = record.expected_bytes;
+            progress.is_complete = record.state == DownloadRecord::State::FINISHED;
+            progress.start_time = std::chrono::system_clock::now() -
+                std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::steady_clock::now() - record.started);
+            progress.last_update = std::chrono::system_clock::now();
+            progress_callback_(progress);
+        }
+        
+        switch (record.state) {
+            case DownloadRecord::State::FINISHED:
+                if (manager_.verifyDownloadIntegrity(record.destination, record.expected_bytes) &&
+                    (job->expected_sha256.empty() || Sha256::digestMatches(record.sha256, job->expected_sha256))) {
+                    finish(*job, DownloadResult::SUCCESS);
+                } else {
+                    finish(*job, DownloadResult::INTEGRITY_CHECK_FAILED);
+                }
+                break;
+            case DownloadRecord::State::FAILED:
+            case DownloadRecord::State::CANCELLED:
+                finish(*job, DownloadResult::DOWNLOAD_FAILED);
+                break;
+            case DownloadRecord::State::IN_PROGRESS:
+                if (!job->space_checked && record.expected_bytes > record.received_bytes && !record.destination.empty()) {
+                    job->space_checked = true;
+                    std::string directory = std::filesystem::path(record.destination).parent_path().string();
+                    if (manager_.hasInsufficientDiskSpace(directory, record.expected_bytes - record.received_bytes)) {
+                        debug_output("Not enough free space for " + record.destination);
+                        abort(*job, DownloadResult::DISK_BUDGET_EXCEEDED);
+                        break;
+                    }
+                }
+                if (disk_budget_ > 0 && committedBytes() > disk_budget_) {
+                    debug_output("Download budget exceeded by " + record.destination);
+                    abort(*job, DownloadResult::DISK_BUDGET_EXCEEDED);
+                }
+                break;
+        }
+        
+        startQueued();
+    }
+    
+    void DownloadScheduler::startQueued() {
+        for (auto& job : jobs_) {
+            if (activeCount() >= max_concurrent_) {
+                return;
+            }
+            if (job.uri.empty() || job.download_id != 0 || job.done) {
+                continue;
+            }
+            if (disk_budget_ > 0 && committedBytes() >= disk_budget_) {
+                finish(job, DownloadResult::DISK_BUDGET_EXCEEDED);
+                continue;
+            }
+            
+            job.download_id = browser_.startDownload(job.uri);
+            if (job.download_id == 0) {
+                finish(job, DownloadResult::DOWNLOAD_FAILED);
+                continue;
+            }
+            browser_.claimDownload(job.download_id);
+            debug_output("Scheduler started " + job.uri);
+        }
+    }
+    
+    void DownloadScheduler::finish(Job& job, DownloadResult result) {
+        job.done = true;
+        job.result = result;
+    }
+    
+    void DownloadScheduler::abort(Job& job, DownloadResult result) {
+        // Mark first: cancelling reports the failure back through update()
+        finish(job, result);
+        browser_.cancelDownload(job.download_id);
+    }
+    
+    bool DownloadScheduler::waitForAll(int timeout_ms) {
+        if (!download_dir_.empty()) {
+            browser_.setDownloadDirectory(download_dir_);
+        }
+        
+        // Downloads the page started before the batch was set up
+        for (const auto& record : browser_.getDownloads()) {
+            if (!record.claimed) {
+                update(record);
+            }
+        }
+        startQueued();
+        
+        bool timed_out = false;
+        guint timeout_id = g_timeout_add(timeout_ms, [](gpointer user_data) -> gboolean {
+            *static_cast<bool*>(user_data) = true;
+            return G_SOURCE_REMOVE;
+        }, &timed_out);
+        
+        while (!allDone() && !timed_out) {
+            g_main_context_iteration(g_main_context_default(), TRUE);
+        }
+        
+        if (!timed_out) {
+            g_source_remove(timeout_id);
+        }
+        
+        for (auto& job : jobs_) {
+            if (job.done) {
+                continue;
+            }
+            if (!job.uri.empty() && job.download_id != 0) {
+                abort(job, DownloadResult::TIMEOUT);
+            } else {
+                finish(job, DownloadResult::TIMEOUT);
+            }
+        }
+        
+        return std::all_of(jobs_.begin(), jobs_.end(), [](const Job& job) {
+            return job.result == DownloadResult::SUCCESS;
+        });
+    }
+    
+} // namespace FileOps
@@ -0,0 +1,88 @@
+#pragma once
+
+#include "Types.h"
+#include "DownloadManager.h"
+#include "../Browser/Browser.h"
+#include <string>
+#include <vector>
+#include <functional>
+
+namespace FileOps {
+    
+    /**
+     * Runs a batch of downloads in one browser at the same time
+     * Jobs are either URIs the scheduler starts itself (at most
+     * max_concurrent at once) or file name patterns for downloads the page
+     * starts. State comes from the browser's DOWNLOAD_* events, so every
+     * job progresses in parallel and the batch shares a single timeout.
+     */
+    class DownloadScheduler {
+    public:
+        struct Job {
+            std::string uri;            // started by the scheduler
+            std::string pattern;        // or: a page download whose file name matches
+            std::string expected_sha256;  // "" = no digest check
+            uint64_t download_id = 0;   // 0 until started or matched
+            DownloadRecord record;      // latest state reported by the browser
+            DownloadResult result = DownloadResult::TIMEOUT;
+            bool done = false;
+            bool space_checked = false;
+        };
+        
+        DownloadScheduler(Browser& browser, DownloadManager& manager);
+        ~DownloadScheduler();
+        
+        DownloadScheduler(const DownloadScheduler&) = delete;
+        DownloadScheduler& operator=(const DownloadScheduler&) = delete;
+        
+        // ========== Configuration ==========
+        
+        void setMaxConcurrent(size_t count);
+        
+        /**
+         * Total bytes the batch may write; 0 means no budget
+         * Queued jobs are not started once the budget is committed and a
+         * running download that pushes past it is cancelled. Independently,
+         * a download is cancelled when its Content-Length would not fit in
+         * the free space of the download directory.
+         */
+        void setDiskBudget(uint64_t bytes);
+        
+        void setDownloadDirectory(const std::string& directory);
+        void setProgressCallback(std::function<void(const DownloadProgress&)> callback);
+        
+        // ========== Jobs ==========
+        
+        size_t enqueue(const std::string& uri, const std::string& expected_sha256 = "");
+        size_t expect(const std::string& pattern, const std::string& expected_sha256 = "");
+        
+        /**
+         * Run until every job is done or timeout_ms passes
+         * Running downloads the scheduler started are cancelled on timeout.
+         * Returns true when every job succeeded.
+         */
+        bool waitForAll(int timeout_ms);
+        
+        const std::vector<Job>& jobs() const { return jobs_; }
+        size_t activeCount() const;
+        uint64_t committedBytes() const;
+        
+    private:
+        Browser& browser_;
+        DownloadManager& manager_;
+        std::vector<Job> jobs_;
+        std::vector<size_t> subscriptions_;
+        size_t max_concurrent_ = 4;
+        uint64_t disk_budget_ = 0;
+        std::string download_dir_;
+        std::function<void(const DownloadProgress&)> progress_callback_;
+        
+        void update(const DownloadRecord& record);
+        Job* jobFor(const DownloadRecord& record);
+        void startQueued();
+        void finish(Job& job, DownloadResult result);
+        void abort(Job& job, DownloadResult result);
+        bool allDone() const;
+    };
+    
+} // namespace FileOps
@@ -0,0 +1,312 @@
+#include "InotifyReactor.h"
+#include "../Debug.h"
+#include <algorithm>
+
+#ifdef __linux__
+    #include <sys/epoll.h>
+    #include <sys/eventfd.h>
+    #include <sys/inotify.h>
+    #include <sys/timerfd.h>
+    #include <unistd.h>
+    #include <cerrno>
+    #include <climits>
+#endif
+
+namespace FileOps {
+
+    InotifyReactor& InotifyReactor::instance() {
+        static InotifyReactor reactor;
+        return reactor;
+    }
+
+    bool InotifyReactor::isAvailable() {
+        #ifdef __linux__
+            return true;
+        #else
+            return false;
+        #endif
+    }
+
+    InotifyReactor::~InotifyReactor() {
+        #ifdef __linux__
+            if (running_.exchange(false)) {
+                uint64_t one = 1;
+                ssize_t ignored = write(wake_fd_, &one, sizeof(one));
+                (void)ignored;
+                if (thread_.joinable()) {
+                    thread_.join();
+                }
+            }
+            for (int fd : {timer_fd_, wake_fd_, inotify_fd_, epoll_fd_}) {
+                if (fd != -1) {
+                    close(fd);
+                }
+            }
+        #endif
+    }
+
+    void InotifyReactor::setCoalesceWindow(std::chrono::milliseconds window) {
+        coalesce_ms_ = std::max<long>(0, static_cast<long>(window.count()));
+    }
+
+    std::chrono::milliseconds InotifyReactor::getCoalesceWindow() const {
+        return std::chrono::milliseconds(coalesce_ms_.load());
+    }
+
+    size_t InotifyReactor::watchCount() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return subscriptions_.size();
+    }
+
+    // ========== Watch Registration ==========
+
+    int InotifyReactor::addWatch(const std::string& directory, uint32_t mask, Callback callback) {
+        #ifdef __linux__
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!running_ && !start()) {
+                return -1;
+            }
+
+            // A directory watched twice shares one wd, so widen its mask rather than replace it
+            int wd = inotify_add_watch(inotify_fd_, directory.c_str(), mask | IN_MASK_ADD);
+            if (wd == -1) {
+                debug_output("inotify_add_watch failed for: " + directory);
+                return -1;
+            }
+            directories_[wd] = directory;
+
+            int token = ++next_token_;
+            subscriptions_[token] = Subscription{wd, mask, std::make_shared<Callback>(std::move(callback))};
+            return token;
+        #else
+            (void)directory;
+            (void)mask;
+            (void)callback;
+            return -1;
+        #endif
+    }
+
+    void InotifyReactor::removeWatch(int token) {
+        #ifdef __linux__
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                auto it = subscriptions_.find(token);
+                if (it == subscriptions_.end()) {
+                    return;
+                }
+                int wd = it->second.wd;
+                subscriptions_.erase(it);
+
+                uint32_t remaining = combinedMask(wd);
+                if (remaining == 0) {
+                    inotify_rm_watch(inotify_fd_, wd);
+                    directories_.erase(wd);
+                } else {
+                    // Narrow the kernel mask back to what the other watchers asked for
+                    inotify_add_watch(inotify_fd_, directories_[wd].c_str(), remaining);
+                }
+            }
+
+            // Wait out a dispatch that may already hold the callback
+            if (std::this_thread::get_id() != thread_id_) {
+                std::lock_guard<std::mutex> dispatching(dispatch_mutex_);
+            }
+        #else
+            (void)token;
+        #endif
+    }
+
+    uint32_t InotifyReactor::combinedMask(int wd) const {
+        uint32_t mask = 0;
+        for (const auto& entry : subscriptions_) {
+            if (entry.second.wd == wd) {
+                mask |= entry.second.mask;
+            }
+        }
+        return mask;
+    }
+
+    // ========== Reactor Thread ==========
+
+    bool InotifyReactor::start() {
+        #ifdef __linux__
+            inotify_fd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+            epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+            wake_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+            timer_fd_ = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+            if (inotify_fd_ == -1 || epoll_fd_ == -1 || wake_fd_ == -1 || timer_fd_ == -1) {
+                debug_output("Failed to create inotify reactor descriptors");
+                return false;
+            }
+
+            for (int fd : {inotify_fd_, wake_fd_, timer_fd_}) {
+                struct epoll_event ev = {};
+                ev.events = EPOLLIN;
+                ev.data.fd = fd;
+                if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &ev) == -1) {
+                    debug_output("Failed to register inotify reactor descriptor with epoll");
+                    return false;
+                }
+            }
+
+            running_ = true;
+            thread_ = std::thread(&InotifyReactor::run, this);
+            thread_id_ = thread_.get_id();
+            debug_output("Inotify reactor started");
+            return true;
+        #else
+            return false;
+        #endif
+    }
+
+    void InotifyReactor::run() {
+        #ifdef __linux__
+            struct epoll_event events[3];
+            while (running_) {
+                int count = epoll_wait(epoll_fd_, events, 3, -1);
+                if (count == -1) {
+                    if (errno == EINTR) {
+                        continue;
+                    }
+                    debug_output("Inotify reactor epoll_wait failed");
+                    break;
+                }
+
+                std::lock_guard<std::mutex> dispatching(dispatch_mutex_);
+                for (int i = 0; i < count; ++i) {
+                    int fd = events[i].data.fd;
+                    if (fd == inotify_fd_) {
+                        readEvents();
+                    } else if (fd == timer_fd_) {
+                        uint64_t expirations;
+                        ssize_t ignored = read(timer_fd_, &expirations, sizeof(expirations));
+                        (void)ignored;
+                        timer_armed_ = false;
+                        flushModifies();
+                    } else if (fd == wake_fd_) {
+                        uint64_t value;
+                        ssize_t ignored = read(wake_fd_, &value, sizeof(value));
+                        (void)ignored;
+                    }
+                }
+            }
+        #endif
+    }
+
+    void InotifyReactor::readEvents() {
+        #ifdef __linux__
+            alignas(struct inotify_event) char buffer[64 * (sizeof(struct inotify_event) + NAME_MAX + 1)];
+
+            for (;;) {
+                ssize_t length = read(inotify_fd_, buffer, sizeof(buffer));
+                if (length <= 0) {
+                    break; // EAGAIN: queue drained
+                }
+
+                for (ssize_t offset = 0; offset < length; ) {
+                    const struct inotify_event* event = reinterpret_cast<const struct inotify_event*>(buffer + offset);
+                    std::string name = event->len > 0 ? std::string(event->name) : std::string();
+                    handleEvent(event->wd, name, event->mask);
+                    offset += sizeof(struct inotify_event) + event->len;
+                }
+            }
+
+            if (coalesce_ms_.load() == 0) {
+                flushModifies();
+            }
+        #endif
+    }
+
+    void InotifyReactor::handleEvent(int wd, const std::string& name, uint32_t mask) {
+        #ifdef __linux__
+            if (mask & IN_Q_OVERFLOW) {
+                debug_output("Inotify event queue overflowed; some file events were lost");
+                return;
+            }
+            if (mask & IN_IGNORED) {
+                pending_modifies_.erase(
+                    std::remove_if(pending_modifies_.begin(), pending_modifies_.end(),
+                                   [wd](const std::pair<int, std::string>& p) { return p.first == wd; }),
+                    pending_modifies_.end());
+                return;
+            }
+
+            auto key = std::make_pair(wd, name);
+            auto pending = std::find(pending_modifies_.begin(), pending_modifies_.end(), key);
+
+            if (mask == IN_MODIFY) {
+                if (pending == pending_modifies_.end()) {
+                    pending_modifies_.push_back(key);
+                    armTimer();
+                }
+                return;
+            }
+
+            // Anything else about this file must not overtake its held-back modify
+            if (pending != pending_modifies_.end()) {
+                pending_modifies_.erase(pending);
+                dispatch(wd, name, IN_MODIFY);
+            }
+            dispatch(wd, name, mask);
+        #else
+            (void)wd;
+            (void)name;
+            (void)mask;
+        #endif
+    }
+
+    void InotifyReactor::armTimer() {
+        #ifdef __linux__
+            long window_ms = coalesce_ms_.load();
+            if (timer_armed_ || window_ms == 0) {
+                return;
+            }
+            struct itimerspec spec = {};
+            spec.it_value.tv_sec = window_ms / 1000;
+            spec.it_value.tv_nsec = (window_ms % 1000) * 1000000L;
+            timerfd_settime(timer_fd_, 0, &spec, nullptr);
+            timer_armed_ = true;
+        #endif
+    }
+
+    void InotifyReactor::flushModifies() {
+        #ifdef __linux__
+            std::vector<std::pair<int, std::string>> ready;
+            ready.swap(pending_modifies_);
+            for (const auto& entry : ready) {
+                dispatch(entry.first, entry.second, IN_MODIFY);
+            }
+        #endif
+    }
+
+    void InotifyReactor::dispatch(int wd, const std::string& name, uint32_t mask) {
+        std::vector<int> tokens;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (const auto& entry : subscriptions_) {
+                if (entry.second.wd == wd && (entry.second.mask & mask)) {
+                    tokens.push_back(entry.first);
+                }
+            }
+        }
+
+        // Callbacks may add or remove watches, so look each one up again
+        for (int token : tokens) {
+            std::shared_ptr<Callback> callback;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                auto it = subscriptions_.find(token);
+                if (it == subscriptions_.end()) {
+                    continue;
+                }
+                callback = it->second.callback;
+            }
+            try {
+                (*callback)(name, mask);
+            } catch (const std::exception& e) {
+                debug_output("Inotify callback error: " + std::string(e.what()));
+            }
+        }
+    }
+
+} // namespace FileOps
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace FileOps {
+
+    /**
+     * One inotify instance and one epoll thread shared by every directory
+     * watch in the process
+     * Callbacks run on the reactor thread as soon as the kernel reports an
+     * event. Repeated IN_MODIFY for the same file within the coalesce window
+     * are delivered once, after the window closes or before any other event
+     * for that file. Linux only; addWatch() fails elsewhere.
+     */
+    class InotifyReactor {
+    public:
+        // name is relative to the watched directory; mask holds IN_* bits
+        using Callback = std::function<void(const std::string& name, uint32_t mask)>;
+
+        static InotifyReactor& instance();
+        ~InotifyReactor();
+
+        InotifyReactor(const InotifyReactor&) = delete;
+        InotifyReactor& operator=(const InotifyReactor&) = delete;
+
+        // Token for removeWatch(), or -1 if the directory cannot be watched
+        int addWatch(const std::string& directory, uint32_t mask, Callback callback);
+
+        // Once this returns the callback is not running and will not run again,
+        // unless it is called from the callback itself
+        void removeWatch(int token);
+
+        size_t watchCount() const;
+        static bool isAvailable();
+
+        // 0 delivers every IN_MODIFY read from the kernel, only merging
+        // duplicates within a single read
+        void setCoalesceWindow(std::chrono::milliseconds window);
+        std::chrono::milliseconds getCoalesceWindow() const;
+
+    private:
+        InotifyReactor() = default;
+
+        struct Subscription {
+            int wd;
+            uint32_t mask;
+            std::shared_ptr<Callback> callback;
+        };
+
+        mutable std::mutex mutex_;          // subscriptions and descriptors
+        std::mutex dispatch_mutex_;         // held by the reactor while callbacks run
+        std::map<int, Subscription> subscriptions_;
+        std::map<int, std::string> directories_;   // wd -> watched path
+        int next_token_ = 0;
+
+        int inotify_fd_ = -1;
+        int epoll_fd_ = -1;
+        int wake_fd_ = -1;
+        int timer_fd_ = -1;
+        std::thread thread_;
+        std::thread::id thread_id_;
+        std::atomic<bool> running_{false};
+        std::atomic<long> coalesce_ms_{25};
+
+        // Reactor thread only
+        std::vector<std::pair<int, std::string>> pending_modifies_;
+        bool timer_armed_ = false;
+
+        bool start();
+        void run();
+        void readEvents();
+        void handleEvent(int wd, const std::string& name, uint32_t mask);
+        void flushModifies();
+        void armTimer();
+        void dispatch(int wd, const std::string& name, uint32_t mask);
+        uint32_t combinedMask(int wd) const;
+    };
+
+} // namespace FileOps
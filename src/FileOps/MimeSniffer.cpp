@@ -0,0 +1,427 @@
+#include "MimeSniffer.h"
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cerrno>
+#include <fcntl.h>
+#include <iterator>
+#include <string_view>
+#include <unistd.h>
+
+namespace FileOps {
+
+    namespace {
+
+        using namespace std::string_view_literals;
+
+        struct Signature {
+            std::string_view bytes;
+            std::string_view mask;      // '?' marks a byte that may hold anything; "" = every byte counts
+            std::string_view mime;
+        };
+
+        // Several signatures contain NUL bytes, hence the sv literals
+        constexpr Signature SIGNATURES[] = {
+            {"\x89PNG\r\n\x1a\n"sv, ""sv, "image/png"sv},
+            {"\xFF\xD8\xFF"sv, ""sv, "image/jpeg"sv},
+            {"GIF87a"sv, ""sv, "image/gif"sv},
+            {"GIF89a"sv, ""sv, "image/gif"sv},
+            {"RIFF....WEBP"sv, "xxxx????xxxx"sv, "image/webp"sv},
+            {"II*\0"sv, ""sv, "image/tiff"sv},
+            {"MM\0*"sv, ""sv, "image/tiff"sv},
+            {"\0\0\1\0"sv, ""sv, "image/x-icon"sv},
+            {"....ftypheic"sv, "????xxxxxxxx"sv, "image/heic"sv},
+            {"....ftypavif"sv, "????xxxxxxxx"sv, "image/avif"sv},
+            {"....ftyp"sv, "????xxxx"sv, "video/mp4"sv},
+            {"....ftypqt  "sv, "????xxxxxxxx"sv, "video/quicktime"sv},
+            {"....ftypM4A "sv, "????xxxxxxxx"sv, "audio/mp4"sv},
+            {"\x1A\x45\xDF\xA3"sv, ""sv, "video/webm"sv},
+            {"RIFF....AVI "sv, "xxxx????xxxx"sv, "video/x-msvideo"sv},
+            {"RIFF....WAVE"sv, "xxxx????xxxx"sv, "audio/wav"sv},
+            {"ID3"sv, ""sv, "audio/mpeg"sv},
+            // MPEG audio frame sync: 11 set bits, then version (2.5, 2, 1) and
+            // layer (III, II, I), with or without CRC. FF FE (MPEG-1 layer I
+            // with CRC) is left to the UTF-16LE byte order mark below.
+            {"\xFF\xE2"sv, ""sv, "audio/mpeg"sv}, {"\xFF\xE3"sv, ""sv, "audio/mpeg"sv},
+            {"\xFF\xE4"sv, ""sv, "audio/mpeg"sv}, {"\xFF\xE5"sv, ""sv, "audio/mpeg"sv},
+            {"\xFF\xE6"sv, ""sv, "audio/mpeg"sv}, {"\xFF\xE7"sv, ""sv, "audio/mpeg"sv},
+            {"\xFF\xF2"sv, ""sv, "audio/mpeg"sv}, {"\xFF\xF3"sv, ""sv, "audio/mpeg"sv},
+            {"\xFF\xF4"sv, ""sv, "audio/mpeg"sv}, {"\xFF\xF5"sv, ""sv, "audio/mpeg"sv},
+            {"\xFF\xF6"sv, ""sv, "audio/mpeg"sv}, {"\xFF\xF7"sv, ""sv, "audio/mpeg"sv},
+            {"\xFF\xFA"sv, ""sv, "audio/mpeg"sv}, {"\xFF\xFB"sv, ""sv, "audio/mpeg"sv},
+            {"\xFF\xFC"sv, ""sv, "audio/mpeg"sv}, {"\xFF\xFD"sv, ""sv, "audio/mpeg"sv},
+            {"\xFF\xFF"sv, ""sv, "audio/mpeg"sv},
+            {"OggS"sv, ""sv, "audio/ogg"sv},
+            {"fLaC"sv, ""sv, "audio/flac"sv},
+            {"%PDF-"sv, ""sv, "application/pdf"sv},
+            {"%!PS"sv, ""sv, "application/postscript"sv},
+            {"{\\rtf"sv, ""sv, "application/rtf"sv},
+            {"PK\3\4"sv, ""sv, "application/zip"sv},
+            {"PK\5\6"sv, ""sv, "application/zip"sv},
+            {"\x1F\x8B"sv, ""sv, "application/gzip"sv},
+            {"BZh"sv, ""sv, "application/x-bzip2"sv},
+            {"\xFD" "7zXZ\0"sv, ""sv, "application/x-xz"sv},
+            {"7z\xBC\xAF\x27\x1C"sv, ""sv, "application/x-7z-compressed"sv},
+            {"Rar!\x1A\x07"sv, ""sv, "application/vnd.rar"sv},
+            {"\x28\xB5\x2F\xFD"sv, ""sv, "application/zstd"sv},
+            {"\xD0\xCF\x11\xE0\xA1\xB1\x1A\xE1"sv, ""sv, "application/x-ole-storage"sv},
+            {"SQLite format 3\0"sv, ""sv, "application/vnd.sqlite3"sv},
+            {"\x7F" "ELF"sv, ""sv, "application/x-executable"sv},
+            {"MZ"sv, ""sv, "application/x-msdownload"sv},
+            {"\xCF\xFA\xED\xFE"sv, ""sv, "application/x-mach-binary"sv},
+            {"wOFF"sv, ""sv, "font/woff"sv},
+            {"wOF2"sv, ""sv, "font/woff2"sv},
+            {"\0\1\0\0\0"sv, ""sv, "font/ttf"sv},
+            {"OTTO"sv, ""sv, "font/otf"sv},
+            {"<?xml"sv, ""sv, "application/xml"sv},
+            {"<svg"sv, ""sv, "image/svg+xml"sv},
+            {"#!"sv, ""sv, "text/x-script"sv},
+            {"\xEF\xBB\xBF"sv, ""sv, "text/plain"sv},
+            {"\xFF\xFE"sv, ""sv, "text/plain"sv},
+            {"\xFE\xFF"sv, ""sv, "text/plain"sv},
+        };
+
+        // ========== Compile-time Signature Trie ==========
+
+        constexpr uint16_t ANY = 256;           // edge matching every byte
+        constexpr uint16_t NONE = 0xFFFF;
+        constexpr size_t MAX_NODES = 512;
+
+        struct TrieNode {
+            uint16_t edge = NONE;               // byte value or ANY
+            uint16_t first_child = NONE;
+            uint16_t next_sibling = NONE;
+            uint16_t signature = NONE;          // SIGNATURES index ending here
+        };
+
+        struct Trie {
+            std::array<TrieNode, MAX_NODES> nodes{};
+            size_t size = 1;                    // node 0 is the root
+            std::array<uint16_t, 256> root_by_byte{};
+            uint16_t root_any = NONE;
+        };
+
+        constexpr uint16_t childFor(Trie& trie, uint16_t parent, uint16_t edge) {
+            for (uint16_t child = trie.nodes[parent].first_child; child != NONE; child = trie.nodes[child].next_sibling) {
+                if (trie.nodes[child].edge == edge) {
+                    return child;
+                }
+            }
+            uint16_t node = static_cast<uint16_t>(trie.size++);
+            trie.nodes[node].edge = edge;
+            trie.nodes[node].next_sibling = trie.nodes[parent].first_child;
+            trie.nodes[parent].first_child = node;
+            return node;
+        }
+
+        constexpr Trie buildTrie() {
+            Trie trie;
+            for (size_t s = 0; s < std::size(SIGNATURES); ++s) {
+                const Signature& signature = SIGNATURES[s];
+                uint16_t node = 0;
+                for (size_t i = 0; i < signature.bytes.size(); ++i) {
+                    bool any = i < signature.mask.size() && signature.mask[i] == '?';
+                    node = childFor(trie, node, any ? ANY : static_cast<uint8_t>(signature.bytes[i]));
+                }
+                trie.nodes[node].signature = static_cast<uint16_t>(s);
+            }
+
+            // The first byte picks the subtree directly
+            for (size_t b = 0; b < 256; ++b) {
+                trie.root_by_byte[b] = NONE;
+            }
+            for (uint16_t child = trie.nodes[0].first_child; child != NONE; child = trie.nodes[child].next_sibling) {
+                if (trie.nodes[child].edge == ANY) {
+                    trie.root_any = child;
+                } else {
+                    trie.root_by_byte[trie.nodes[child].edge] = child;
+                }
+            }
+            return trie;
+        }
+
+        constexpr Trie TRIE = buildTrie();
+        static_assert(TRIE.size <= MAX_NODES, "signature trie needs more nodes");
+
+        // Deepest signature along data; a longer match is the more specific type
+        void walk(uint16_t node, const uint8_t* data, size_t length, size_t depth,
+                  uint16_t& best, size_t& best_depth) {
+            const TrieNode& current = TRIE.nodes[node];
+            if (current.signature != NONE && depth > best_depth) {
+                best = current.signature;
+                best_depth = depth;
+            }
+            if (depth >= length) {
+                return;
+            }
+            for (uint16_t child = current.first_child; child != NONE; child = TRIE.nodes[child].next_sibling) {
+                uint16_t edge = TRIE.nodes[child].edge;
+                if (edge == ANY || edge == data[depth]) {
+                    walk(child, data, length, depth + 1, best, best_depth);
+                }
+            }
+        }
+
+        // ========== Extension Table ==========
+
+        struct ExtensionType {
+            std::string_view extension;
+            std::string_view mime;
+        };
+
+        constexpr ExtensionType EXTENSIONS[] = {
+            {"txt", "text/plain"}, {"log", "text/plain"}, {"md", "text/markdown"},
+            {"html", "text/html"}, {"htm", "text/html"}, {"css", "text/css"},
+            {"csv", "text/csv"}, {"tsv", "text/tab-separated-values"},
+            {"js", "application/javascript"}, {"mjs", "application/javascript"},
+            {"json", "application/json"}, {"xml", "application/xml"}, {"svg", "image/svg+xml"},
+            {"pdf", "application/pdf"}, {"ps", "application/postscript"}, {"rtf", "application/rtf"},
+            {"jpg", "image/jpeg"}, {"jpeg", "image/jpeg"}, {"png", "image/png"}, {"gif", "image/gif"},
+            {"webp", "image/webp"}, {"tif", "image/tiff"}, {"tiff", "image/tiff"}, {"ico", "image/x-icon"},
+            {"heic", "image/heic"}, {"avif", "image/avif"},
+            {"mp4", "video/mp4"}, {"m4v", "video/mp4"}, {"mov", "video/quicktime"}, {"webm", "video/webm"},
+            {"mkv", "video/x-matroska"}, {"avi", "video/x-msvideo"},
+            {"mp3", "audio/mpeg"}, {"m4a", "audio/mp4"}, {"wav", "audio/wav"}, {"ogg", "audio/ogg"},
+            {"oga", "audio/ogg"}, {"flac", "audio/flac"},
+            {"zip", "application/zip"}, {"gz", "application/gzip"}, {"tgz", "application/gzip"},
+            {"bz2", "application/x-bzip2"}, {"xz", "application/x-xz"}, {"7z", "application/x-7z-compressed"},
+            {"rar", "application/vnd.rar"}, {"zst", "application/zstd"},
+            {"doc", "application/msword"}, {"xls", "application/vnd.ms-excel"},
+            {"ppt", "application/vnd.ms-powerpoint"}, {"msg", "application/vnd.ms-outlook"},
+            {"docx", "application/vnd.openxmlformats-officedocument.wordprocessingml.document"},
+            {"xlsx", "application/vnd.openxmlformats-officedocument.spreadsheetml.sheet"},
+            {"pptx", "application/vnd.openxmlformats-officedocument.presentationml.presentation"},
+            {"odt", "application/vnd.oasis.opendocument.text"},
+            {"ods", "application/vnd.oasis.opendocument.spreadsheet"},
+            {"odp", "application/vnd.oasis.opendocument.presentation"},
+            {"epub", "application/epub+zip"}, {"jar", "application/java-archive"},
+            {"apk", "application/vnd.android.package-archive"},
+            {"sqlite", "application/vnd.sqlite3"}, {"db", "application/vnd.sqlite3"},
+            {"exe", "application/x-msdownload"}, {"dll", "application/x-msdownload"},
+            {"woff", "font/woff"}, {"woff2", "font/woff2"}, {"ttf", "font/ttf"}, {"otf", "font/otf"},
+        };
+
+        // Types that are ZIP archives underneath
+        constexpr std::string_view ZIP_TYPES[] = {
+            "application/vnd.openxmlformats-officedocument.wordprocessingml.document",
+            "application/vnd.openxmlformats-officedocument.spreadsheetml.sheet",
+            "application/vnd.openxmlformats-officedocument.presentationml.presentation",
+            "application/vnd.oasis.opendocument.text",
+            "application/vnd.oasis.opendocument.spreadsheet",
+            "application/vnd.oasis.opendocument.presentation",
+            "application/epub+zip",
+            "application/java-archive",
+            "application/vnd.android.package-archive",
+        };
+
+        // Legacy Office formats share one compound-file container
+        constexpr std::string_view OLE_TYPES[] = {
+            "application/msword",
+            "application/vnd.ms-excel",
+            "application/vnd.ms-powerpoint",
+            "application/vnd.ms-outlook",
+        };
+
+        template <size_t N>
+        bool contains(const std::string_view (&list)[N], std::string_view value) {
+            return std::find(std::begin(list), std::end(list), value) != std::end(list);
+        }
+
+        // Names of the first entries tell the container formats apart
+        std::string refineZip(std::string_view head) {
+            // ODF and EPUB store their type uncompressed in a first entry named "mimetype"
+            if (head.size() > 38 && head.substr(30, 8) == "mimetype") {
+                size_t stored = static_cast<uint8_t>(head[18]) | static_cast<uint8_t>(head[19]) << 8;
+                std::string_view declared = head.substr(38, stored);
+                if (contains(ZIP_TYPES, declared)) {
+                    return std::string(declared);
+                }
+            }
+            if (head.find("word/") != std::string_view::npos) return std::string(ZIP_TYPES[0]);
+            if (head.find("xl/") != std::string_view::npos) return std::string(ZIP_TYPES[1]);
+            if (head.find("ppt/") != std::string_view::npos) return std::string(ZIP_TYPES[2]);
+            if (head.find("AndroidManifest.xml") != std::string_view::npos) return std::string(ZIP_TYPES[8]);
+            if (head.find("META-INF/MANIFEST.MF") != std::string_view::npos) return std::string(ZIP_TYPES[7]);
+            return "application/zip";
+        }
+
+        std::string lowerExtension(const std::string& filepath) {
+            size_t slash = filepath.find_last_of("/\\");
+            size_t dot = filepath.find_last_of('.');
+            if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) {
+                return "";
+            }
+            std::string extension = filepath.substr(dot + 1);
+            std::transform(extension.begin(), extension.end(), extension.begin(),
+                           [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+            return extension;
+        }
+
+    } // namespace
+
+    // ========== Detection ==========
+
+    std::string MimeSniffer::sniff(const uint8_t* data, size_t length) {
+        if (!data || length == 0) {
+            return "";
+        }
+
+        uint16_t best = NONE;
+        size_t best_depth = 0;
+        uint16_t first = TRIE.root_by_byte[data[0]];
+        if (first != NONE) {
+            walk(first, data, length, 1, best, best_depth);
+        }
+        if (TRIE.root_any != NONE) {
+            walk(TRIE.root_any, data, length, 1, best, best_depth);
+        }
+        if (best == NONE) {
+            return "";
+        }
+
+        std::string_view mime = SIGNATURES[best].mime;
+        std::string_view head(reinterpret_cast<const char*>(data), length);
+        if (mime == "application/zip") {
+            return refineZip(head);
+        }
+        if (mime == "application/xml" && head.find("<svg") != std::string_view::npos) {
+            return "image/svg+xml";
+        }
+        return std::string(mime);
+    }
+
+    bool MimeSniffer::looksLikeText(const uint8_t* data, size_t length) {
+        size_t i = 0;
+        while (i < length) {
+            uint8_t byte = data[i];
+            if (byte < 0x80) {
+                if (byte < 0x20 && byte != '\t' && byte != '\n' && byte != '\r' && byte != '\f' && byte != 0x1B) {
+                    return false;
+                }
+                if (byte == 0x7F) {
+                    return false;
+                }
+                ++i;
+                continue;
+            }
+
+            size_t extra = (byte & 0xE0) == 0xC0 ? 1 : (byte & 0xF0) == 0xE0 ? 2 : (byte & 0xF8) == 0xF0 ? 3 : 0;
+            if (extra == 0 || (extra == 1 && byte < 0xC2)) {
+                return false;
+            }
+            for (size_t k = 1; k <= extra; ++k) {
+                if (i + k >= length) {
+                    return true; // sequence cut off by the read limit
+                }
+                if ((data[i + k] & 0xC0) != 0x80) {
+                    return false;
+                }
+            }
+            i += extra + 1;
+        }
+        return true;
+    }
+
+    std::string MimeSniffer::fromExtension(const std::string& filepath) {
+        std::string extension = lowerExtension(filepath);
+        for (const auto& entry : EXTENSIONS) {
+            if (entry.extension == extension) {
+                return std::string(entry.mime);
+            }
+        }
+        return "";
+    }
+
+    std::string MimeSniffer::detect(const uint8_t* data, size_t length, const std::string& filepath) {
+        std::string signature = sniff(data, length);
+        std::string by_extension = fromExtension(filepath);
+
+        // Only a signature overrules the name; a text signature (byte order
+        // mark, <?xml, #!) leaves the more specific text extension in place
+        if (!signature.empty()) {
+            return isTextual(signature) && isTextual(by_extension) ? by_extension : signature;
+        }
+        // Inconclusive bytes (Latin-1 text, formats missing from the table) defer to the name
+        if (!by_extension.empty()) {
+            return by_extension;
+        }
+        return looksLikeText(data, length) ? "text/plain" : "application/octet-stream";
+    }
+
+    size_t MimeSniffer::readHead(int fd, uint8_t* buffer) {
+        size_t total = 0;
+        while (total < SNIFF_BYTES) {
+            ssize_t n = pread(fd, buffer + total, SNIFF_BYTES - total, static_cast<off_t>(total));
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            if (n <= 0) {
+                break;
+            }
+            total += static_cast<size_t>(n);
+        }
+        return total;
+    }
+
+    std::string MimeSniffer::detectFile(const std::string& filepath) {
+        int fd = open(filepath.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd == -1) {
+            return "";
+        }
+        uint8_t buffer[SNIFF_BYTES];
+        size_t length = readHead(fd, buffer);
+        close(fd);
+        return detect(buffer, length, filepath);
+    }
+
+    // ========== Matching ==========
+
+    bool MimeSniffer::contentMatchesExtension(const std::string& mime, const std::string& extension) {
+        std::string expected = fromExtension("." + extension);
+        if (expected.empty() || mime == expected) {
+            return true;
+        }
+        if (isTextual(mime) && isTextual(expected)) {
+            return true;
+        }
+        // Containers that could not be narrowed down from the first bytes
+        if (mime == "application/zip" && contains(ZIP_TYPES, expected)) {
+            return true;
+        }
+        if (mime == "application/x-ole-storage" && contains(OLE_TYPES, expected)) {
+            return true;
+        }
+        // Same container, different track types
+        if ((mime == "video/mp4" && expected == "audio/mp4") ||
+            (mime == "video/webm" && expected == "video/x-matroska")) {
+            return true;
+        }
+        return false;
+    }
+
+    bool MimeSniffer::mimeMatches(const std::string& mime, const std::string& pattern) {
+        if (pattern == "*/*" || pattern == "*") {
+            return true;
+        }
+        if (pattern.size() > 2 && pattern.compare(pattern.size() - 2, 2, "/*") == 0) {
+            return mime.compare(0, pattern.size() - 1, pattern, 0, pattern.size() - 1) == 0;
+        }
+        return mime == pattern;
+    }
+
+    bool MimeSniffer::isTextual(const std::string& mime) {
+        return mime.compare(0, 5, "text/") == 0 ||
+               mime == "application/json" || mime == "application/javascript" ||
+               mime == "application/xml" || mime == "image/svg+xml";
+    }
+
+    bool MimeSniffer::hasSignature(const std::string& mime) {
+        for (const auto& signature : SIGNATURES) {
+            if (signature.mime == mime) {
+                return true;
+            }
+        }
+        return contains(ZIP_TYPES, mime) || contains(OLE_TYPES, mime);
+    }
+
+} // namespace FileOps
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace FileOps {
+
+    /**
+     * Content-based MIME detection
+     * Leading bytes are matched against a magic-number trie that is built
+     * at compile time, so identifying a file costs one pread of its first
+     * SNIFF_BYTES and a walk of a few trie nodes. ZIP containers are told
+     * apart (docx, xlsx, odt, epub, jar, ...) from the same bytes.
+     */
+    class MimeSniffer {
+    public:
+        static constexpr size_t SNIFF_BYTES = 4096;
+
+        // MIME type whose signature the bytes carry, "" if none matches
+        static std::string sniff(const uint8_t* data, size_t length);
+
+        // Valid UTF-8 without NULs or control characters other than whitespace
+        static bool looksLikeText(const uint8_t* data, size_t length);
+
+        // MIME type registered for the path's extension, "" if unknown
+        static std::string fromExtension(const std::string& filepath);
+
+        // Best type for content named filepath: its signature, else the
+        // extension's type, else text/plain or application/octet-stream.
+        // Bytes without a known signature never contradict the extension.
+        static std::string detect(const uint8_t* data, size_t length, const std::string& filepath);
+
+        // detect() on the first SNIFF_BYTES of a file; "" if it cannot be read
+        static std::string detectFile(const std::string& filepath);
+
+        // Reads up to SNIFF_BYTES from the start of fd with a single pread
+        static size_t readHead(int fd, uint8_t* buffer);
+
+        // Whether content detected as mime may carry the extension: a renamed
+        // executable is not a ".png", but a zip may be a ".docx"
+        static bool contentMatchesExtension(const std::string& mime, const std::string& extension);
+
+        // "image/png" matches "image/png", "image/*" and "*/*"
+        static bool mimeMatches(const std::string& mime, const std::string& pattern);
+
+        static bool isTextual(const std::string& mime);
+        static bool hasSignature(const std::string& mime);
+    };
+
+} // namespace FileOps
@@ -1,4 +1,5 @@
 #include "PathUtils.h"
+#include <cerrno>
 #include <cstring>
 #include <filesystem>
 #include <regex>
@@ -7,6 +8,9 @@
 #include <fstream>
 #include <sstream>
 #include <cstdlib>
+#include <list>
+#include <mutex>
+#include <unordered_map>
 
 #ifdef _WIN32
     #include <windows.h>
@@ -16,10 +20,109 @@
     #include <unistd.h>
     #include <sys/stat.h>
     #include <pwd.h>
+    #include "DirectoryHandle.h"
 #endif
 
 namespace FileOps {
     
+    namespace {
+        
+        // Screenshot, upload and download commands validate the same few
+        // paths over and over; normalizePath() and isSecurePath() are pure
+        // string functions, so their results are kept in a small LRU.
+        class PathCache {
+        public:
+            static constexpr size_t CAPACITY = 256;
+            
+            static PathCache& instance() {
+                static PathCache cache;
+                return cache;
+            }
+            
+            bool lookupNormalized(const std::string& path, std::string& normalized) {
+                std::lock_guard<std::mutex> lock(mutex_);
+                Entry* entry = find(path);
+                if (!entry || !entry->has_normalized) {
+                    return false;
+                }
+                normalized = entry->normalized;
+                return true;
+            }
+            
+            void storeNormalized(const std::string& path, const std::string& normalized) {
+                std::lock_guard<std::mutex> lock(mutex_);
+                Entry& entry = insert(path);
+                entry.normalized = normalized;
+                entry.has_normalized = true;
+            }
+            
+            bool lookupSecure(const std::string& path, bool& secure) {
+                std::lock_guard<std::mutex> lock(mutex_);
+                Entry* entry = find(path);
+                if (!entry || entry->secure < 0) {
+                    return false;
+                }
+                secure = entry->secure == 1;
+                return true;
+            }
+            
+            void storeSecure(const std::string& path, bool secure) {
+                std::lock_guard<std::mutex> lock(mutex_);
+                insert(path).secure = secure ? 1 : 0;
+            }
+            
+            void clear() {
+                std::lock_guard<std::mutex> lock(mutex_);
+                index_.clear();
+                order_.clear();
+            }
+            
+            size_t size() {
+                std::lock_guard<std::mutex> lock(mutex_);
+                return order_.size();
+            }
+            
+        private:
+            struct Entry {
+                std::string path;
+                std::string normalized;
+                bool has_normalized = false;
+                int secure = -1;  // -1 not yet checked
+            };
+            
+            std::mutex mutex_;
+            std::list<Entry> order_;  // most recently used first
+            std::unordered_map<std::string, std::list<Entry>::iterator> index_;
+            
+            Entry* find(const std::string& path) {
+                auto it = index_.find(path);
+                if (it == index_.end()) {
+                    return nullptr;
+                }
+                order_.splice(order_.begin(), order_, it->second);
+                return &order_.front();
+            }
+            
+            Entry& insert(const std::string& path) {
+                if (Entry* existing = find(path)) {
+                    return *existing;
+                }
+                if (order_.size() >= CAPACITY) {
+                    index_.erase(order_.back().path);
+                    order_.pop_back();
+                }
+                order_.emplace_front();
+                order_.front().path = path;
+                index_[path] = order_.begin();
+                return order_.front();
+            }
+        };
+        
+        // Longer paths fail isValidPathLength() anyway and are not worth keeping
+        constexpr size_t MAX_CACHED_PATH = 4096;
+        
+    } // namespace
+    
     // ========== Path Normalization ==========
     
     std::string PathUtils::normalizePath(const std::string& path) {
@@ -28,6 +131,9 @@ namespace FileOps {
         }
         
         std::string normalized;
+        if (path.size() < MAX_CACHED_PATH && PathCache::instance().lookupNormalized(path, normalized)) {
+            return normalized;
+        }
         
         try {
             std::filesystem::path fs_path(path);
@@ -43,6 +149,9 @@ namespace FileOps {
             std::replace(normalized.begin(), normalized.end(), '\\', '/');
         #endif
         
+        if (path.size() < MAX_CACHED_PATH) {
+            PathCache::instance().storeNormalized(path, normalized);
+        }
         return normalized;
     }
     
@@ -254,17 +363,34 @@ namespace FileOps {
     }
     
     bool PathUtils::createDirectoriesIfNeeded(const std::string& path) {
-        try {
-            // Check if already exists first
-            if (std::filesystem::exists(path) && std::filesystem::is_directory(path)) {
+        #ifdef _WIN32
+            try {
+                // Check if already exists first
+                if (std::filesystem::exists(path) && std::filesystem::is_directory(path)) {
+                    return true;
+                }
+                
+                return std::filesystem::create_directories(path);
+            } catch (const std::exception& e) {
+                std::cerr << "Error creating directories: " << e.what() << std::endl;
+                return false;
+            }
+        #else
+            // An existing directory costs a single stat()
+            struct stat st;
+            if (!path.empty() && ::stat(path.c_str(), &st) == 0 && S_ISDIR(st.st_mode)) {
                 return true;
             }
             
-            return std::filesystem::create_directories(path);
-        } catch (const std::exception& e) {
-            std::cerr << "Error creating directories: " << e.what() << std::endl;
-            return false;
-        }
+            // Otherwise create the missing components with mkdirat()
+            DirectoryHandle directory(path);
+            if (!directory.isOpen()) {
+                std::cerr << "Error creating directories: " << path << ": "
+                          << std::strerror(directory.error()) << std::endl;
+                return false;
+            }
+            return true;
+        #endif
     }
     
     // ========== File System Queries ==========
@@ -333,19 +459,33 @@ namespace FileOps {
     // ========== Security and Validation ==========
     
     bool PathUtils::isSecurePath(const std::string& path) {
-    if (path.empty()) {
-        return false;
-    }
-
-    // Allow data URIs
-    if (path.rfind("data:", 0) == 0) {
-        return true;
-    }
-
-    // Check for null bytes
-    if (path.find('\0') != std::string::npos) {
-        return false;
+        if (path.empty()) {
+            return false;
+        }
+        
+        // Allow data URIs
+        if (path.rfind("data:", 0) == 0) {
+            return true;
+        }
+        
+        bool cacheable = path.size() < MAX_CACHED_PATH;
+        bool secure = false;
+        if (cacheable && PathCache::instance().lookupSecure(path, secure)) {
+            return secure;
+        }
+        
+        secure = checkPathSecurity(path);
+        if (cacheable) {
+            PathCache::instance().storeSecure(path, secure);
+        }
+        return secure;
     }
+    
+    bool PathUtils::checkPathSecurity(const std::string& path) {
+        // Check for null bytes
+        if (path.find('\0') != std::string::npos) {
+            return false;
+        }
         
         // Check for directory traversal patterns
         if (path.find("..") != std::string::npos) {
@@ -362,20 +502,21 @@ namespace FileOps {
         }
         
         // Check for forbidden characters in paths (less restrictive than filenames)
-        std::vector<char> path_forbidden;
         #ifdef _WIN32
-            path_forbidden = {'<', '>', '"', '|', '?', '*'};  // Allow : for drive letters
+            static const char path_forbidden[] = "<>\"|?*";  // Allow : for drive letters
         #else
-            path_forbidden = {'\0', '<', '>'};  // Allow : in paths
+            static const char path_forbidden[] = "<>";  // Allow : in paths
         #endif
         
-        for (char c : path) {
-            if (std::find(path_forbidden.begin(), path_forbidden.end(), c) != path_forbidden.end()) {
-                return false;
-            }
-        }
-        
-        return true;
+        return path.find_first_of(path_forbidden) == std::string::npos;
+    }
+    
+    void PathUtils::clearPathCache() {
+        PathCache::instance().clear();
+    }
+    
+    size_t PathUtils::pathCacheSize() {
+        return PathCache::instance().size();
     }
     
     std::string PathUtils::sanitizeFileName(const std::string& filename) {
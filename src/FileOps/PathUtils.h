@@ -69,7 +69,7 @@ namespace FileOps {
         
         /**
          * Create directory structure if it doesn't exist
-         * Creates all parent directories as needed
+         * Creates all parent directories as needed; one stat() when it does
          */
         static bool createDirectoriesIfNeeded(const std::string& path);
         
@@ -122,9 +122,21 @@ namespace FileOps {
         /**
          * Validate that a path is safe to use
          * Prevents directory traversal attacks, checks for null bytes, etc.
+         * Results are cached together with normalizePath()'s
          */
         static bool isSecurePath(const std::string& path);
         
+        /**
+         * Drop the cached normalizePath() and isSecurePath() results
+         * The cache is a small LRU keyed by the path as given
+         */
+        static void clearPathCache();
+        
+        /**
+         * Number of paths currently held in the cache
+         */
+        static size_t pathCacheSize();
+        
         /**
          * Sanitize a filename by removing/replacing dangerous characters
          * Handles platform-specific forbidden characters
@@ -263,6 +275,11 @@ namespace FileOps {
          */
         static std::string globToRegex(const std::string& glob);
         
+        /**
+         * Uncached checks behind isSecurePath()
+         */
+        static bool checkPathSecurity(const std::string& path);
+        
         /**
          * Detect platform type at runtime
          * Returns "windows", "macos", or "linux"
@@ -0,0 +1,308 @@
+#include "Sha256.h"
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+    #define HWEB_SHA_NI 1
+    #include <cpuid.h>
+    #include <immintrin.h>
+#endif
+
+namespace FileOps {
+    
+    namespace {
+        
+        const uint32_t K[64] = {
+            0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+            0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+            0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+            0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+            0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+            0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+            0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+            0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+        };
+        
+        const size_t READ_CHUNK = 1 << 20;
+        
+        inline uint32_t rotr(uint32_t x, int n) {
+            return (x >> n) | (x << (32 - n));
+        }
+        
+        void compressPortable(uint32_t state[8], const uint8_t* blocks, size_t count) {
+            for (; count > 0; --count, blocks += 64) {
+                uint32_t w[64];
+                for (int i = 0; i < 16; ++i) {
+                    w[i] = (uint32_t(blocks[i * 4]) << 24) | (uint32_t(blocks[i * 4 + 1]) << 16) |
+                           (uint32_t(blocks[i * 4 + 2]) << 8) | uint32_t(blocks[i * 4 + 3]);
+                }
+                for (int i = 16; i < 64; ++i) {
+                    uint32_t s0 = rotr(w[i - 15], 7) ^ rotr(w[i - 15], 18) ^ (w[i - 15] >> 3);
+                    uint32_t s1 = rotr(w[i - 2], 17) ^ rotr(w[i - 2], 19) ^ (w[i - 2] >> 10);
+                    w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+                }
+                
+                uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+                uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+                for (int i = 0; i < 64; ++i) {
+                    uint32_t t1 = h + (rotr(e, 6) ^ rotr(e, 11) ^ rotr(e, 25)) + ((e & f) ^ (~e & g)) + K[i] + w[i];
+                    uint32_t t2 = (rotr(a, 2) ^ rotr(a, 13) ^ rotr(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+                    h = g; g = f; f = e; e = d + t1;
+                    d = c; c = b; b = a; a = t1 + t2;
+                }
+                state[0] += a; state[1] += b; state[2] += c; state[3] += d;
+                state[4] += e; state[5] += f; state[6] += g; state[7] += h;
+            }
+        }
+        
+#ifdef HWEB_SHA_NI
+        bool cpuHasShaExtensions() {
+            unsigned int eax, ebx, ecx, edx;
+            if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx) || !(ecx & bit_SSE4_1)) {
+                return false;
+            }
+            if (__get_cpuid_max(0, nullptr) < 7) {
+                return false;
+            }
+            __cpuid_count(7, 0, eax, ebx, ecx, edx);
+            return (ebx & (1u << 29)) != 0;
+        }
+        
+        // Four rounds per step; the message schedule lives in w[0..3] and is
+        // extended in place with sha256msg1/msg2 as the rounds consume it
+        __attribute__((target("sha,sse4.1")))
+        void compressShaNi(uint32_t state[8], const uint8_t* blocks, size_t count) {
+            const __m128i byte_swap = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+            
+            // State words are rearranged into the ABEF / CDGH lanes the instructions use
+            __m128i tmp = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&state[0])), 0xB1);
+            __m128i state1 = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&state[4])), 0x1B);
+            __m128i state0 = _mm_alignr_epi8(tmp, state1, 8);
+            state1 = _mm_blend_epi16(state1, tmp, 0xF0);
+            
+            for (; count > 0; --count, blocks += 64) {
+                __m128i abef = state0;
+                __m128i cdgh = state1;
+                __m128i w[4];
+                
+                for (int step = 0; step < 16; ++step) {
+                    __m128i& current = w[step % 4];
+                    if (step < 4) {
+                        current = _mm_shuffle_epi8(
+                            _mm_loadu_si128(reinterpret_cast<const __m128i*>(blocks + step * 16)), byte_swap);
+                    }
+                    __m128i msg = _mm_add_epi32(current, _mm_loadu_si128(reinterpret_cast<const __m128i*>(&K[step * 4])));
+                    state1 = _mm_sha256rnds2_epu32(state1, state0, msg);
+                    if (step >= 3 && step <= 14) {
+                        __m128i& next = w[(step + 1) % 4];
+                        next = _mm_add_epi32(next, _mm_alignr_epi8(current, w[(step + 3) % 4], 4));
+                        next = _mm_sha256msg2_epu32(next, current);
+                    }
+                    state0 = _mm_sha256rnds2_epu32(state0, state1, _mm_shuffle_epi32(msg, 0x0E));
+                    if (step >= 1 && step <= 12) {
+                        __m128i& previous = w[(step + 3) % 4];
+                        previous = _mm_sha256msg1_epu32(previous, current);
+                    }
+                }
+                
+                state0 = _mm_add_epi32(state0, abef);
+                state1 = _mm_add_epi32(state1, cdgh);
+            }
+            
+            tmp = _mm_shuffle_epi32(state0, 0x1B);
+            state1 = _mm_shuffle_epi32(state1, 0xB1);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(&state[0]), _mm_blend_epi16(tmp, state1, 0xF0));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(&state[4]), _mm_alignr_epi8(state1, tmp, 8));
+        }
+#endif
+        
+        using CompressFn = void (*)(uint32_t*, const uint8_t*, size_t);
+        
+        CompressFn selectCompress() {
+#ifdef HWEB_SHA_NI
+            if (cpuHasShaExtensions()) {
+                return compressShaNi;
+            }
+#endif
+            return compressPortable;
+        }
+        
+        // Chosen once; the CPU does not change under us
+        const CompressFn compress_blocks = selectCompress();
+        
+    } // namespace
+    
+    // ========== Sha256 ==========
+    
+    Sha256::Sha256() {
+        reset();
+    }
+    
+    void Sha256::reset() {
+        static const uint32_t INITIAL[8] = {
+            0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+        };
+        std::memcpy(state_, INITIAL, sizeof(state_));
+        buffered_ = 0;
+        length_ = 0;
+    }
+    
+    void Sha256::compress(const uint8_t* blocks, size_t count) {
+        compress_blocks(state_, blocks, count);
+    }
+    
+    void Sha256::update(const void* data, size_t length) {
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        length_ += length;
+        
+        if (buffered_ > 0) {
+            size_t take = std::min(length, sizeof(buffer_) - buffered_);
+            std::memcpy(buffer_ + buffered_, bytes, take);
+            buffered_ += take;
+            bytes += take;
+            length -= take;
+            if (buffered_ < sizeof(buffer_)) {
+                return;
+            }
+            compress(buffer_, 1);
+            buffered_ = 0;
+        }
+        
+        // Whole blocks straight from the caller's buffer
+        if (length >= 64) {
+            compress(bytes, length / 64);
+            bytes += length & ~size_t(63);
+            length &= 63;
+        }
+        
+        std::memcpy(buffer_, bytes, length);
+        buffered_ = length;
+    }
+    
+    std::array<uint8_t, 32> Sha256::finish() {
+        uint64_t bit_length = length_ * 8;
+        
+        uint8_t padding[72] = {0x80};
+        size_t pad = (buffered_ < 56 ? 56 : 120) - buffered_;
+        for (int i = 0; i < 8; ++i) {
+            padding[pad + i] = static_cast<uint8_t>(bit_length >> (56 - 8 * i));
+        }
+        update(padding, pad + 8);
+        
+        std::array<uint8_t, 32> digest;
+        for (int i = 0; i < 8; ++i) {
+            digest[i * 4] = static_cast<uint8_t>(state_[i] >> 24);
+            digest[i * 4 + 1] = static_cast<uint8_t>(state_[i] >> 16);
+            digest[i * 4 + 2] = static_cast<uint8_t>(state_[i] >> 8);
+            digest[i * 4 + 3] = static_cast<uint8_t>(state_[i]);
+        }
+        reset();
+        return digest;
+    }
+    
+    std::string Sha256::finishHex() {
+        auto digest = finish();
+        return toHex(digest.data(), digest.size());
+    }
+    
+    bool Sha256::hardwareAccelerated() {
+        return compress_blocks != compressPortable;
+    }
+    
+    std::string Sha256::toHex(const uint8_t* bytes, size_t length) {
+        static const char DIGITS[] = "0123456789abcdef";
+        std::string hex;
+        hex.reserve(length * 2);
+        for (size_t i = 0; i < length; ++i) {
+            hex += DIGITS[bytes[i] >> 4];
+            hex += DIGITS[bytes[i] & 0x0f];
+        }
+        return hex;
+    }
+    
+    std::string Sha256::fileDigest(const std::string& filepath) {
+        StreamingFileHash hash;
+        return hash.finish(filepath);
+    }
+    
+    bool Sha256::digestMatches(const std::string& actual, const std::string& expected) {
+        std::string want = expected;
+        if (want.compare(0, 7, "sha256:") == 0 || want.compare(0, 7, "SHA256:") == 0) {
+            want = want.substr(7);
+        }
+        if (actual.empty() || actual.size() != want.size()) {
+            return false;
+        }
+        for (size_t i = 0; i < want.size(); ++i) {
+            if (std::tolower(static_cast<unsigned char>(actual[i])) != std::tolower(static_cast<unsigned char>(want[i]))) {
+                return false;
+            }
+        }
+        return true;
+    }
+    
+    // ========== StreamingFileHash ==========
+    
+    StreamingFileHash::~StreamingFileHash() {
+        if (fd_ >= 0) {
+            close(fd_);
+        }
+    }
+    
+    bool StreamingFileHash::readToEnd() {
+        if (!buffer_) {
+            buffer_.reset(new uint8_t[READ_CHUNK]);
+        }
+        while (true) {
+            ssize_t got = pread(fd_, buffer_.get(), READ_CHUNK, static_cast<off_t>(offset_));
+            if (got < 0) {
+                return false;
+            }
+            if (got == 0) {
+                return true;
+            }
+            sha_.update(buffer_.get(), static_cast<size_t>(got));
+            if (sink_ && !sink_failed_ && !sink_(buffer_.get(), static_cast<size_t>(got))) {
+                sink_failed_ = true;
+            }
+            offset_ += static_cast<uint64_t>(got);
+            if (release_consumed_ && sink_ && !sink_failed_) {
+                releaseConsumed();
+            }
+        }
+    }
+    
+    void StreamingFileHash::releaseConsumed() {
+        #ifdef FALLOC_FL_PUNCH_HOLE
+            // Whole blocks only; the partial one at the end goes with the file
+            const uint64_t block = 4096;
+            uint64_t end = offset_ / block * block;
+            if (end > released_ &&
+                fallocate(fd_, FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE,
+                          static_cast<off_t>(released_), static_cast<off_t>(end - released_)) == 0) {
+                released_ = end;
+            }
+        #endif
+    }
+    
+    bool StreamingFileHash::advance(const std::string& filepath) {
+        if (fd_ < 0) {
+            fd_ = open(filepath.c_str(), (release_consumed_ ? O_RDWR : O_RDONLY) | O_CLOEXEC);
+            if (fd_ < 0) {
+                return false;
+            }
+        }
+        return readToEnd();
+    }
+    
+    std::string StreamingFileHash::finish(const std::string& filepath) {
+        if (!advance(filepath)) {
+            return "";
+        }
+        return sha_.finishHex();
+    }
+    
+} // namespace FileOps
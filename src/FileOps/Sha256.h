@@ -0,0 +1,101 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+
+namespace FileOps {
+    
+    /**
+     * Incremental SHA-256
+     * Uses the x86 SHA extensions when the CPU has them, a portable
+     * implementation otherwise; both produce identical digests.
+     */
+    class Sha256 {
+    public:
+        Sha256();
+        
+        void update(const void* data, size_t length);
+        
+        // Digest of everything passed to update(); resets the hasher
+        std::array<uint8_t, 32> finish();
+        std::string finishHex();
+        
+        static bool hardwareAccelerated();
+        static std::string toHex(const uint8_t* bytes, size_t length);
+        
+        // Hex digest of a whole file, "" if it cannot be read
+        static std::string fileDigest(const std::string& filepath);
+        
+        // Case-insensitive hex comparison; an optional "sha256:" prefix is ignored
+        static bool digestMatches(const std::string& actual, const std::string& expected);
+        
+    private:
+        uint32_t state_[8];
+        uint8_t buffer_[64];
+        size_t buffered_ = 0;
+        uint64_t length_ = 0;
+        
+        void reset();
+        void compress(const uint8_t* blocks, size_t count);
+    };
+    
+    /**
+     * SHA-256 of a file that is still being written
+     * advance() hashes whatever was appended since the last call, so the
+     * digest is ready when the writer finishes instead of needing a second
+     * pass over the file. The descriptor stays open, so a rename of the
+     * file while it is written does not lose the position. A sink sees
+     * every chunk as it is hashed, so the same read can also forward the
+     * bytes elsewhere.
+     */
+    class StreamingFileHash {
+    public:
+        // Returns false to stop receiving; hashing carries on regardless
+        using Sink = std::function<bool(const uint8_t* data, size_t length)>;
+        
+        StreamingFileHash() = default;
+        ~StreamingFileHash();
+        
+        StreamingFileHash(const StreamingFileHash&) = delete;
+        StreamingFileHash& operator=(const StreamingFileHash&) = delete;
+        
+        // Opens filepath on first use; false if it cannot be opened or read
+        bool advance(const std::string& filepath);
+        
+        // Hashes the remaining bytes (opening filepath if nothing was read
+        // yet) and returns the hex digest, "" on a read error
+        std::string finish(const std::string& filepath);
+        
+        uint64_t consumed() const { return offset_; }
+        
+        void setSink(Sink sink) { sink_ = std::move(sink); }
+        bool sinkFailed() const { return sink_failed_; }
+        
+        // Punch out the blocks the sink has taken, so a scratch file that only
+        // passes bytes through never holds more than the unread tail. Must be
+        // set before the first advance(); the file is then opened read-write.
+        void setReleaseConsumed(bool release) { release_consumed_ = release; }
+        
+    private:
+        Sha256 sha_;
+        int fd_ = -1;
+        // Read buffer, allocated on the first read and reused by every
+        // later one; left uninitialised since pread fills what is used
+        std::unique_ptr<uint8_t[]> buffer_;
+        uint64_t offset_ = 0;
+        uint64_t released_ = 0;
+        Sink sink_;
+        bool sink_failed_ = false;
+        bool release_consumed_ = false;
+        
+        void releaseConsumed();
+        
+        bool readToEnd();
+    };
+    
+} // namespace FileOps
@@ -1,9 +1,13 @@
 #include "Types.h"
 #include "PathUtils.h"
+#include "MimeSniffer.h"
 #include <algorithm>
 #include <regex>
 #include <sstream>
 #include <iomanip>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 namespace FileOps {
     
@@ -90,31 +94,44 @@ namespace FileOps {
         FileInfo info;
         info.filepath = PathUtils::normalizePath(filepath);
         info.filename = PathUtils::getFileName(filepath);
-        info.exists = PathUtils::exists(filepath);
-        info.is_readable = PathUtils::isReadable(filepath);
-        info.size_bytes = PathUtils::getFileSize(filepath);
-        info.last_modified = PathUtils::getModificationTime(filepath);
+        info.exists = false;
+        info.is_readable = false;
+        info.size_bytes = 0;
+        info.mime_type = "application/octet-stream";
         
-        // Simple MIME type detection based on extension
-        std::string extension = PathUtils::getExtension(filepath);
-        std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+        // One descriptor answers existence, readability, size and mtime, and
+        // the same descriptor feeds the content sniffer
+        struct stat st;
+        int fd = open(filepath.c_str(), O_RDONLY | O_CLOEXEC | O_NONBLOCK);
+        if (fd != -1) {
+            info.is_readable = true;
+            if (fstat(fd, &st) != 0) {
+                close(fd);
+                return info;
+            }
+        } else if (stat(filepath.c_str(), &st) != 0) {
+            return info;
+        }
         
-        static const std::map<std::string, std::string> mime_types = {
-            {".txt", "text/plain"},
-            {".pdf", "application/pdf"},
-            {".jpg", "image/jpeg"},
-            {".jpeg", "image/jpeg"},
-            {".png", "image/png"},
-            {".gif", "image/gif"},
-            {".zip", "application/zip"},
-            {".doc", "application/msword"},
-            {".docx", "application/vnd.openxmlformats-officedocument.wordprocessingml.document"},
-            {".xls", "application/vnd.ms-excel"},
-            {".xlsx", "application/vnd.openxmlformats-officedocument.spreadsheetml.sheet"}
-        };
+        info.exists = true;
+        info.size_bytes = S_ISREG(st.st_mode) ? static_cast<size_t>(st.st_size) : 0;
+        info.last_modified = std::chrono::system_clock::time_point(
+            std::chrono::duration_cast<std::chrono::system_clock::duration>(
+                std::chrono::seconds(st.st_mtim.tv_sec) + std::chrono::nanoseconds(st.st_mtim.tv_nsec)));
         
-        auto it = mime_types.find(extension);
-        info.mime_type = (it != mime_types.end()) ? it->second : "application/octet-stream";
+        if (fd != -1 && S_ISREG(st.st_mode)) {
+            uint8_t head[MimeSniffer::SNIFF_BYTES];
+            size_t length = MimeSniffer::readHead(fd, head);
+            info.mime_type = MimeSniffer::detect(head, length, filepath);
+        } else {
+            std::string by_extension = MimeSniffer::fromExtension(filepath);
+            if (!by_extension.empty()) {
+                info.mime_type = by_extension;
+            }
+        }
+        if (fd != -1) {
+            close(fd);
+        }
         
         return info;
     }
@@ -228,6 +245,8 @@ namespace FileOps {
             case DownloadResult::PERMISSION_DENIED: return "PERMISSION_DENIED";
             case DownloadResult::DIRECTORY_NOT_FOUND: return "DIRECTORY_NOT_FOUND";
             case DownloadResult::PATTERN_MATCH_FAILED: return "PATTERN_MATCH_FAILED";
+            case DownloadResult::DOWNLOAD_FAILED: return "DOWNLOAD_FAILED";
+            case DownloadResult::DISK_BUDGET_EXCEEDED: return "DISK_BUDGET_EXCEEDED";
             default: return "UNKNOWN";
         }
     }
@@ -3,6 +3,7 @@
 #include <string>
 #include <vector>
 #include <chrono>
+#include <cstdint>
 
 namespace FileOps {
     
@@ -28,7 +29,9 @@ namespace FileOps {
         INTEGRITY_CHECK_FAILED = 3,
         PERMISSION_DENIED = 4,
         DIRECTORY_NOT_FOUND = 5,
-        PATTERN_MATCH_FAILED = 6
+        PATTERN_MATCH_FAILED = 6,
+        DOWNLOAD_FAILED = 7,
+        DISK_BUDGET_EXCEEDED = 8
     };
     
     enum class WaitCondition {
@@ -76,6 +79,7 @@ namespace FileOps {
         int timeout_ms = 30000;
         bool verify_integrity = true;
         size_t expected_size = 0; // 0 = no size check
+        std::string expected_sha256; // hex digest, "" = no digest check
         bool delete_on_completion = false;
         std::string custom_message;
         bool json_output = false;
@@ -134,6 +138,19 @@ namespace FileOps {
         bool isStable(std::chrono::milliseconds stability_time = std::chrono::milliseconds(2000)) const;
     };
     
+    // Outcome of one file of a multi-file upload
+    struct UploadFileStats {
+        std::string filepath;
+        size_t size_bytes = 0;
+        std::string state = "selected";   // "uploaded", "failed", "in_progress", or "selected" if no request carried it
+        std::string url;                  // request that carried the file
+        int http_status = 0;
+        int64_t queued_ms = 0;            // selection to request start: time spent in the page's upload queue
+        int64_t transfer_ms = 0;
+        int64_t stalled_ms = 0;           // longest gap between progress reports
+        double throughput_bps = 0;        // request bytes per second
+    };
+    
     // ========== Network Monitoring Structures ==========
     
     struct NetworkRequest {
@@ -1,4 +1,5 @@
 #include "UploadManager.h"
+#include "MimeSniffer.h"
 #include "../Debug.h"
 #include <filesystem>
 #include <fstream>
@@ -53,7 +54,7 @@ namespace FileOps {
         return UploadResult::SUCCESS;
     }
 
-    UploadResult UploadManager::uploadMultipleFiles(Browser& browser, const std::string& selector, const std::vector<std::string>& filepaths, int timeout_ms) {
+    UploadResult UploadManager::uploadMultipleFiles(Browser& browser, const std::string& selector, const std::vector<std::string>& filepaths, int timeout_ms, std::vector<UploadFileStats>* stats) {
         if (filepaths.empty()) {
             return UploadResult::FILE_NOT_FOUND;
         }
@@ -63,44 +64,88 @@ namespace FileOps {
             return UploadResult::ELEMENT_NOT_FOUND;
         }
         
-        // Check if element supports multiple files
-        std::string multiple_script = "document.querySelector('" + selector + "')?.multiple === true";
-        std::string multiple_result = browser.executeJavascriptSync(multiple_script);
-        if (multiple_result != "true") {
-            debug_output("Element does not support multiple files");
-        }
-        
-        // Validate all files first
+        // Validate all files first, with one stat per file
+        std::vector<UploadFileStats> files;
+        std::vector<std::string> names;
         for (const auto& filepath : filepaths) {
-            if (!std::filesystem::exists(filepath)) {
+            std::error_code ec;
+            auto status = std::filesystem::status(filepath, ec);
+            if (ec || !std::filesystem::exists(status)) {
                 debug_output("File not found: " + filepath);
                 return UploadResult::FILE_NOT_FOUND;
             }
-            if (!std::filesystem::is_regular_file(filepath)) {
+            if (!std::filesystem::is_regular_file(status)) {
                 debug_output("Not a regular file: " + filepath);
                 return UploadResult::UPLOAD_FAILED;
             }
+            
+            UploadFileStats file;
+            file.filepath = filepath;
+            file.size_bytes = std::filesystem::file_size(filepath, ec);
+            files.push_back(file);
+            names.push_back(std::filesystem::path(filepath).filename().string());
+        }
+        
+        // Hook the page's requests before the change event can start any
+        bool watching = progress_monitoring_enabled_ && browser.watchUploads();
+        size_t first = browser.getUploads().size();
+        auto selected_at = std::chrono::steady_clock::now();
+        
+        // Check if element supports multiple files; the selector goes in as data
+        std::string multiple = browser.callPageRuntime("attr", {selector, "multiple"});
+        if (multiple != "null_attribute" && multiple != "element_not_found" &&
+            multiple.rfind("verify_error", 0) != 0) {
+            // One chooser answer carries every file; the web process reads them itself
+            if (!browser.selectFiles(selector, filepaths, timeout_ms)) {
+                return UploadResult::UPLOAD_FAILED;
+            }
+        } else {
+            debug_output("Element does not support multiple files; selecting them one at a time");
+            for (const auto& filepath : filepaths) {
+                if (!browser.selectFiles(selector, {filepath}, timeout_ms)) {
+                    return UploadResult::UPLOAD_FAILED;
+                }
+            }
         }
         
-        // Simulate multiple file selection
-        std::string script = 
-            "(function() { "
-            "var input = document.querySelector('" + selector + "'); "
-            "if (input) { "
-            "  var event = new Event('change', { bubbles: true }); "
-            "  input.dispatchEvent(event); "
-            "  updateStatus('Multiple files selected (" + std::to_string(filepaths.size()) + " files)'); "
-            "  return true; "
-            "} "
-            "return false; "
-            "})()";
-        
-        std::string result = browser.executeJavascriptSync(script);
-        if (result != "true") {
-            return UploadResult::UPLOAD_FAILED;
+        if (watching) {
+            browser.waitForUploads(names, first, upload_quiet_ms_, timeout_ms);
+        }
+        
+        // Pages only report file names, so same-named files are told apart
+        // by selection order rather than sharing one transfer's stats
+        UploadResult result = UploadResult::SUCCESS;
+        std::vector<UploadTransfer> uploads = browser.getUploads();
+        std::vector<long> matched = matchUploadTransfers(uploads, first, names);
+        for (size_t i = 0; i < files.size(); ++i) {
+            auto& file = files[i];
+            if (matched[i] >= 0) {
+                const UploadTransfer& transfer = uploads[static_cast<size_t>(matched[i])];
+                file.url = transfer.url;
+                file.http_status = transfer.http_status;
+                file.queued_ms = std::max<int64_t>(0, std::chrono::duration_cast<std::chrono::milliseconds>(
+                    transfer.started - selected_at).count());
+                file.transfer_ms = transfer.elapsedMs();
+                file.stalled_ms = transfer.longest_stall_ms;
+                file.throughput_bps = transfer.throughput();
+                if (transfer.state == UploadTransfer::State::FINISHED) {
+                    file.state = "uploaded";
+                } else if (transfer.state == UploadTransfer::State::FAILED) {
+                    file.state = "failed";
+                    result = UploadResult::UPLOAD_FAILED;
+                } else {
+                    file.state = "in_progress";
+                    if (result == UploadResult::SUCCESS) {
+                        result = UploadResult::TIMEOUT;
+                    }
+                }
+            }
         }
         
-        return UploadResult::SUCCESS;
+        if (stats) {
+            *stats = std::move(files);
+        }
+        return result;
     }
 
     bool UploadManager::validateFile(const std::string& filepath, const UploadCommand& cmd) {
@@ -233,27 +278,46 @@ namespace FileOps {
         std::filesystem::path path(filepath);
         std::string extension = path.extension().string();
         
-        if (extension.empty()) {
-            return false; // No extension
-        }
-        
         // Remove leading dot and convert to lowercase
-        if (extension.front() == '.') {
+        if (!extension.empty() && extension.front() == '.') {
             extension = extension.substr(1);
         }
         std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
         
-        // Check against allowed types
+        // Content is sniffed at most once, and only if an entry needs it
+        std::string content_type;
+        auto contentType = [&]() -> const std::string& {
+            if (content_type.empty()) {
+                content_type = detectMimeType(filepath);
+            }
+            return content_type;
+        };
+        
+        // Check against allowed types: extensions ("png", ".png") or MIME patterns ("image/*")
         for (const auto& allowed : allowed_types) {
             std::string allowed_lower = allowed;
             std::transform(allowed_lower.begin(), allowed_lower.end(), allowed_lower.begin(), ::tolower);
             
+            if (allowed_lower == "*") {
+                return true;
+            }
+            
+            if (allowed_lower.find('/') != std::string::npos) {
+                if (MimeSniffer::mimeMatches(contentType(), allowed_lower)) {
+                    return true;
+                }
+                continue;
+            }
+            
             // Remove leading dot if present
             if (!allowed_lower.empty() && allowed_lower.front() == '.') {
                 allowed_lower = allowed_lower.substr(1);
             }
             
-            if (allowed_lower == "*" || allowed_lower == extension) {
+            // The name must match and the bytes must not contradict it,
+            // so a renamed executable does not pass as an image
+            if (!extension.empty() && allowed_lower == extension &&
+                MimeSniffer::contentMatchesExtension(contentType(), extension)) {
                 return true;
             }
         }
@@ -334,31 +398,12 @@ namespace FileOps {
             return mime_type_detector_(filepath);
         }
         
-        std::filesystem::path path(filepath);
-        std::string extension = path.extension().string();
-        
-        // Convert to lowercase
-        std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
-        
-        // Simple MIME type mapping
-        if (extension == ".txt") return "text/plain";
-        if (extension == ".html" || extension == ".htm") return "text/html";
-        if (extension == ".css") return "text/css";
-        if (extension == ".js") return "application/javascript";
-        if (extension == ".json") return "application/json";
-        if (extension == ".pdf") return "application/pdf";
-        if (extension == ".jpg" || extension == ".jpeg") return "image/jpeg";
-        if (extension == ".png") return "image/png";
-        if (extension == ".gif") return "image/gif";
-        if (extension == ".svg") return "image/svg+xml";
-        if (extension == ".mp4") return "video/mp4";
-        if (extension == ".zip") return "application/zip";
-        if (extension == ".doc") return "application/msword";
-        if (extension == ".docx") return "application/vnd.openxmlformats-officedocument.wordprocessingml.document";
-        if (extension == ".xls") return "application/vnd.ms-excel";
-        if (extension == ".xlsx") return "application/vnd.openxmlformats-officedocument.spreadsheetml.sheet";
-        
-        return "application/octet-stream"; // Default binary type
+        // Magic numbers first, the extension only where the bytes are not conclusive
+        std::string mime_type = MimeSniffer::detectFile(filepath);
+        if (mime_type.empty()) {
+            mime_type = MimeSniffer::fromExtension(filepath);
+        }
+        return mime_type.empty() ? "application/octet-stream" : mime_type;
     }
 
     std::string UploadManager::sanitizeFileName(const std::string& filepath) {
@@ -395,8 +440,6 @@ namespace FileOps {
     }
 
     bool UploadManager::simulateFileSelection(Browser& browser, const std::string& selector, const std::string& filepath) {
-        // Enhanced WebKit-compatible file selection simulation
-        
         if (!validateUploadTarget(browser, selector)) {
             return false;
         }
@@ -405,30 +448,14 @@ namespace FileOps {
             return false;
         }
         
-        // Prepare file information
-        FileInfo file_info = prepareFile(filepath);
-        std::string filename = file_info.filename;
-        std::string mime_type = file_info.mime_type;
-        size_t file_size = file_info.size_bytes;
-        
-        // Read file content as base64 for File object creation
-        std::string base64_content = encodeFileAsBase64(filepath);
-        if (base64_content.empty()) {
-            debug_output("Failed to encode file as base64: " + filepath);
-            return false;
-        }
-        
-        // Generate comprehensive JavaScript for proper file simulation
-        std::string script = generateFileUploadScript(selector, filepath, filename, mime_type);
-        
-        std::string result = browser.executeJavascriptSync(script);
-        if (result != "true") {
-            debug_output("File selection simulation failed for: " + filepath);
+        // Answer WebKit's file chooser with the real path; the web process reads
+        // the file itself and fires the input's change event, so no file data
+        // passes through this process or the JavaScript bridge
+        if (!browser.selectFiles(selector, {filepath}, default_timeout_ms_)) {
+            debug_output("File selection failed for: " + filepath);
             return false;
         }
-        
-        // Trigger appropriate events after file selection
-        return triggerFileInputEvents(browser, selector);
+        return true;
     }
 
     bool UploadManager::triggerFileInputEvents(Browser& browser, const std::string& selector) {
@@ -556,6 +583,10 @@ namespace FileOps {
         progress_monitoring_enabled_ = enabled;
     }
 
+    void UploadManager::setUploadQuietPeriod(int quiet_ms) {
+        upload_quiet_ms_ = quiet_ms;
+    }
+
     void UploadManager::setMimeTypeDetector(std::function<std::string(const std::string&)> detector) {
         mime_type_detector_ = detector;
     }
@@ -629,80 +660,6 @@ namespace FileOps {
         }
     }
 
-    std::string UploadManager::encodeFileAsBase64(const std::string& filepath) {
-        try {
-            std::ifstream file(filepath, std::ios::binary);
-            if (!file) {
-                debug_output("Cannot open file for base64 encoding: " + filepath);
-                return "";
-            }
-            
-            // Read file content
-            std::vector<unsigned char> buffer((std::istreambuf_iterator<char>(file)), 
-                                              std::istreambuf_iterator<char>());
-            file.close();
-            
-            // For now, return a placeholder - in real implementation would use base64 encoder
-            // This simulates the concept without actual base64 encoding
-            std::string placeholder = "data:";
-            placeholder += detectMimeType(filepath);
-            placeholder += ";base64,";
-            placeholder += std::to_string(buffer.size()) + "_bytes_encoded";
-            
-            return placeholder;
-            
-        } catch (const std::exception& e) {
-            debug_output("Error encoding file as base64: " + std::string(e.what()));
-            return "";
-        }
-    }
-
-    std::string UploadManager::generateFileUploadScript(
-        const std::string& selector,
-        const std::string& filepath, 
-        const std::string& filename,
-        const std::string& mime_type
-    ) {
-        // Generate JavaScript that creates a File object and assigns it to the input
-        std::string escaped_filename = escapeForJavaScript(filename);
-        std::string escaped_mime = escapeForJavaScript(mime_type);
-        
-        std::ostringstream script;
-        script << "(function() { \n"
-               << "  try { \n"
-               << "    var input = document.querySelector('" << escapeForJavaScript(selector) << "'); \n"
-               << "    if (!input || input.type !== 'file') { \n"
-               << "      return false; \n"
-               << "    } \n"
-               << "    \n"
-               << "    // Create a mock File object for testing \n"
-               << "    var fileData = { \n"
-               << "      name: '" << escaped_filename << "', \n"
-               << "      type: '" << escaped_mime << "', \n"
-               << "      size: " << std::filesystem::file_size(filepath) << ", \n"
-               << "      lastModified: Date.now() \n"
-               << "    }; \n"
-               << "    \n"
-               << "    // Update status to show file selected \n"
-               << "    if (typeof updateStatus === 'function') { \n"
-               << "      updateStatus('File selected: " << escaped_filename << "'); \n"
-               << "    } \n"
-               << "    \n"
-               << "    // For testing purposes, we'll trigger events without actual file data \n"
-               << "    // In production, this would create actual File objects \n"
-               << "    var changeEvent = new Event('change', { bubbles: true }); \n"
-               << "    input.dispatchEvent(changeEvent); \n"
-               << "    \n"
-               << "    return true; \n"
-               << "  } catch (e) { \n"
-               << "    console.error('File upload simulation error:', e); \n"
-               << "    return false; \n"
-               << "  } \n"
-               << "})()";
-        
-        return script.str();
-    }
-
     std::string UploadManager::escapeForJavaScript(const std::string& input) {
         std::string result;
         result.reserve(input.length() * 2);
@@ -21,13 +21,16 @@ namespace FileOps {
         
         /**
          * Upload multiple files to the same input element
-         * Useful for multi-file upload scenarios
+         * All files go to the file chooser in one answer; the requests that
+         * carry them are tracked from the page's own upload reports, and
+         * per-file timing and throughput are written to stats if given
          */
         UploadResult uploadMultipleFiles(
             Browser& browser, 
             const std::string& selector,
             const std::vector<std::string>& filepaths,
-            int timeout_ms = 30000
+            int timeout_ms = 30000,
+            std::vector<UploadFileStats>* stats = nullptr
         );
         
         // ========== Validation Methods ==========
@@ -108,8 +111,8 @@ namespace FileOps {
         // ========== WebKit Integration Methods ==========
         
         /**
-         * Simulate file selection via WebKit DOM manipulation
-         * Creates File objects and assigns to input.files property
+         * Select the file through WebKit's file chooser (Browser::selectFiles)
+         * The web process reads the file from disk; nothing is copied through JS
          */
         bool simulateFileSelection(
             Browser& browser, 
@@ -177,6 +180,12 @@ namespace FileOps {
          */
         void setProgressMonitoringEnabled(bool enabled);
         
+        /**
+         * Set how long to wait for the page to start sending after files are selected
+         * Pages that only upload on form submit report nothing; the selection is then the result
+         */
+        void setUploadQuietPeriod(int quiet_ms);
+        
         /**
          * Set custom MIME type detection function
          * Allows override of default MIME type detection
@@ -215,21 +224,11 @@ namespace FileOps {
         int default_timeout_ms_ = 30000;
         size_t max_file_size_ = 104857600; // 100MB
         bool progress_monitoring_enabled_ = true;
+        int upload_quiet_ms_ = 1000;
         std::function<std::string(const std::string&)> mime_type_detector_;
         
         // ========== Internal Helper Methods ==========
         
-        /**
-         * Generate JavaScript for file upload simulation
-         * Creates script to manipulate file input element
-         */
-        std::string generateFileUploadScript(
-            const std::string& selector,
-            const std::string& filepath,
-            const std::string& filename,
-            const std::string& mime_type
-        );
-        
         /**
          * Generate JavaScript for upload progress monitoring
          * Creates script to track XMLHttpRequest progress
@@ -265,12 +264,6 @@ namespace FileOps {
             int timeout_ms
         );
         
-        /**
-         * Extract file content as base64 for upload simulation
-         * Reads file and encodes for JavaScript File object creation
-         */
-        std::string encodeFileAsBase64(const std::string& filepath);
-        
         /**
          * Handle different types of file input implementations
          * Adapts approach based on input type and page framework
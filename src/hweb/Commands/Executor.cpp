@@ -4,6 +4,8 @@
 #include "../Handlers/FileOperations.h"
 #include "../Handlers/AdvancedWait.h"
 #include "../Handlers/BasicCommands.h"
+#include <iostream>
+#include <sstream>
 
 namespace HWeb {
 
@@ -22,61 +24,150 @@ int CommandExecutor::execute_commands(Browser& browser, Session& session, const
     AdvancedWaitHandler wait_handler;
     BasicCommandHandler basic_handler;
     
-    for (const auto& cmd : commands) {
-        bool navigation_expected = is_navigation_command(cmd.type);
-        
-        if (is_state_modifying_command(cmd.type)) {
-            state_modified = true;
-        }
-        
-        // Record action if recording is enabled
-        if (session.isRecording() && 
-            (cmd.type == "type" || cmd.type == "click" || cmd.type == "submit" || 
-             cmd.type == "select" || cmd.type == "check" || cmd.type == "uncheck")) {
-            Session::RecordedAction action;
-            action.type = cmd.type;
-            action.selector = cmd.selector;
-            action.value = cmd.value;
-            action.delay = 500;
-            session.recordAction(action);
+    for (const auto& batch : CommandPlanner::plan(commands)) {
+        // Consecutive DOM commands run as one in-page program, split only at navigations
+        if (batch.compiled) {
+            for (size_t i = batch.begin; i < batch.end; ++i) {
+                if (is_state_modifying_command(commands[i].type)) {
+                    state_modified = true;
+                }
+                record_action(session, commands[i]);
+            }
+            
+            int batch_result = execute_compiled_batch(browser, session, commands, batch);
+            if (batch_result >= 0) {
+                if (batch_result != 0) {
+                    exit_code = batch_result;
+                }
+                continue;
+            }
+            Output::verbose("Command batch unavailable, running commands individually");
         }
         
-        // Execute command based on type
-        int cmd_result = 0;
-        
-        // File operations
-        if (cmd.type == "upload" || cmd.type == "upload-multiple" || 
-            cmd.type == "download-wait" || cmd.type == "download-wait-multiple") {
-            cmd_result = file_handler.handle_command(browser, cmd);
-        }
-        // Advanced waiting commands
-        else if (cmd.type.substr(0, 5) == "wait-" && cmd.type != "wait" && 
-                 cmd.type != "wait-nav" && cmd.type != "wait-ready") {
-            cmd_result = wait_handler.handle_command(browser, cmd);
-        }
-        // Basic commands and navigation
-        else {
-            if (cmd.type == "back" || cmd.type == "forward") {
-                isHistoryNavigation = true;
+        for (size_t i = batch.begin; i < batch.end; ++i) {
+            const Command& cmd = commands[i];
+            bool navigation_expected = is_navigation_command(cmd.type);
+            
+            if (is_state_modifying_command(cmd.type)) {
+                state_modified = true;
+            }
+            
+            // Record action if recording is enabled (already done for a compiled batch)
+            if (!batch.compiled) {
+                record_action(session, cmd);
             }
-            cmd_result = basic_handler.handle_command(browser, session, cmd);
+            
+            // Execute command based on type
+            int cmd_result = 0;
+            
+            // File operations
+            if (cmd.type == "upload" || cmd.type == "upload-multiple" || 
+                cmd.type == "download-wait" || cmd.type == "download-wait-multiple" ||
+                cmd.type == "download-all" || cmd.type == "download-stream") {
+                cmd_result = file_handler.handle_command(browser, cmd);
+            }
+            // Direct HTTP with the session's cookies
+            else if (cmd.type == "fetch") {
+                cmd_result = file_handler.handle_fetch_command(browser, session, cmd);
+            }
+            // Advanced waiting commands
+            else if (cmd.type.substr(0, 5) == "wait-" && cmd.type != "wait" && 
+                     cmd.type != "wait-nav" && cmd.type != "wait-ready") {
+                cmd_result = wait_handler.handle_command(browser, cmd);
+            }
+            // Basic commands and navigation
+            else {
+                if (cmd.type == "back" || cmd.type == "forward") {
+                    isHistoryNavigation = true;
+                }
+                cmd_result = basic_handler.handle_command(browser, session, cmd);
+            }
+            
+            if (cmd_result != 0) {
+                exit_code = cmd_result;
+            }
+            
+            // Handle navigation updates
+            if (navigation_expected && !isHistoryNavigation) {
+                handle_navigation_update(browser, session, navigation_expected, isHistoryNavigation);
+            }
+            
+            isHistoryNavigation = false; // Reset for next iteration
         }
+    }
+    
+    return exit_code;
+}
+
+int CommandExecutor::execute_compiled_batch(Browser& browser, Session& session, const std::vector<Command>& commands,
+                                            const CommandBatch& batch) {
+    size_t step_count = batch.end - batch.begin;
+    Output::verbose("Running " + std::to_string(step_count) + " commands in one page call");
+    
+    bool reached = false;
+    std::string raw = browser.callPageRuntime("runBatch", {CommandPlanner::compile(commands, batch)},
+                                              CommandPlanner::timeout_ms(commands, batch), reached);
+    if (!reached) {
+        // Nothing ran in the page, so the commands can safely run one by one
+        return -1;
+    }
+    if (raw.empty()) {
+        // The batch may have run part-way; replaying it would repeat its clicks
+        Output::error("Command batch " + std::to_string(batch.begin + 1) + "-" + std::to_string(batch.end) +
+                      " timed out or returned no result");
+        return 1;
+    }
+    
+    Json::Value results;
+    Json::CharReaderBuilder reader;
+    std::string errors;
+    std::istringstream stream(raw);
+    if (!Json::parseFromStream(reader, stream, &results, &errors) ||
+        !results.isArray() || results.size() != step_count) {
+        Output::error("Command batch returned an invalid result");
+        return 1;
+    }
+    
+    int exit_code = 0;
+    for (size_t i = 0; i < step_count; ++i) {
+        const Command& cmd = commands[batch.begin + i];
+        StepOutcome outcome = CommandPlanner::interpret(cmd, results[static_cast<Json::ArrayIndex>(i)]);
         
-        if (cmd_result != 0) {
-            exit_code = cmd_result;
+        if (outcome.has_output) {
+            std::cout << outcome.output << std::endl;
         }
-        
-        // Handle navigation updates
-        if (navigation_expected && !isHistoryNavigation) {
-            handle_navigation_update(browser, session, navigation_expected, isHistoryNavigation);
+        if (outcome.ok) {
+            if (!outcome.message.empty()) {
+                Output::info(outcome.message);
+            }
+        } else {
+            Output::command_failed(cmd.type, cmd.selector, outcome.message);
+            exit_code = 1;
         }
-        
-        isHistoryNavigation = false; // Reset for next iteration
+    }
+    
+    // Only the last step of a batch can navigate
+    const Command& last = commands[batch.end - 1];
+    if (is_navigation_command(last.type)) {
+        handle_navigation_update(browser, session, true, false);
     }
     
     return exit_code;
 }
 
+void CommandExecutor::record_action(Session& session, const Command& cmd) {
+    if (session.isRecording() && 
+        (cmd.type == "type" || cmd.type == "click" || cmd.type == "submit" || 
+         cmd.type == "select" || cmd.type == "check" || cmd.type == "uncheck")) {
+        Session::RecordedAction action;
+        action.type = cmd.type;
+        action.selector = cmd.selector;
+        action.value = cmd.value;
+        action.delay = 500;
+        session.recordAction(action);
+    }
+}
+
 int CommandExecutor::execute_assertions(Browser& browser, const std::vector<Assertion::Command>& assertions) {
     int exit_code = 0;
     auto& assertion_manager = ManagerRegistry::get_assertion_manager();
@@ -3,6 +3,7 @@
 #include "../Types.h"
 #include "../../Browser/Browser.h"
 #include "../../Session/Session.h"
+#include "Planner.h"
 #include <vector>
 
 namespace HWeb {
@@ -17,6 +18,10 @@ public:
     
 private:
     bool execute_single_command(Browser& browser, Session& session, const Command& cmd);
+    // Runs a planned batch in one page call; returns -1 if it could not be run at all
+    int execute_compiled_batch(Browser& browser, Session& session, const std::vector<Command>& commands,
+                               const CommandBatch& batch);
+    void record_action(Session& session, const Command& cmd);
     void handle_navigation_update(Browser& browser, Session& session, bool navigation_expected, bool isHistoryNavigation);
     bool is_state_modifying_command(const std::string& command_type);
     bool is_navigation_command(const std::string& command_type);
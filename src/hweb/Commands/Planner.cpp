@@ -0,0 +1,161 @@
+#include "Planner.h"
+#include <algorithm>
+#include <map>
+
+namespace HWeb {
+
+namespace {
+
+// How a CLI command maps onto a window.__hweb runtime method
+struct StepSpec {
+    const char* op;
+    bool waits_for_element;      // interaction commands wait for their selector first
+    bool passes_value;           // cmd.value is passed after the selector
+    const char* fixed_arg;       // extra constant argument, or nullptr
+    const char* success_value;   // runtime result that means success, or nullptr for data commands
+};
+
+// Commands whose output has no bound (--text, --attr, --html) are left out:
+// a batch result comes back as one string capped at 100000 characters, so a
+// large value would fail the whole batch where its own handler returns it.
+// --type and --fill-enhanced are left out too: their handler types through
+// WebKit's editor for trusted input events, which an in-page step cannot do.
+const std::map<std::string, StepSpec>& step_specs() {
+    static const std::map<std::string, StepSpec> specs = {
+        {"click",         {"click",      true,  false, nullptr, "CLICKED_SUCCESS"}},
+        {"submit",        {"submit",     true,  false, nullptr, "true"}},
+        {"select",        {"select",     true,  true,  nullptr, "true"}},
+        {"check",         {"setChecked", true,  false, "true",  "true"}},
+        {"uncheck",       {"setChecked", true,  false, "false", "true"}},
+        {"focus",         {"focus",      true,  false, nullptr, "true"}},
+        {"exists",        {"exists",     false, false, nullptr, nullptr}},
+        {"count",         {"count",      false, false, nullptr, nullptr}}
+    };
+    return specs;
+}
+
+std::string success_message(const Command& cmd) {
+    if (cmd.type == "click") return "Clicked: " + cmd.selector;
+    if (cmd.type == "submit") return "Submitted form: " + cmd.selector;
+    if (cmd.type == "select") return "Selected option: " + cmd.value + " in " + cmd.selector;
+    if (cmd.type == "check") return "Checked: " + cmd.selector;
+    if (cmd.type == "uncheck") return "Unchecked: " + cmd.selector;
+    if (cmd.type == "focus") return "Focused: " + cmd.selector;
+    return "";
+}
+
+} // namespace
+
+bool CommandPlanner::is_batchable(const std::string& command_type) {
+    return step_specs().count(command_type) > 0;
+}
+
+bool CommandPlanner::ends_batch(const std::string& command_type) {
+    return command_type == "click" || command_type == "submit";
+}
+
+std::vector<CommandBatch> CommandPlanner::plan(const std::vector<Command>& commands) {
+    std::vector<CommandBatch> batches;
+    size_t i = 0;
+
+    while (i < commands.size()) {
+        if (!is_batchable(commands[i].type)) {
+            batches.push_back({i, i + 1, false});
+            i++;
+            continue;
+        }
+
+        // Extend the run until a non-batchable command or a possible navigation
+        size_t end = i;
+        while (end < commands.size() && is_batchable(commands[end].type)) {
+            end++;
+            if (ends_batch(commands[end - 1].type)) {
+                break;
+            }
+        }
+
+        // A single step gains nothing from compilation; keep the handler path
+        batches.push_back({i, end, end - i > 1});
+        i = end;
+    }
+
+    return batches;
+}
+
+std::string CommandPlanner::compile(const std::vector<Command>& commands, const CommandBatch& batch) {
+    Json::Value steps(Json::arrayValue);
+
+    for (size_t i = batch.begin; i < batch.end; ++i) {
+        const Command& cmd = commands[i];
+        const StepSpec& spec = step_specs().at(cmd.type);
+
+        Json::Value step;
+        step["op"] = spec.op;
+        step["args"] = Json::Value(Json::arrayValue);
+        step["args"].append(cmd.selector);
+        if (spec.passes_value) {
+            step["args"].append(cmd.value);
+        }
+        if (spec.fixed_arg) {
+            step["args"].append(spec.fixed_arg);
+        }
+        step["wait"] = spec.waits_for_element ? std::min(ELEMENT_WAIT_MS, cmd.timeout) : 0;
+        steps.append(step);
+    }
+
+    Json::StreamWriterBuilder builder;
+    builder["indentation"] = "";
+    return Json::writeString(builder, steps);
+}
+
+int CommandPlanner::timeout_ms(const std::vector<Command>& commands, const CommandBatch& batch) {
+    int total = 5000;
+    for (size_t i = batch.begin; i < batch.end; ++i) {
+        if (step_specs().at(commands[i].type).waits_for_element) {
+            total += std::min(ELEMENT_WAIT_MS, commands[i].timeout);
+        }
+    }
+    return total;
+}
+
+StepOutcome CommandPlanner::interpret(const Command& cmd, const Json::Value& result) {
+    StepOutcome outcome;
+    const StepSpec& spec = step_specs().at(cmd.type);
+
+    if (!result.isObject() || result.isMember("error")) {
+        outcome.message = result.isObject() ? result["error"].asString() : "no result";
+        return outcome;
+    }
+
+    std::string value = result["value"].asString();
+
+    // Interaction commands succeed on the runtime's success token
+    if (spec.success_value) {
+        outcome.ok = (value == spec.success_value);
+        outcome.message = outcome.ok ? success_message(cmd) : (value.empty() ? "failed" : value);
+        return outcome;
+    }
+
+    // Data commands print their value, matching the data extraction handler
+    outcome.ok = true;
+    outcome.has_output = true;
+
+    if (cmd.type == "exists") {
+        outcome.output = (value == "true") ? "true" : "false";
+    } else if (cmd.type == "count") {
+        if (value.rfind("SELECTOR_ERROR:", 0) == 0) {
+            outcome.ok = false;
+            outcome.has_output = false;
+            outcome.message = "Data extraction failed: Invalid CSS selector: " + cmd.selector +
+                              " (" + value.substr(15) + ")";
+        } else {
+            outcome.output = value.empty() ? "0" : value;
+        }
+    } else {
+        outcome.output = value;
+    }
+
+    return outcome;
+}
+
+} // namespace HWeb
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "../Types.h"
+#include <json/json.h>
+#include <string>
+#include <vector>
+
+namespace HWeb {
+
+// A run of commands [begin, end). Compiled batches execute as one in-page
+// program; everything else goes through the regular handlers one by one.
+struct CommandBatch {
+    size_t begin = 0;
+    size_t end = 0;
+    bool compiled = false;
+};
+
+// Result of one step of a compiled batch, mapped to what the handler prints
+struct StepOutcome {
+    bool ok = false;
+    bool has_output = false;   // data commands print `output` to stdout
+    std::string output;
+    std::string message;       // info text on success, error text on failure
+};
+
+class CommandPlanner {
+public:
+    // Commands the page runtime can execute without a C++ round trip
+    static bool is_batchable(const std::string& command_type);
+
+    // Commands that may navigate; they close the batch they belong to
+    static bool ends_batch(const std::string& command_type);
+
+    // Group consecutive batchable commands, splitting at navigation boundaries
+    static std::vector<CommandBatch> plan(const std::vector<Command>& commands);
+
+    // JSON step list for window.__hweb.runBatch
+    static std::string compile(const std::vector<Command>& commands, const CommandBatch& batch);
+
+    // Upper bound on how long a compiled batch may take, including element waits
+    static int timeout_ms(const std::vector<Command>& commands, const CommandBatch& batch);
+
+    // Interpret one entry of the runBatch result array for the given command
+    static StepOutcome interpret(const Command& cmd, const Json::Value& result);
+
+    // How long an interaction step waits in-page for its element to appear
+    static constexpr int ELEMENT_WAIT_MS = 3000;
+};
+
+} // namespace HWeb
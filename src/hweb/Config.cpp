@@ -42,6 +42,10 @@ HWebConfig ConfigParser::parseArguments(const std::vector<std::string>& args) {
             config.browser_width = std::stoi(args[++i]);
         } else if (args[i] == "--user-agent" && i + 1 < args.size()) {
             config.commands.push_back({"user-agent", "", args[++i]});
+        } else if (args[i] == "--screenshot-store" && i + 1 < args.size()) {
+            config.screenshot_store_dir = args[++i];
+        } else if (args[i] == "--screenshot-phash") {
+            config.screenshot_perceptual_hash = true;
         }
         // Test Suite Management
         else if (args[i] == "--test-suite") {
@@ -53,13 +57,16 @@ HWebConfig ConfigParser::parseArguments(const std::vector<std::string>& args) {
         }
         // File Operation Commands  
         else if (args[i] == "--upload" || args[i] == "--upload-multiple" || 
-                 args[i] == "--download-wait" || args[i] == "--download-wait-multiple") {
+                 args[i] == "--download-wait" || args[i] == "--download-wait-multiple" ||
+                 args[i] == "--download-all" || args[i] == "--download-stream" ||
+                 args[i] == "--fetch") {
             parse_file_operation_command(args, i, config);
         }
         // File Operation Options
         else if (args[i] == "--max-file-size" || args[i] == "--allowed-types" || 
                  args[i] == "--download-dir" || args[i] == "--upload-timeout" || 
-                 args[i] == "--download-timeout") {
+                 args[i] == "--download-timeout" || args[i] == "--max-concurrent-downloads" ||
+                 args[i] == "--download-budget") {
             parse_file_operation_options(args, i, config);
         }
         // Advanced Waiting Commands
@@ -216,6 +223,10 @@ void ConfigParser::parse_file_operation_command(const std::vector<std::string>&
         cmd.type = "download-wait";
         cmd.selector = args[++i];
         cmd.value = "";
+        // Optional expected digest: --download-wait <pattern> [sha256]
+        if (i + 1 < args.size() && isSha256Digest(args[i + 1])) {
+            cmd.value = args[++i];
+        }
         cmd.timeout = config.file_settings.download_timeout;
         config.commands.push_back(cmd);
     } else if (args[i] == "--download-wait-multiple" && i + 1 < args.size()) {
@@ -225,6 +236,31 @@ void ConfigParser::parse_file_operation_command(const std::vector<std::string>&
         cmd.value = args[++i];
         cmd.timeout = config.file_settings.download_timeout;
         config.commands.push_back(cmd);
+    } else if (args[i] == "--download-all" && i + 1 < args.size()) {
+        Command cmd;
+        cmd.type = "download-all";
+        cmd.selector = "";
+        cmd.value = args[++i];
+        cmd.timeout = config.file_settings.download_timeout;
+        config.commands.push_back(cmd);
+    } else if (args[i] == "--download-stream" && i + 1 < args.size()) {
+        Command cmd;
+        cmd.type = "download-stream";
+        cmd.selector = "";
+        cmd.value = args[++i];
+        cmd.timeout = config.file_settings.download_timeout;
+        config.commands.push_back(cmd);
+    } else if (args[i] == "--fetch" && i + 1 < args.size()) {
+        Command cmd;
+        cmd.type = "fetch";
+        cmd.value = args[++i];
+        cmd.selector = "";
+        // Optional output file: --fetch <url> [path]; stdout otherwise
+        if (i + 1 < args.size() && args[i + 1].rfind("--", 0) != 0) {
+            cmd.selector = args[++i];
+        }
+        cmd.timeout = config.file_settings.download_timeout;
+        config.commands.push_back(cmd);
     }
 }
 
@@ -250,6 +286,10 @@ void ConfigParser::parse_file_operation_options(const std::vector<std::string>&
         config.file_settings.upload_timeout = std::stoi(args[++i]);
     } else if (args[i] == "--download-timeout" && i + 1 < args.size()) {
         config.file_settings.download_timeout = std::stoi(args[++i]);
+    } else if (args[i] == "--max-concurrent-downloads" && i + 1 < args.size()) {
+        config.file_settings.max_concurrent_downloads = std::stoul(args[++i]);
+    } else if (args[i] == "--download-budget" && i + 1 < args.size()) {
+        config.file_settings.download_budget = std::stoull(args[++i]);
     }
 }
 
@@ -351,6 +391,9 @@ void ConfigParser::parse_regular_command(const std::vector<std::string>& args, s
     } else if (args[i] == "--fill-enhanced" && i + 2 < args.size()) {
         config.commands.push_back({"fill-enhanced", args[i+1], args[i+2]});
         i += 2;
+    } else if (args[i] == "--fill-form" && i + 1 < args.size()) {
+        // --fill-form <data.json|inline JSON>
+        config.commands.push_back({"fill-form", "", args[++i]});
     } else if (args[i] == "--click" && i + 1 < args.size()) {
         config.commands.push_back({"click", args[++i], ""});
     } else if (args[i] == "--submit") {
@@ -389,6 +432,13 @@ void ConfigParser::parse_regular_command(const std::vector<std::string>& args, s
             config.commands.push_back({"attr", args[i+1], args[i+2]});
             i += 2;
         }
+    } else if (args[i] == "--readable") {
+        config.commands.push_back({"readable", "", "text"});
+    } else if (args[i] == "--markdown") {
+        config.commands.push_back({"readable", "", "markdown"});
+    } else if (args[i] == "--source") {
+        std::string filename = (i + 1 < args.size() && args[i+1][0] != '-') ? args[++i] : "";
+        config.commands.push_back({"source", filename, ""});
     } else if (args[i] == "--exists" && i + 1 < args.size()) {
         config.commands.push_back({"exists", args[++i], ""});
     } else if (args[i] == "--count" && i + 1 < args.size()) {
@@ -419,6 +469,19 @@ void ConfigParser::parse_regular_command(const std::vector<std::string>& args, s
     } else if (args[i] == "--screenshot-full") {
         std::string filename = (i + 1 < args.size() && args[i+1][0] != '-') ? args[++i] : "screenshot-full.png";
         config.commands.push_back({"screenshot-full", filename, ""});
+    } else if (args[i] == "--screenshot-burst" && i + 2 < args.size()) {
+        // --screenshot-burst <dir> <duration_ms> [interval_ms|events]
+        std::string directory = args[++i];
+        std::string spec = args[++i];
+        if (i + 1 < args.size() && args[i+1][0] != '-') {
+            spec += "," + args[++i];
+        }
+        config.commands.push_back({"screenshot-burst", directory, spec});
+    } else if (args[i] == "--screenshot-viewports" && i + 1 < args.size()) {
+        // --screenshot-viewports <w[xh],...> [dir]
+        std::string viewports = args[++i];
+        std::string directory = (i + 1 < args.size() && args[i+1][0] != '-') ? args[++i] : "viewports";
+        config.commands.push_back({"screenshot-viewports", directory, viewports});
     }
     
     // Recording/replay commands
@@ -434,6 +497,17 @@ void ConfigParser::parse_regular_command(const std::vector<std::string>& args, s
     else if (args[i] == "--extract" && i + 2 < args.size()) {
         config.commands.push_back({"extract", args[i+1], args[i+2]});
         i += 2;
+    } else if (args[i] == "--extract-table" && i + 1 < args.size()) {
+        // --extract-table <spec.json|inline JSON> [ndjson|csv]
+        std::string spec = args[++i];
+        std::string format = "ndjson";
+        if (i + 1 < args.size() && (args[i+1] == "ndjson" || args[i+1] == "csv")) {
+            format = args[++i];
+        }
+        config.commands.push_back({"extract-table", format, spec});
+    } else if (args[i] == "--dom-diff" && i + 1 < args.size()) {
+        // --dom-diff <duration_ms>
+        config.commands.push_back({"dom-diff", "", args[++i]});
     }
     
     // Basic waiting commands
@@ -452,6 +526,11 @@ bool ConfigParser::isUrl(const std::string& str) {
     return std::regex_match(str, url_pattern);
 }
 
+bool ConfigParser::isSha256Digest(const std::string& str) {
+    std::regex digest_pattern(R"(^(sha256:)?[0-9a-fA-F]{64}$)", std::regex_constants::icase);
+    return std::regex_match(str, digest_pattern);
+}
+
 void ConfigParser::validate_config(const HWebConfig& config) {
     // Add validation logic here if needed
 }
@@ -472,6 +551,14 @@ void ConfigParser::print_usage() {
     std::cerr << "  --json               Enable JSON output mode" << std::endl;
     std::cerr << "  --silent             Silent mode (exit codes only)" << std::endl;
     std::cerr << std::endl;
+    std::cerr << "Screenshot Commands:" << std::endl;
+    std::cerr << "  --screenshot [file]                        Capture visible area" << std::endl;
+    std::cerr << "  --screenshot-full [file]                   Capture full page" << std::endl;
+    std::cerr << "  --screenshot-burst <dir> <ms> [interval|events]  Record a frame sequence" << std::endl;
+    std::cerr << "  --screenshot-viewports <w[xh],...> [dir]   Capture the page at each viewport size" << std::endl;
+    std::cerr << "  --screenshot-store <dir>                   Deduplicate identical captures via hard links" << std::endl;
+    std::cerr << "  --screenshot-phash                         Also report a perceptual hash" << std::endl;
+    std::cerr << std::endl;
     std::cerr << "Assertion Commands:" << std::endl;
     std::cerr << "  --assert-exists <selector> [true|false]    Assert element exists" << std::endl;
     std::cerr << "  --assert-text <selector> <text>            Assert element contains text" << std::endl;
@@ -481,6 +568,18 @@ void ConfigParser::print_usage() {
     std::cerr << "  --message <text>                           Custom assertion message" << std::endl;
     std::cerr << "  --timeout <ms>                             Assertion timeout" << std::endl;
     std::cerr << std::endl;
+    std::cerr << "Form Commands:" << std::endl;
+    std::cerr << "  --fill-form <data>                         Fill many fields from a JSON map (file or JSON)" << std::endl;
+    std::cerr << "      data: {\"#email\": \"a@b.c\", \"country\": \"NZ\", \"terms\": true}" << std::endl;
+    std::cerr << std::endl;
+    std::cerr << "Extraction Commands:" << std::endl;
+    std::cerr << "  --readable                                 Main page content as plain text" << std::endl;
+    std::cerr << "  --markdown                                 Main page content as Markdown" << std::endl;
+    std::cerr << "  --source [file]                            Write the full page HTML (stdout by default)" << std::endl;
+    std::cerr << "  --extract-table <spec> [ndjson|csv]        Stream rows matching a table spec (file or JSON)" << std::endl;
+    std::cerr << "      spec: {\"rows\": \"tr\", \"fields\": {\"name\": \"td.name\", \"link\": \"a@href\"}}" << std::endl;
+    std::cerr << "  --dom-diff <ms>                            Print a DOM node table, then each change as NDJSON" << std::endl;
+    std::cerr << std::endl;
     std::cerr << "JavaScript Commands:" << std::endl;
     std::cerr << "  --js <code>                                Execute JavaScript code" << std::endl;
     std::cerr << "  --js-file <file>                           Execute JavaScript from file" << std::endl;
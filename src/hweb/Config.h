@@ -11,6 +11,7 @@ public:
     HWebConfig parseArguments(const std::vector<std::string>& args);
     void print_usage();
     bool isUrl(const std::string& str);
+    bool isSha256Digest(const std::string& str);
     
 private:
     void validate_config(const HWebConfig& config);
@@ -2,9 +2,23 @@
 #include "../Output.h"
 #include <iostream>
 #include <fstream>
+#include <filesystem>
+#include <iterator>
+#include <unistd.h>
 
 namespace HWeb {
 
+namespace {
+
+// Same message and exit status as a failed step in a compiled batch, so a
+// command's result does not depend on whether its neighbours were batched with it
+int report_interaction_failure(const Command& cmd) {
+    Output::command_failed(cmd.type, cmd.selector, "element not found or action refused by the page");
+    return 1;
+}
+
+} // namespace
+
 BasicCommandHandler::BasicCommandHandler() {
 }
 
@@ -30,20 +44,22 @@ int BasicCommandHandler::handle_command(Browser& browser, Session& session, cons
     // Interaction commands
     if (cmd.type == "type" || cmd.type == "fill-enhanced" || cmd.type == "click" || cmd.type == "submit" || 
         cmd.type == "select" || cmd.type == "check" || cmd.type == "uncheck" || 
-        cmd.type == "focus" || cmd.type == "js" || cmd.type == "js-file") {
+        cmd.type == "focus" || cmd.type == "fill-form" || cmd.type == "js" || cmd.type == "js-file") {
         return handle_interaction_command(browser, cmd);
     }
     
     // Data extraction commands
     if (cmd.type == "text" || cmd.type == "exists" || cmd.type == "count" || 
-        cmd.type == "html" || cmd.type == "attr") {
+        cmd.type == "html" || cmd.type == "attr" || cmd.type == "readable") {
         return handle_data_extraction_command(browser, cmd);
     }
     
     // Special commands
     if (cmd.type == "wait" || cmd.type == "wait-nav" || cmd.type == "wait-ready" ||
         cmd.type == "search" || cmd.type == "screenshot" || cmd.type == "screenshot-full" ||
-        cmd.type == "extract" || cmd.type == "record-start" || cmd.type == "record-stop" ||
+        cmd.type == "screenshot-burst" || cmd.type == "screenshot-viewports" ||
+        cmd.type == "extract" || cmd.type == "extract-table" || cmd.type == "source" || cmd.type == "dom-diff" ||
+        cmd.type == "record-start" || cmd.type == "record-stop" ||
         cmd.type == "replay" || cmd.type == "set-attr") {
         return handle_special_command(browser, session, cmd);
     }
@@ -156,29 +172,80 @@ int BasicCommandHandler::handle_navigation_command(Browser& browser, Session& se
 int BasicCommandHandler::handle_interaction_command(Browser& browser, const Command& cmd) {
     try {
         if (cmd.type == "type") {
-            browser.fillInputEnhanced(cmd.selector, cmd.value);
+            if (!browser.fillInputEnhanced(cmd.selector, cmd.value)) {
+                return report_interaction_failure(cmd);
+            }
             Output::info("Typed text into: " + cmd.selector);
         } else if (cmd.type == "fill-enhanced") {
-            browser.fillInputEnhanced(cmd.selector, cmd.value);
+            if (!browser.fillInputEnhanced(cmd.selector, cmd.value)) {
+                return report_interaction_failure(cmd);
+            }
             Output::info("Enhanced fill into: " + cmd.selector);
         } else if (cmd.type == "click") {
-            browser.clickElement(cmd.selector);
+            if (!browser.clickElement(cmd.selector)) {
+                return report_interaction_failure(cmd);
+            }
             Output::info("Clicked: " + cmd.selector);
         } else if (cmd.type == "submit") {
-            browser.submitForm(cmd.selector);
+            if (!browser.submitForm(cmd.selector)) {
+                return report_interaction_failure(cmd);
+            }
             Output::info("Submitted form: " + cmd.selector);
         } else if (cmd.type == "select") {
-            browser.selectOption(cmd.selector, cmd.value);
+            if (!browser.selectOption(cmd.selector, cmd.value)) {
+                return report_interaction_failure(cmd);
+            }
             Output::info("Selected option: " + cmd.value + " in " + cmd.selector);
         } else if (cmd.type == "check") {
-            browser.checkElement(cmd.selector);
+            if (!browser.checkElement(cmd.selector)) {
+                return report_interaction_failure(cmd);
+            }
             Output::info("Checked: " + cmd.selector);
         } else if (cmd.type == "uncheck") {
-            browser.uncheckElement(cmd.selector);
+            if (!browser.uncheckElement(cmd.selector)) {
+                return report_interaction_failure(cmd);
+            }
             Output::info("Unchecked: " + cmd.selector);
         } else if (cmd.type == "focus") {
-            browser.focusElement(cmd.selector);
+            if (!browser.focusElement(cmd.selector)) {
+                return report_interaction_failure(cmd);
+            }
             Output::info("Focused: " + cmd.selector);
+        } else if (cmd.type == "fill-form") {
+            // value is an inline JSON field map or a path to one
+            std::string fields = cmd.value;
+            if (fields.find('{') != 0) {
+                std::ifstream fields_file(cmd.value);
+                if (!fields_file.is_open()) {
+                    Output::error("Failed to read form data: " + cmd.value);
+                    return 1;
+                }
+                fields.assign(std::istreambuf_iterator<char>(fields_file), std::istreambuf_iterator<char>());
+            }
+            
+            std::map<std::string, std::string> status = browser.fillForm(fields);
+            if (status.empty()) {
+                Output::error("Invalid form data (expected a JSON object): " + cmd.value);
+                return 1;
+            }
+            
+            int failed = 0;
+            Json::Value json(Json::objectValue);
+            for (const auto& field : status) {
+                json[field.first] = field.second;
+                if (field.second != "ok") {
+                    Output::error("Field '" + field.first + "': " + field.second);
+                    failed++;
+                }
+            }
+            Output::info("Filled " + std::to_string(status.size() - failed) + " of " +
+                         std::to_string(status.size()) + " fields");
+            if (Output::is_json_mode()) {
+                Json::StreamWriterBuilder builder;
+                builder["indentation"] = "";
+                std::cout << Json::writeString(builder, json) << std::endl;
+            }
+            return failed > 0 ? 1 : 0;
         } else if (cmd.type == "js") {
             Output::verbose("Executing JavaScript: " + (cmd.value.length() > 50 ? cmd.value.substr(0, 50) + "..." : cmd.value));
             std::string result = browser.executeJavascriptSync(cmd.value);
@@ -240,11 +307,34 @@ int BasicCommandHandler::handle_data_extraction_command(Browser& browser, const
             int count = browser.countElements(cmd.selector);
             std::cout << count << std::endl;
         } else if (cmd.type == "html") {
-            std::string html = browser.getElementHtml(cmd.selector);
-            std::cout << html << std::endl;
+            // Written slice by slice as it arrives from the page
+            size_t written = 0;
+            bool streamed = browser.streamElementHtml(cmd.selector, [&written](const char* data, size_t length) {
+                std::cout.write(data, length);
+                written += length;
+            });
+            if (!streamed && written == 0) {
+                std::cout << browser.callPageRuntime("html", {cmd.selector});
+            }
+            std::cout << std::endl;
+            if (!streamed && written > 0) {
+                // What reached stdout is truncated markup
+                Output::error("HTML stream for " + cmd.selector + " failed after " + std::to_string(written) + " bytes");
+                return 1;
+            }
         } else if (cmd.type == "attr") {
             std::string attr_value = browser.getAttribute(cmd.selector, cmd.value);
             std::cout << attr_value << std::endl;
+        } else if (cmd.type == "readable") {
+            // One in-page pass; output is written as it streams back
+            bool streamed = browser.streamReadableContent(cmd.value == "markdown", [](const char* data, size_t length) {
+                std::cout.write(data, length);
+            });
+            std::cout << std::endl;
+            if (!streamed) {
+                Output::error("Readable extraction failed");
+                return 1;
+            }
         }
         
         return 0;
@@ -301,11 +391,75 @@ int BasicCommandHandler::handle_special_command(Browser& browser, Session& sessi
         } else if (cmd.type == "screenshot") {
             browser.takeScreenshot(cmd.selector);
             Output::info("Screenshot saved: " + cmd.selector);
+            print_screenshot_info(browser.getLastScreenshotInfo(), cmd.type);
             return 0;
         } else if (cmd.type == "screenshot-full") {
             browser.takeFullPageScreenshot(cmd.selector);
             Output::info("Full page screenshot saved: " + cmd.selector);
+            print_screenshot_info(browser.getLastScreenshotInfo(), cmd.type);
             return 0;
+        } else if (cmd.type == "screenshot-burst") {
+            // value is "<duration_ms>[,<interval_ms>|events]"
+            ScreenshotRecordingOptions options;
+            options.output_dir = cmd.selector;
+            
+            size_t comma = cmd.value.find(',');
+            options.duration_ms = std::stoi(cmd.value.substr(0, comma));
+            if (comma != std::string::npos) {
+                std::string mode = cmd.value.substr(comma + 1);
+                if (mode == "events") {
+                    options.capture_on_events = true;
+                    options.interval_ms = 0;
+                } else {
+                    options.interval_ms = std::stoi(mode);
+                }
+            }
+            
+            int frames = browser.recordScreenshots(options);
+            if (frames < 0) {
+                Output::error("Screenshot recording failed: " + cmd.selector);
+                return 1;
+            }
+            Output::info("Recorded " + std::to_string(frames) + " frames to " + cmd.selector);
+            if (Output::is_json_mode()) {
+                Json::Value json;
+                json["command"] = cmd.type;
+                json["directory"] = cmd.selector;
+                json["frames"] = frames;
+                
+                Json::StreamWriterBuilder builder;
+                builder["indentation"] = "";
+                std::cout << Json::writeString(builder, json) << std::endl;
+            }
+            return 0;
+        } else if (cmd.type == "screenshot-viewports") {
+            // value is "<width>[x<height>],..."; heights default to the current viewport
+            ScreenshotSweepOptions options;
+            options.output_dir = cmd.selector;
+            options.viewports = parseViewportList(cmd.value, browser.getViewport().second);
+            if (options.viewports.empty()) {
+                Output::error("Invalid viewport list: " + cmd.value);
+                return 1;
+            }
+            
+            int images = browser.captureViewportSweep(options);
+            if (images < 0) {
+                Output::error("Viewport screenshots failed: " + cmd.selector);
+                return 1;
+            }
+            Output::info("Saved " + std::to_string(images) + " viewport screenshots to " + cmd.selector);
+            if (Output::is_json_mode()) {
+                Json::Value json;
+                json["command"] = cmd.type;
+                json["directory"] = cmd.selector;
+                json["images"] = images;
+                json["requested"] = static_cast<Json::UInt64>(options.viewports.size());
+                
+                Json::StreamWriterBuilder builder;
+                builder["indentation"] = "";
+                std::cout << Json::writeString(builder, json) << std::endl;
+            }
+            return images == static_cast<int>(options.viewports.size()) ? 0 : 1;
         } else if (cmd.type == "set-attr") {
             // Parse "attribute value" from cmd.value
             size_t space_pos = cmd.value.find(' ');
@@ -333,6 +487,135 @@ int BasicCommandHandler::handle_special_command(Browser& browser, Session& sessi
                 Output::error("Failed to write to file: " + cmd.selector);
                 return 1;
             }
+        } else if (cmd.type == "source") {
+            // Full document HTML to a file (selector) or stdout, without the result cap.
+            // A file is written beside its destination and renamed into place only
+            // once the whole document has arrived, so a failed stream leaves any
+            // previous copy untouched.
+            std::string temp_path;
+            std::ofstream file;
+            if (!cmd.selector.empty()) {
+                temp_path = cmd.selector + ".tmp-" + std::to_string(getpid());
+                file.open(temp_path, std::ios::binary | std::ios::trunc);
+                if (!file.is_open()) {
+                    Output::error("Failed to write to file: " + cmd.selector);
+                    return 1;
+                }
+            }
+            std::ostream& out = cmd.selector.empty() ? std::cout : file;
+            
+            size_t written = 0;
+            bool streamed = browser.streamPageSource([&](const char* data, size_t length) {
+                out.write(data, length);
+                written += length;
+            });
+            if (!streamed && written == 0) {
+                std::string source = browser.getPageSource();
+                out << source;
+                written = source.size();
+                streamed = !source.empty();
+            }
+            
+            if (cmd.selector.empty()) {
+                std::cout << std::endl;
+                if (!streamed) {
+                    Output::error("Page source stream failed after " + std::to_string(written) + " bytes");
+                    return 1;
+                }
+                return 0;
+            }
+            
+            file.close();
+            std::error_code ec;
+            if (!streamed || file.fail()) {
+                std::filesystem::remove(temp_path, ec);
+                Output::error("Page source stream failed after " + std::to_string(written) + " bytes; " +
+                              cmd.selector + " not written");
+                return 1;
+            }
+            std::filesystem::rename(temp_path, cmd.selector, ec);
+            if (ec) {
+                std::filesystem::remove(temp_path, ec);
+                Output::error("Failed to write to file: " + cmd.selector);
+                return 1;
+            }
+            Output::info("Saved " + std::to_string(written) + " bytes of page source to " + cmd.selector);
+            return 0;
+        } else if (cmd.type == "dom-diff") {
+            // Snapshot line first, then one diff per line for the next <value> ms
+            int duration_ms = std::stoi(cmd.value);
+            bool snapshot_written = false;
+            std::vector<std::string> early_diffs;
+            long diffs = 0;
+            
+            size_t subscription = browser.event_bus_->subscribe(BrowserEvents::EventType::DOM_MUTATION,
+                [&](const BrowserEvents::Event& event) {
+                    // Diffs can arrive while the snapshot is still streaming
+                    if (!snapshot_written) {
+                        early_diffs.push_back(event.data);
+                        return;
+                    }
+                    std::cout << event.data << std::endl;
+                    diffs++;
+                },
+                [](const BrowserEvents::Event& event) { return event.target == "dom-diff"; });
+            
+            bool ok = browser.snapshotDom([](const char* data, size_t length) {
+                std::cout.write(data, length);
+            });
+            if (ok) {
+                std::cout << std::endl;
+                snapshot_written = true;
+                for (const auto& diff : early_diffs) {
+                    std::cout << diff << std::endl;
+                    diffs++;
+                }
+                browser.wait(duration_ms);
+                browser.stopDomDiffs();
+            }
+            browser.event_bus_->unsubscribe(subscription);
+            
+            if (!ok) {
+                Output::error("DOM snapshot failed");
+                return 1;
+            }
+            Output::info("Streamed " + std::to_string(diffs) + " DOM diffs");
+            return 0;
+        } else if (cmd.type == "extract-table") {
+            // value is an inline JSON spec or a path to one; selector is the output format
+            std::string spec_text = cmd.value;
+            if (spec_text.find('{') != 0) {
+                std::ifstream spec_file(cmd.value);
+                if (!spec_file.is_open()) {
+                    Output::error("Failed to read table spec: " + cmd.value);
+                    return 1;
+                }
+                spec_text.assign(std::istreambuf_iterator<char>(spec_file), std::istreambuf_iterator<char>());
+            }
+            
+            TableSpec spec;
+            std::string error;
+            if (!parseTableSpec(spec_text, spec, error)) {
+                Output::error("Invalid table spec: " + error);
+                return 1;
+            }
+            
+            TableFormat format = (cmd.selector == "csv") ? TableFormat::CSV : TableFormat::NDJSON;
+            if (format == TableFormat::CSV) {
+                std::cout << formatTableHeader(spec) << '\n';
+            }
+            // Rows are written as they arrive; nothing is buffered on this side
+            long rows = browser.extractTable(spec, [&](const Json::Value& cells) {
+                std::cout << formatTableRow(spec, cells, format) << '\n';
+            });
+            std::cout.flush();
+            
+            if (rows < 0) {
+                Output::error("Table extraction failed: " + spec.row_selector);
+                return 1;
+            }
+            Output::info("Extracted " + std::to_string(rows) + " rows");
+            return 0;
         } else if (cmd.type == "record-start") {
             session.setRecording(true);
             Output::info("Recording started");
@@ -370,4 +653,28 @@ bool BasicCommandHandler::wait_for_navigation_complete(Browser& browser, int tim
     return browser.waitForNavigationSignal(timeout_ms);
 }
 
+void BasicCommandHandler::print_screenshot_info(const ScreenshotInfo& info, const std::string& command) {
+    if (Output::is_json_mode()) {
+        Json::Value json;
+        json["command"] = command;
+        json["file"] = info.filename;
+        json["success"] = info.success;
+        json["hash"] = info.hash;
+        if (!info.perceptual_hash.empty()) {
+            json["phash"] = info.perceptual_hash;
+        }
+        json["width"] = info.width;
+        json["height"] = info.height;
+        json["deduplicated"] = info.deduplicated;
+        
+        Json::StreamWriterBuilder builder;
+        builder["indentation"] = "";
+        std::cout << Json::writeString(builder, json) << std::endl;
+    } else if (!info.hash.empty()) {
+        Output::verbose("Screenshot hash: " + info.hash +
+                        (info.perceptual_hash.empty() ? "" : " phash: " + info.perceptual_hash) +
+                        (info.deduplicated ? " (unchanged, encoding skipped)" : ""));
+    }
+}
+
 } // namespace HWeb
\ No newline at end of file
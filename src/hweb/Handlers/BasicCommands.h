@@ -22,6 +22,7 @@ private:
     int handle_special_command(Browser& browser, Session& session, const Command& cmd);
     
     bool wait_for_navigation_complete(Browser& browser, int timeout_ms);
+    void print_screenshot_info(const ScreenshotInfo& info, const std::string& command);
 };
 
 } // namespace HWeb
\ No newline at end of file
@@ -2,9 +2,82 @@
 #include "../Output.h"
 #include "../Services/ManagerRegistry.h"
 #include <sstream>
+#include <iostream>
+#include <csignal>
+#include <cstdio>
+#include <json/json.h>
 
 namespace HWeb {
 
+namespace {
+
+// Digests go to stdout: "<sha256>  <path>" lines that sha256sum -c accepts,
+// or one JSON array in JSON mode
+void print_download_digests(const std::vector<DownloadRecord>& downloads) {
+    if (Output::is_silent_mode()) {
+        return;
+    }
+    if (Output::is_json_mode()) {
+        Json::Value files(Json::arrayValue);
+        for (const auto& download : downloads) {
+            Json::Value file;
+            file["path"] = download.destination;
+            file["uri"] = download.uri;
+            file["bytes"] = static_cast<Json::UInt64>(download.received_bytes);
+            file["sha256"] = download.sha256;
+            files.append(file);
+        }
+        Json::StreamWriterBuilder builder;
+        builder["indentation"] = "";
+        std::cout << Json::writeString(builder, files) << std::endl;
+        return;
+    }
+    for (const auto& download : downloads) {
+        std::cout << download.sha256 << "  " << download.destination << std::endl;
+    }
+}
+
+// Per-file upload results go to stdout: one line per file, or one JSON
+// array in JSON mode. Files no request carried only show their size.
+void print_upload_stats(const std::vector<FileOps::UploadFileStats>& files) {
+    if (Output::is_silent_mode()) {
+        return;
+    }
+    if (Output::is_json_mode()) {
+        Json::Value list(Json::arrayValue);
+        for (const auto& file : files) {
+            Json::Value entry;
+            entry["path"] = file.filepath;
+            entry["bytes"] = static_cast<Json::UInt64>(file.size_bytes);
+            entry["state"] = file.state;
+            if (file.state != "selected") {
+                entry["url"] = file.url;
+                entry["status"] = file.http_status;
+                entry["queued_ms"] = static_cast<Json::Int64>(file.queued_ms);
+                entry["transfer_ms"] = static_cast<Json::Int64>(file.transfer_ms);
+                entry["stalled_ms"] = static_cast<Json::Int64>(file.stalled_ms);
+                entry["bytes_per_second"] = file.throughput_bps;
+            }
+            list.append(entry);
+        }
+        Json::StreamWriterBuilder builder;
+        builder["indentation"] = "";
+        std::cout << Json::writeString(builder, list) << std::endl;
+        return;
+    }
+    for (const auto& file : files) {
+        std::cout << file.state << "  " << file.size_bytes << " bytes";
+        if (file.state != "selected") {
+            std::cout << "  " << file.transfer_ms << " ms  "
+                      << static_cast<uint64_t>(file.throughput_bps) << " B/s  queued "
+                      << file.queued_ms << " ms  stalled " << file.stalled_ms << " ms";
+        }
+        std::cout << "  " << file.filepath << std::endl;
+    }
+}
+
+} // namespace
+
 FileOperationHandler::FileOperationHandler() {
 }
 
@@ -24,6 +97,8 @@ void FileOperationHandler::configure_managers(const FileOperationSettings& setti
         download_manager.setDownloadDirectory(settings.download_dir);
     }
     download_manager.setDefaultTimeout(settings.download_timeout);
+    download_manager.setMaxConcurrentDownloads(settings.max_concurrent_downloads);
+    download_manager.setDiskBudget(settings.download_budget);
 }
 
 int FileOperationHandler::handle_command(Browser& browser, const Command& cmd) {
@@ -32,9 +107,13 @@ int FileOperationHandler::handle_command(Browser& browser, const Command& cmd) {
     } else if (cmd.type == "upload-multiple") {
         return handle_upload_multiple_command(browser, cmd);
     } else if (cmd.type == "download-wait") {
-        return handle_download_wait_command(cmd);
+        return handle_download_wait_command(browser, cmd);
     } else if (cmd.type == "download-wait-multiple") {
-        return handle_download_wait_multiple_command(cmd);
+        return handle_download_wait_multiple_command(browser, cmd);
+    } else if (cmd.type == "download-all") {
+        return handle_download_all_command(browser, cmd);
+    } else if (cmd.type == "download-stream") {
+        return handle_download_stream_command(browser, cmd);
     }
     
     return 0;
@@ -77,7 +156,9 @@ int FileOperationHandler::handle_upload_multiple_command(Browser& browser, const
         }
     }
     
-    FileOps::UploadResult result = upload_manager.uploadMultipleFiles(browser, cmd.selector, filepaths, cmd.timeout);
+    std::vector<FileOps::UploadFileStats> stats;
+    FileOps::UploadResult result = upload_manager.uploadMultipleFiles(browser, cmd.selector, filepaths, cmd.timeout, &stats);
+    print_upload_stats(stats);
     
     if (result == FileOps::UploadResult::SUCCESS) {
         Output::info("Multiple files uploaded successfully");
@@ -88,20 +169,23 @@ int FileOperationHandler::handle_upload_multiple_command(Browser& browser, const
     }
 }
 
-int FileOperationHandler::handle_download_wait_command(const Command& cmd) {
+int FileOperationHandler::handle_download_wait_command(Browser& browser, const Command& cmd) {
     auto& download_manager = ManagerRegistry::get_download_manager();
     
     FileOps::DownloadCommand download_cmd;
     download_cmd.filename_pattern = cmd.selector;
     download_cmd.download_dir = settings_.download_dir;
     download_cmd.timeout_ms = cmd.timeout;
+    download_cmd.expected_sha256 = cmd.value;
     download_cmd.json_output = Output::is_json_mode();
     download_cmd.silent = Output::is_silent_mode();
     
-    FileOps::DownloadResult result = download_manager.waitForDownload(download_cmd);
+    DownloadRecord completed;
+    FileOps::DownloadResult result = download_manager.waitForDownload(browser, download_cmd, &completed);
     
     if (result == FileOps::DownloadResult::SUCCESS) {
         Output::info("Download completed: " + cmd.selector);
+        print_download_digests({completed});
         return 0;
     } else {
         Output::error("Download failed: " + download_manager.getErrorMessage(result, cmd.selector));
@@ -109,7 +193,7 @@ int FileOperationHandler::handle_download_wait_command(const Command& cmd) {
     }
 }
 
-int FileOperationHandler::handle_download_wait_multiple_command(const Command& cmd) {
+int FileOperationHandler::handle_download_wait_multiple_command(Browser& browser, const Command& cmd) {
     auto& download_manager = ManagerRegistry::get_download_manager();
     
     std::vector<std::string> patterns;
@@ -123,7 +207,10 @@ int FileOperationHandler::handle_download_wait_multiple_command(const Command& c
         }
     }
     
-    FileOps::DownloadResult result = download_manager.waitForMultipleDownloads(patterns, settings_.download_dir, cmd.timeout);
+    std::vector<DownloadRecord> completed;
+    FileOps::DownloadResult result = download_manager.waitForMultipleDownloads(browser, patterns, settings_.download_dir,
+                                                                               cmd.timeout, &completed);
+    print_download_digests(completed);
     
     if (result == FileOps::DownloadResult::SUCCESS) {
         Output::info("All downloads completed");
@@ -134,4 +221,131 @@ int FileOperationHandler::handle_download_wait_multiple_command(const Command& c
     }
 }
 
+int FileOperationHandler::handle_download_all_command(Browser& browser, const Command& cmd) {
+    auto& download_manager = ManagerRegistry::get_download_manager();
+    
+    std::vector<std::string> uris;
+    std::stringstream ss(cmd.value);
+    std::string uri;
+    while (std::getline(ss, uri, ',')) {
+        uri.erase(0, uri.find_first_not_of(" \t"));
+        uri.erase(uri.find_last_not_of(" \t") + 1);
+        if (!uri.empty()) {
+            uris.push_back(uri);
+        }
+    }
+    
+    std::vector<DownloadRecord> completed;
+    FileOps::DownloadResult result = download_manager.downloadAll(browser, uris, settings_.download_dir,
+                                                                  cmd.timeout, &completed);
+    print_download_digests(completed);
+    
+    if (result == FileOps::DownloadResult::SUCCESS) {
+        Output::info("Downloaded " + std::to_string(uris.size()) + " files");
+        return 0;
+    } else {
+        Output::error("Batch download failed: " + download_manager.getErrorMessage(result, cmd.value));
+        return static_cast<int>(result);
+    }
+}
+
+// The downloaded bytes themselves are the stdout output, written as they
+// arrive; status goes to stderr as usual
+int FileOperationHandler::handle_download_stream_command(Browser& browser, const Command& cmd) {
+    auto& download_manager = ManagerRegistry::get_download_manager();
+    
+    std::cout.flush();
+    // A reader that closes the pipe should end the download, not the process
+    auto previous_sigpipe = std::signal(SIGPIPE, SIG_IGN);
+    
+    uint64_t streamed = 0;
+    DownloadRecord completed;
+    FileOps::DownloadResult result = download_manager.streamDownload(browser, cmd.value,
+        [&streamed](const uint8_t* data, size_t length) {
+            if (std::fwrite(data, 1, length, stdout) != length || std::fflush(stdout) != 0) {
+                return false;
+            }
+            streamed += length;
+            return true;
+        }, cmd.timeout, &completed);
+    
+    std::signal(SIGPIPE, previous_sigpipe);
+    
+    if (result == FileOps::DownloadResult::SUCCESS) {
+        Output::info("Streamed " + std::to_string(streamed) + " bytes from " + cmd.value + " (sha256 " + completed.sha256 + ")");
+        return 0;
+    } else {
+        Output::error("Download stream failed: " + download_manager.getErrorMessage(result, cmd.value));
+        return static_cast<int>(result);
+    }
+}
+
+// The body goes to stdout as it arrives, or to a file that is written under
+// a .part name and renamed into place only once complete
+int FileOperationHandler::handle_fetch_command(Browser& browser, Session& session, const Command& cmd) {
+    bool to_stdout = cmd.selector.empty() || cmd.selector == "-";
+    std::string partial = cmd.selector + ".part";
+    
+    FILE* out = stdout;
+    if (to_stdout) {
+        std::cout.flush();
+    } else {
+        out = std::fopen(partial.c_str(), "wb");
+        if (!out) {
+            Output::error("Fetch failed: cannot write " + partial);
+            return 1;
+        }
+    }
+    auto previous_sigpipe = std::signal(SIGPIPE, SIG_IGN);
+    
+    // The page may not have been loaded (and the session not restored) for this run
+    if (!session.getUserAgent().empty()) {
+        browser.setUserAgent(session.getUserAgent());
+    }
+    
+    FetchResponse response;
+    bool ok = browser.fetch(cmd.value, session.getCookies(),
+        [out, to_stdout](const uint8_t* data, size_t length) {
+            return std::fwrite(data, 1, length, out) == length && (!to_stdout || std::fflush(out) == 0);
+        }, cmd.timeout, response);
+    
+    std::signal(SIGPIPE, previous_sigpipe);
+    
+    // Cookies set by the server belong to the session like the page's own
+    for (const auto& cookie : response.set_cookies) {
+        session.addCookie(cookie);
+    }
+    
+    if (!to_stdout) {
+        bool written = std::fclose(out) == 0;
+        if (ok && (!written || std::rename(partial.c_str(), cmd.selector.c_str()) != 0)) {
+            response.error = "cannot write " + cmd.selector;
+            ok = false;
+        }
+        if (!ok) {
+            std::remove(partial.c_str());
+        }
+    }
+    
+    if (!ok) {
+        std::string reason = response.error.empty() ? "HTTP " + std::to_string(response.status) + " " + response.reason
+                                                    : response.error;
+        Output::error("Fetch failed: " + cmd.value + ": " + reason);
+        return 1;
+    }
+    
+    Output::info("Fetched " + std::to_string(response.received_bytes) + " bytes from " + cmd.value +
+                 " (HTTP " + std::to_string(response.status) +
+                 (response.content_type.empty() ? "" : ", " + response.content_type) + ")");
+    if (!to_stdout) {
+        DownloadRecord fetched;
+        fetched.uri = cmd.value;
+        fetched.destination = cmd.selector;
+        fetched.received_bytes = response.received_bytes;
+        fetched.sha256 = response.sha256;
+        print_download_digests({fetched});
+    }
+    return 0;
+}
+
 } // namespace HWeb
\ No newline at end of file
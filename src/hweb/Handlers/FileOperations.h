@@ -12,13 +12,16 @@ public:
     ~FileOperationHandler();
     
     int handle_command(Browser& browser, const Command& cmd);
+    int handle_fetch_command(Browser& browser, Session& session, const Command& cmd);
     void configure_managers(const FileOperationSettings& settings);
     
 private:
     int handle_upload_command(Browser& browser, const Command& cmd);
     int handle_upload_multiple_command(Browser& browser, const Command& cmd);
-    int handle_download_wait_command(const Command& cmd);
-    int handle_download_wait_multiple_command(const Command& cmd);
+    int handle_download_wait_command(Browser& browser, const Command& cmd);
+    int handle_download_wait_multiple_command(Browser& browser, const Command& cmd);
+    int handle_download_all_command(Browser& browser, const Command& cmd);
+    int handle_download_stream_command(Browser& browser, const Command& cmd);
     
     // Configuration cache
     FileOperationSettings settings_;
@@ -55,4 +55,8 @@ void Output::format_error(const std::string& context, const std::string& error)
     }
 }
 
+void Output::command_failed(const std::string& type, const std::string& selector, const std::string& reason) {
+    error("--" + type + (selector.empty() ? "" : " " + selector) + " failed: " + reason);
+}
+
 } // namespace HWeb
\ No newline at end of file
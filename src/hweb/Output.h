@@ -22,6 +22,8 @@ public:
     static void error(const std::string& message);
     static void verbose(const std::string& message);
     static void format_error(const std::string& context, const std::string& error);
+    // "--<type> <selector> failed: <reason>", the same whether or not the command ran in a batch
+    static void command_failed(const std::string& type, const std::string& selector, const std::string& reason);
 };
 
 } // namespace HWeb
\ No newline at end of file
@@ -57,24 +57,25 @@ bool NavigationService::wait_for_page_ready(Browser& browser, int timeout_ms) {
 }
 
 NavigationStrategy NavigationService::determine_navigation_strategy(const HWebConfig& config, const Session& session) {
+    // Commands that only touch session data or talk HTTP directly never need
+    // the page, so a run made only of them skips loading it - even when the
+    // session has a URL to restore
+    bool all_session_only = !config.commands.empty() && config.assertions.empty();
+    for (const auto& cmd : config.commands) {
+        if (cmd.type != "store" && cmd.type != "get" && cmd.type != "fetch") {
+            all_session_only = false;
+            break;
+        }
+    }
+    
     if (!config.url.empty()) {
         return NavigationStrategy::NEW_URL;
+    } else if (all_session_only) {
+        return NavigationStrategy::SESSION_ONLY;
     } else if (!session.getCurrentUrl().empty() && config.commands.empty() && config.assertions.empty()) {
         return NavigationStrategy::SESSION_RESTORE;
     } else if (!session.getCurrentUrl().empty() && (!config.commands.empty() || !config.assertions.empty())) {
         return NavigationStrategy::CONTINUE_SESSION;
-    } else if (session.getCurrentUrl().empty() && !config.commands.empty()) {
-        // Check if all commands are session-only (don't require navigation)
-        bool all_session_only = true;
-        for (const auto& cmd : config.commands) {
-            if (cmd.type != "store" && cmd.type != "get") {
-                all_session_only = false;
-                break;
-            }
-        }
-        if (all_session_only) {
-            return NavigationStrategy::SESSION_ONLY;
-        }
     }
     
     return NavigationStrategy::NO_NAVIGATION;
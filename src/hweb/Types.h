@@ -19,6 +19,8 @@ struct FileOperationSettings {
     std::string download_dir = "";
     int upload_timeout = 30000;
     int download_timeout = 30000;
+    size_t max_concurrent_downloads = 4;
+    uint64_t download_budget = 0; // bytes per batch, 0 = unlimited
 };
 
 struct HWebConfig {
@@ -33,6 +35,8 @@ struct HWebConfig {
     bool start_fresh = false;
     bool allow_data_uri = false;
     int browser_width = 1000;
+    std::string screenshot_store_dir = "";   // content-addressed screenshot store (empty = disabled)
+    bool screenshot_perceptual_hash = false;
     std::vector<Command> commands;
     std::vector<Assertion::Command> assertions;
     FileOperationSettings file_settings;
@@ -144,8 +144,9 @@ int run_application(const HWebConfig& config) {
         }
     }
     
-    // Update session state if needed
-    if (state_modified || navigationPlan.should_navigate) {
+    // Update session state if needed; without a loaded page there is nothing
+    // to read back, and reading would wipe the saved URL and cookies
+    if ((state_modified && navigationPlan.strategy != NavigationStrategy::SESSION_ONLY) || navigationPlan.should_navigate) {
         sessionService.update_session_state(browser, session);
     }
     
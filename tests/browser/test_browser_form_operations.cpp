@@ -1,6 +1,7 @@
 #include <gtest/gtest.h>
 #include "Browser/Browser.h"
 #include "../utils/test_helpers.h"
+#include "../utils/SafePageLoader.h"
 #include "browser_test_environment.h"
 #include "Debug.h"
 #include <memory>
@@ -67,6 +68,80 @@ TEST_F(BrowserFormOperationsTest, FormInputInterfaceTest) {
     });
 }
 
+TEST_F(BrowserFormOperationsTest, TrustedTypingInterfaceTest) {
+    // Trusted typing reports failure (instead of falling back) when there is no field
+    EXPECT_NO_THROW({
+        EXPECT_FALSE(browser->typeTrusted("#nonexistent-input", "test value"));
+        EXPECT_FALSE(browser->typeTrusted("#nonexistent-input", "", false));
+    });
+}
+
+TEST_F(BrowserFormOperationsTest, TrustedTypingFillsFieldWithTrustedEvents) {
+    auto loaded = TestUtils::SafePageLoader::loadMinimalTestPage(browser,
+        "<form><input id='q' name='q' value='old'></form>");
+    ASSERT_TRUE(loaded.success) << loaded.error_message;
+    browser->executeJavascriptSync(
+        "window.typed = [];"
+        "document.getElementById('q').addEventListener('input', function(e) {"
+        "  window.typed.push(e.isTrusted + ':' + e.inputType); }); 'ok'");
+
+    ASSERT_TRUE(browser->typeTrusted("#q", "hello"));
+    EXPECT_EQ(browser->executeJavascriptSync("document.getElementById('q').value"), "hello");
+
+    // Appending keeps the current text
+    ASSERT_TRUE(browser->typeTrusted("#q", " world", false));
+    EXPECT_EQ(browser->executeJavascriptSync("document.getElementById('q').value"), "hello world");
+
+    // One trusted insertText event per call, nothing synthesized by script
+    EXPECT_EQ(browser->executeJavascriptSync("window.typed.join(',')"), "true:insertText,true:insertText");
+}
+
+TEST_F(BrowserFormOperationsTest, HandleFillUsesTrustedTyping) {
+    auto loaded = TestUtils::SafePageLoader::loadMinimalTestPage(browser,
+        "<form><input id='email' name='email'></form>");
+    ASSERT_TRUE(loaded.success) << loaded.error_message;
+    browser->executeJavascriptSync(
+        "window.typed = [];"
+        "document.getElementById('email').addEventListener('input', function(e) {"
+        "  window.typed.push(e.isTrusted + ':' + e.inputType); }); 'ok'");
+
+    ElementHandle handle = browser->query("#email");
+    ASSERT_TRUE(handle.valid());
+    ASSERT_TRUE(browser->fillInput(handle, "ada@example.com"));
+
+    EXPECT_EQ(browser->getValue(handle), "ada@example.com");
+    EXPECT_EQ(browser->executeJavascriptSync("window.typed.join(',')"), "true:insertText");
+    browser->releaseHandle(handle);
+}
+
+TEST_F(BrowserFormOperationsTest, FileChooserSelectionInterfaceTest) {
+    // Without a file input to click there is no chooser request to answer
+    EXPECT_NO_THROW({
+        EXPECT_FALSE(browser->selectFiles("#nonexistent-file-input", {"/tmp/hweb-upload.txt"}, 500));
+        EXPECT_FALSE(browser->selectFiles("input[type='file']", {}, 500));
+    });
+}
+
+TEST_F(BrowserFormOperationsTest, FileChooserAnswerFillsInputFiles) {
+    TestHelpers::TemporaryDirectory temp_dir("file_chooser_tests");
+    auto notes = temp_dir.createFile("notes.txt", "twelve bytes");
+    auto data = temp_dir.createFile("data.csv", "a,b\n1,2\n");
+
+    auto loaded = TestUtils::SafePageLoader::loadMinimalTestPage(browser,
+        "<form><input type='file' id='single'><input type='file' id='many' multiple></form>");
+    ASSERT_TRUE(loaded.success) << loaded.error_message;
+
+    ASSERT_TRUE(browser->selectFiles("#many", {notes.string(), data.string()}));
+    EXPECT_EQ(browser->executeJavascriptSync(
+        "Array.prototype.map.call(document.getElementById('many').files, function(f) {"
+        "  return f.name + ':' + f.size; }).join(',')"), "notes.txt:12,data.csv:8");
+
+    // Without the multiple attribute only the first path is applied
+    ASSERT_TRUE(browser->selectFiles("#single", {data.string(), notes.string()}));
+    EXPECT_EQ(browser->executeJavascriptSync(
+        "var f = document.getElementById('single').files; f.length + ':' + f[0].name"), "1:data.csv");
+}
+
 TEST_F(BrowserFormOperationsTest, FormButtonInterfaceTest) {
     // Test form button interface methods
     EXPECT_NO_THROW({
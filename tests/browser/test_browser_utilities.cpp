@@ -279,6 +279,17 @@ TEST_F(BrowserUtilitiesTest, PageSourceInterface) {
     EXPECT_NO_THROW(browser->getCurrentUrl());
 }
 
+TEST_F(BrowserUtilitiesTest, ChunkedSourceInterface) {
+    // Without a loaded page the transfer fails cleanly and never feeds the sink
+    size_t bytes = 0;
+    auto sink = [&bytes](const char* data, size_t length) { bytes += length; };
+    
+    EXPECT_FALSE(browser->streamPageSource(sink));
+    EXPECT_FALSE(browser->streamElementHtml("body", sink));
+    EXPECT_FALSE(browser->streamPageRuntime("html", {"#nonexistent"}, sink, 1000));
+    EXPECT_EQ(bytes, 0u);
+}
+
 // ========== Cookie and Storage Interface Tests ==========
 
 TEST_F(BrowserUtilitiesTest, CookieInterface) {
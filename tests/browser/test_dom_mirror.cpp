@@ -0,0 +1,84 @@
+#include <gtest/gtest.h>
+#include "Browser/DomMirror.h"
+
+class DomMirrorTest : public ::testing::Test {
+protected:
+    // <html><body><p id="a">Hi</p><!--c--></body></html>
+    const std::string snapshot = R"JSON({"seq":0,"nodes":[
+        [1,0,1,"html",{}],
+        [2,1,1,"body",{}],
+        [3,2,1,"p",{"id":"a"}],
+        [4,3,3,"Hi"],
+        [5,2,8,"c"]]})JSON";
+
+    DomMirror mirror;
+
+    void SetUp() override {
+        ASSERT_TRUE(mirror.load(snapshot));
+    }
+};
+
+TEST_F(DomMirrorTest, LoadsNodeTable) {
+    EXPECT_EQ(mirror.size(), 5u);
+    EXPECT_EQ(mirror.root(), 1);
+    EXPECT_EQ(mirror.sequence(), 0u);
+    EXPECT_EQ(mirror.html(), "<html><body><p id=\"a\">Hi</p><!--c--></body></html>");
+    EXPECT_EQ(mirror.textContent(2), "Hi");
+}
+
+TEST_F(DomMirrorTest, InsertsSubtreeAfterSibling) {
+    ASSERT_TRUE(mirror.apply(R"JSON({"seq":1,"ops":[
+        ["insert",2,3,[[6,2,1,"ul",{}],[7,6,1,"li",{}],[8,7,3,"x < y"]]]]})JSON"));
+
+    EXPECT_EQ(mirror.html(2), "<body><p id=\"a\">Hi</p><ul><li>x &lt; y</li></ul><!--c--></body>");
+    EXPECT_EQ(mirror.sequence(), 1u);
+}
+
+TEST_F(DomMirrorTest, InsertsAsFirstChild) {
+    ASSERT_TRUE(mirror.apply(R"JSON({"seq":1,"ops":[["insert",2,0,[[6,2,1,"br",{}]]]]})JSON"));
+
+    EXPECT_EQ(mirror.html(2), "<body><br><p id=\"a\">Hi</p><!--c--></body>");
+}
+
+TEST_F(DomMirrorTest, RemoveDropsWholeSubtree) {
+    ASSERT_TRUE(mirror.apply(R"JSON({"seq":1,"ops":[["remove",3]]})JSON"));
+
+    EXPECT_EQ(mirror.size(), 3u);
+    EXPECT_EQ(mirror.find(4), nullptr);
+    EXPECT_EQ(mirror.html(2), "<body><!--c--></body>");
+}
+
+TEST_F(DomMirrorTest, MovedNodeIsRemovedThenReinserted) {
+    ASSERT_TRUE(mirror.apply(R"JSON({"seq":1,"ops":[
+        ["remove",3],
+        ["insert",2,5,[[3,2,1,"p",{"id":"a"}],[4,3,3,"Hi"]]]]})JSON"));
+
+    EXPECT_EQ(mirror.html(2), "<body><!--c--><p id=\"a\">Hi</p></body>");
+    EXPECT_EQ(mirror.size(), 5u);
+}
+
+TEST_F(DomMirrorTest, AppliesAttributeAndTextChanges) {
+    ASSERT_TRUE(mirror.apply(R"JSON({"seq":1,"ops":[
+        ["attr",3,"class","big \"one\""],
+        ["attr",3,"id",null],
+        ["text",4,"Bye"]]})JSON"));
+
+    EXPECT_EQ(mirror.html(3), "<p class=\"big &quot;one&quot;\">Bye</p>");
+}
+
+TEST_F(DomMirrorTest, SequenceGapMakesMirrorStale) {
+    EXPECT_FALSE(mirror.apply(R"JSON({"seq":2,"ops":[["remove",3]]})JSON"));
+    // Even the expected next diff is refused until a new snapshot is loaded
+    EXPECT_FALSE(mirror.apply(R"JSON({"seq":1,"ops":[["remove",3]]})JSON"));
+    EXPECT_NE(mirror.find(3), nullptr);
+
+    ASSERT_TRUE(mirror.load(snapshot));
+    EXPECT_TRUE(mirror.apply(R"JSON({"seq":1,"ops":[["remove",3]]})JSON"));
+}
+
+TEST_F(DomMirrorTest, RejectsMalformedInput) {
+    DomMirror empty;
+    EXPECT_FALSE(empty.load("not json"));
+    EXPECT_FALSE(empty.apply(R"JSON({"seq":1,"ops":[]})JSON"));
+    EXPECT_FALSE(mirror.apply(R"JSON({"seq":1,"ops":[["explode",1]]})JSON"));
+}
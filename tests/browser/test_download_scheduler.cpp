@@ -0,0 +1,102 @@
+#include <gtest/gtest.h>
+#include "Browser/Browser.h"
+#include "FileOps/DownloadManager.h"
+#include "FileOps/DownloadScheduler.h"
+#include "FileOps/Sha256.h"
+#include "browser_test_environment.h"
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <unistd.h>
+
+extern std::unique_ptr<Browser> g_browser;
+
+using namespace FileOps;
+
+class DownloadSchedulerTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        browser = g_browser.get();
+        root = std::filesystem::temp_directory_path() / ("hweb_scheduler_" + std::to_string(getpid()));
+        std::filesystem::create_directories(root / "src");
+        std::filesystem::create_directories(root / "out");
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(root);
+    }
+
+    std::string sourceFile(const std::string& name, size_t bytes) {
+        auto path = root / "src" / name;
+        std::ofstream(path) << std::string(bytes, 'x');
+        return "file://" + path.string();
+    }
+
+    Browser* browser;
+    DownloadManager manager;
+    std::filesystem::path root;
+};
+
+TEST_F(DownloadSchedulerTest, EmptyBatchSucceedsImmediately) {
+    DownloadScheduler scheduler(*browser, manager);
+    EXPECT_TRUE(scheduler.waitForAll(100));
+}
+
+TEST_F(DownloadSchedulerTest, UnmatchedPatternTimesOut) {
+    DownloadScheduler scheduler(*browser, manager);
+    scheduler.expect("never-downloaded-*.bin");
+
+    EXPECT_FALSE(scheduler.waitForAll(200));
+    ASSERT_EQ(scheduler.jobs().size(), 1u);
+    EXPECT_EQ(scheduler.jobs()[0].result, DownloadResult::TIMEOUT);
+}
+
+TEST_F(DownloadSchedulerTest, RunsBatchUnderConcurrencyCap) {
+    DownloadScheduler scheduler(*browser, manager);
+    scheduler.setDownloadDirectory((root / "out").string());
+    scheduler.setMaxConcurrent(2);
+
+    size_t peak = 0;
+    scheduler.setProgressCallback([&](const DownloadProgress&) {
+        peak = std::max(peak, scheduler.activeCount());
+    });
+
+    scheduler.enqueue(sourceFile("a.txt", 1000));
+    scheduler.enqueue(sourceFile("b.txt", 2000));
+    scheduler.enqueue(sourceFile("c.txt", 3000));
+
+    EXPECT_TRUE(scheduler.waitForAll(10000));
+    EXPECT_LE(peak, 2u);
+    for (const auto& job : scheduler.jobs()) {
+        EXPECT_EQ(job.result, DownloadResult::SUCCESS) << job.uri;
+        EXPECT_TRUE(std::filesystem::exists(job.record.destination)) << job.record.destination;
+        EXPECT_EQ(job.record.sha256, Sha256::fileDigest(job.record.destination));
+    }
+    EXPECT_EQ(scheduler.committedBytes(), 6000u);
+}
+
+TEST_F(DownloadSchedulerTest, DigestMismatchFailsJob) {
+    DownloadScheduler scheduler(*browser, manager);
+    scheduler.setDownloadDirectory((root / "out").string());
+
+    std::string wrong(64, '0');
+    scheduler.enqueue(sourceFile("checked.txt", 500), wrong);
+
+    EXPECT_FALSE(scheduler.waitForAll(10000));
+    EXPECT_EQ(scheduler.jobs()[0].result, DownloadResult::INTEGRITY_CHECK_FAILED);
+}
+
+TEST_F(DownloadSchedulerTest, BudgetCancelsDownloadThatOverruns) {
+    DownloadScheduler scheduler(*browser, manager);
+    scheduler.setDownloadDirectory((root / "out").string());
+    scheduler.setMaxConcurrent(1);
+    scheduler.setDiskBudget(1500);
+
+    scheduler.enqueue(sourceFile("first.txt", 1000));
+    scheduler.enqueue(sourceFile("second.txt", 1000));
+
+    // The second download would take the batch past 1500 bytes
+    EXPECT_FALSE(scheduler.waitForAll(10000));
+    EXPECT_EQ(scheduler.jobs()[0].result, DownloadResult::SUCCESS);
+    EXPECT_EQ(scheduler.jobs()[1].result, DownloadResult::DISK_BUDGET_EXCEEDED);
+}
@@ -0,0 +1,67 @@
+#include <gtest/gtest.h>
+#include "Browser/Downloads.h"
+#include <filesystem>
+#include <fstream>
+#include <unistd.h>
+
+class DownloadsTest : public ::testing::Test {
+protected:
+    std::filesystem::path dir;
+
+    void SetUp() override {
+        dir = std::filesystem::temp_directory_path() / ("hweb_downloads_" + std::to_string(getpid()));
+        std::filesystem::create_directories(dir);
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(dir);
+    }
+
+    void touch(const std::string& name) {
+        std::ofstream(dir / name) << "x";
+    }
+};
+
+TEST_F(DownloadsTest, SanitizeKeepsOrdinaryNames) {
+    EXPECT_EQ(sanitizeDownloadFilename("report.pdf"), "report.pdf");
+    EXPECT_EQ(sanitizeDownloadFilename("my file (final).tar.gz"), "my file (final).tar.gz");
+}
+
+TEST_F(DownloadsTest, SanitizeCannotEscapeTheDirectory) {
+    EXPECT_EQ(sanitizeDownloadFilename("../../etc/passwd"), "_._.._etc_passwd");
+    EXPECT_EQ(sanitizeDownloadFilename("a\\b"), "a_b");
+    EXPECT_EQ(sanitizeDownloadFilename(".."), "download");
+    EXPECT_EQ(sanitizeDownloadFilename("."), "download");
+    EXPECT_EQ(sanitizeDownloadFilename(""), "download");
+    EXPECT_EQ(sanitizeDownloadFilename(".bashrc"), "_bashrc");
+    EXPECT_EQ(sanitizeDownloadFilename("name\n.txt"), "name_.txt");
+    EXPECT_EQ(sanitizeDownloadFilename("trailing. . "), "trailing");
+}
+
+TEST_F(DownloadsTest, UniquePathUsesFreeName) {
+    EXPECT_EQ(uniqueDownloadPath(dir.string(), "data.csv"), (dir / "data.csv").string());
+}
+
+TEST_F(DownloadsTest, UniquePathSkipsExistingFiles) {
+    touch("data.csv");
+    touch("data (1).csv");
+    EXPECT_EQ(uniqueDownloadPath(dir.string(), "data.csv"), (dir / "data (2).csv").string());
+}
+
+TEST_F(DownloadsTest, UniquePathSkipsReservedDestinations) {
+    std::set<std::string> reserved = {(dir / "data.csv").string()};
+    EXPECT_EQ(uniqueDownloadPath(dir.string(), "data.csv", reserved), (dir / "data (1).csv").string());
+    EXPECT_EQ(uniqueDownloadPath(dir.string(), "README", {(dir / "README").string()}), (dir / "README (1)").string());
+}
+
+TEST_F(DownloadsTest, RecordFilenamePrefersDestination) {
+    DownloadRecord record;
+    record.suggested_filename = "data.csv";
+    EXPECT_EQ(record.filename(), "data.csv");
+    EXPECT_FALSE(record.done());
+
+    record.destination = (dir / "data (1).csv").string();
+    record.state = DownloadRecord::State::FINISHED;
+    EXPECT_EQ(record.filename(), "data (1).csv");
+    EXPECT_TRUE(record.done());
+}
@@ -0,0 +1,38 @@
+#include <gtest/gtest.h>
+#include "Browser/ElementHandle.h"
+
+class ElementHandleTest : public ::testing::Test {
+protected:
+    std::shared_ptr<std::atomic<uint64_t>> generation = std::make_shared<std::atomic<uint64_t>>(0);
+};
+
+TEST_F(ElementHandleTest, DefaultHandleIsInvalid) {
+    ElementHandle handle;
+
+    EXPECT_FALSE(handle.valid());
+    EXPECT_FALSE(static_cast<bool>(handle));
+}
+
+TEST_F(ElementHandleTest, HandleCarriesIdAndSelector) {
+    ElementHandle handle("7", "#email", generation);
+
+    EXPECT_TRUE(handle.valid());
+    EXPECT_EQ(handle.id(), "7");
+    EXPECT_EQ(handle.selector(), "#email");
+    EXPECT_EQ(handle.ref(), "@hweb:7");
+}
+
+TEST_F(ElementHandleTest, NavigationInvalidatesHandle) {
+    ElementHandle before("1", "#a", generation);
+    generation->fetch_add(1);
+    ElementHandle after("1", "#a", generation);
+
+    EXPECT_FALSE(before.valid());
+    EXPECT_TRUE(after.valid());
+}
+
+TEST_F(ElementHandleTest, EmptyIdIsInvalid) {
+    ElementHandle handle("", "#missing", generation);
+
+    EXPECT_FALSE(handle.valid());
+}
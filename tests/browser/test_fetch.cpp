@@ -0,0 +1,102 @@
+#include <gtest/gtest.h>
+#include "Browser/Fetch.h"
+
+namespace {
+
+Cookie makeCookie(const std::string& name, const std::string& value, const std::string& domain,
+                  const std::string& path = "/", bool secure = false, int64_t expires = -1) {
+    Cookie cookie;
+    cookie.name = name;
+    cookie.value = value;
+    cookie.domain = domain;
+    cookie.path = path;
+    cookie.secure = secure;
+    cookie.httpOnly = false;
+    cookie.expires = expires;
+    return cookie;
+}
+
+const int64_t NOW = 1700000000;
+
+} // namespace
+
+TEST(FetchTest, DomainMatching) {
+    std::vector<Cookie> cookies = {
+        makeCookie("site", "1", ".example.com"),
+        makeCookie("host", "2", "api.example.com"),
+        makeCookie("other", "3", "example.org"),
+        makeCookie("suffix", "4", "ample.com"),
+    };
+
+    EXPECT_EQ(cookieHeaderFor(cookies, "https://api.example.com/v1/items", NOW), "site=1; host=2");
+    EXPECT_EQ(cookieHeaderFor(cookies, "https://EXAMPLE.com:8443/", NOW), "site=1");
+    EXPECT_EQ(cookieHeaderFor(cookies, "https://user:pw@www.example.com", NOW), "site=1");
+    EXPECT_EQ(cookieHeaderFor(cookies, "https://example.net/", NOW), "");
+}
+
+TEST(FetchTest, CookiesWithoutDomainAreNeverSent) {
+    std::vector<Cookie> cookies = {
+        makeCookie("orphan", "x", ""),
+        makeCookie("site", "1", "example.com"),
+    };
+
+    EXPECT_EQ(cookieHeaderFor(cookies, "https://example.com/", NOW), "site=1");
+    EXPECT_EQ(cookieHeaderFor(cookies, "https://attacker.test/", NOW), "");
+}
+
+TEST(FetchTest, PathSecureAndExpiry) {
+    std::vector<Cookie> cookies = {
+        makeCookie("root", "r", "example.com", "/"),
+        makeCookie("docs", "d", "example.com", "/docs"),
+        makeCookie("tls", "t", "example.com", "/", true),
+        makeCookie("old", "o", "example.com", "/", false, NOW - 1),
+        makeCookie("later", "l", "example.com", "/", false, NOW + 60),
+    };
+
+    // Longest path first, as browsers send them
+    EXPECT_EQ(cookieHeaderFor(cookies, "https://example.com/docs/intro?x=1", NOW), "docs=d; root=r; tls=t; later=l");
+    EXPECT_EQ(cookieHeaderFor(cookies, "http://example.com/docsearch", NOW), "root=r; later=l");
+    EXPECT_EQ(cookieHeaderFor(cookies, "http://example.com/docs", NOW), "docs=d; root=r; later=l");
+}
+
+TEST(FetchTest, FirstCookieOfANameDomainAndPathWins) {
+    std::vector<Cookie> cookies = {
+        makeCookie("session", "live", "example.com"),
+        makeCookie("session", "saved", ".EXAMPLE.com"),
+    };
+    EXPECT_EQ(cookieHeaderFor(cookies, "https://example.com/", NOW), "session=live");
+    EXPECT_EQ(cookieHeaderFor(cookies, "not a url", NOW), "");
+}
+
+TEST(FetchTest, SameNameWithOtherScopeIsStillSent) {
+    std::vector<Cookie> cookies = {
+        makeCookie("id", "host", "app.example.com"),
+        makeCookie("id", "parent", "example.com"),
+        makeCookie("id", "api", "app.example.com", "/api"),
+    };
+    EXPECT_EQ(cookieHeaderFor(cookies, "https://app.example.com/api/v1", NOW), "id=api; id=host; id=parent");
+    EXPECT_EQ(cookieHeaderFor(cookies, "https://app.example.com/", NOW), "id=host; id=parent");
+}
+
+TEST(FetchTest, RefererFollowsStrictOriginWhenCrossOrigin) {
+    std::string page = "https://user:pw@shop.example.com/cart?id=7#pay";
+    EXPECT_EQ(refererFor(page, "https://shop.example.com:443/file.zip"), "https://shop.example.com/cart?id=7");
+    EXPECT_EQ(refererFor(page, "https://cdn.example.net/file.zip"), "https://shop.example.com/");
+    EXPECT_EQ(refererFor(page, "https://shop.example.com:8443/file.zip"), "https://shop.example.com/");
+    EXPECT_EQ(refererFor(page, "http://shop.example.com/file.zip"), "");
+    EXPECT_EQ(refererFor("http://example.com/a", "https://example.com/b"), "http://example.com/");
+    EXPECT_EQ(refererFor("about:blank", "https://example.com/"), "");
+    EXPECT_EQ(refererFor("file:///tmp/page.html", "https://example.com/"), "");
+}
+
+TEST(FetchTest, ResponseOkNeedsSuccessStatusAndNoError) {
+    FetchResponse response;
+    EXPECT_FALSE(response.ok());
+    response.status = 204;
+    EXPECT_TRUE(response.ok());
+    response.error = "output closed";
+    EXPECT_FALSE(response.ok());
+    response.error.clear();
+    response.status = 404;
+    EXPECT_FALSE(response.ok());
+}
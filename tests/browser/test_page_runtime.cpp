@@ -0,0 +1,225 @@
+#include <gtest/gtest.h>
+#include "Browser/Browser.h"
+#include "Browser/PageRuntime.h"
+#include "../utils/SafePageLoader.h"
+#include "browser_test_environment.h"
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+extern std::unique_ptr<Browser> g_browser;
+
+class PageRuntimeTest : public ::testing::Test {
+};
+
+// Runs the runtime against pages loaded into the shared test browser
+class PageRuntimeBrowserTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        browser = g_browser.get();
+        ASSERT_NE(browser, nullptr) << "Global browser should be initialized";
+    }
+
+    // Page bodies go into a data: URL as-is, so they must not contain '#' or '%'
+    bool load(const std::string& body) {
+        auto result = TestUtils::SafePageLoader::loadMinimalTestPage(browser, body);
+        EXPECT_TRUE(result.success) << result.error_message;
+        return result.success;
+    }
+
+    Browser* browser;
+};
+
+TEST_F(PageRuntimeTest, CallBodyBindsArgumentsByPosition) {
+    std::string body = PageRuntime::callBody("fill", 2);
+
+    EXPECT_NE(body.find("window.__hweb.fill(a0, a1)"), std::string::npos);
+    EXPECT_NE(body.find(PageRuntime::MISSING_MARKER), std::string::npos);
+}
+
+TEST_F(PageRuntimeTest, CallBodyDependsOnlyOnMethodAndArity) {
+    // Identical bodies let WebKit reuse the compiled function across calls
+    EXPECT_EQ(PageRuntime::callBody("exists", 1), PageRuntime::callBody("exists", 1));
+    EXPECT_NE(PageRuntime::callBody("exists", 1), PageRuntime::callBody("count", 1));
+}
+
+TEST_F(PageRuntimeTest, CallBodyWithoutArguments) {
+    EXPECT_NE(PageRuntime::callBody("ping", 0).find("window.__hweb.ping()"), std::string::npos);
+}
+
+TEST_F(PageRuntimeTest, SourceIsIdempotentAndDefinesMethods) {
+    const std::string& source = PageRuntime::source();
+
+    EXPECT_NE(source.find("if (window.__hweb) return;"), std::string::npos);
+    for (const char* method : {"exists", "count", "fill", "click", "getAttr", "setAttr", "innerText"}) {
+        EXPECT_NE(source.find(std::string(method) + ": function("), std::string::npos) << method;
+    }
+}
+
+TEST_F(PageRuntimeTest, ReadableModeAvoidsLayout) {
+    const std::string& source = PageRuntime::source();
+    size_t begin = source.find("function mainContent()");
+    size_t end = source.find("var H = {");
+    ASSERT_NE(begin, std::string::npos);
+    ASSERT_NE(source.find("readable: function(format)"), std::string::npos);
+
+    // Content selection and serialization read textContent only; innerText would force layout
+    EXPECT_EQ(source.substr(begin, end - begin).find("innerText"), std::string::npos);
+}
+
+TEST_F(PageRuntimeTest, FillFormIsOnePassWithPerFieldStatus) {
+    const std::string& source = PageRuntime::source();
+    size_t begin = source.find("fillForm: function(json)");
+    ASSERT_NE(begin, std::string::npos);
+    ASSERT_NE(source.find("function fillField(el, value)"), std::string::npos);
+
+    // Every key gets a status; a failing field must not abort the rest
+    std::string method = source.substr(begin, source.find("},", begin) - begin);
+    EXPECT_NE(method.find("'not_found'"), std::string::npos);
+    EXPECT_NE(method.find("catch (e)"), std::string::npos);
+}
+
+TEST_F(PageRuntimeTest, DomMirrorDiffsGoThroughOwnHandler) {
+    const std::string& source = PageRuntime::source();
+    ASSERT_NE(source.find("domSnapshot: function()"), std::string::npos);
+    ASSERT_NE(source.find("domUnwatch: function()"), std::string::npos);
+
+    // Diffs are batched and pushed, never polled through the chunk channel
+    size_t flush = source.find("function mirrorFlush()");
+    ASSERT_NE(flush, std::string::npos);
+    std::string body = source.substr(flush, source.find("var H = {") - flush);
+    EXPECT_NE(body.find("hwebMutation.postMessage"), std::string::npos);
+    EXPECT_EQ(body.find("hwebChunk"), std::string::npos);
+}
+
+// ========== Behaviour against a loaded page ==========
+
+TEST_F(PageRuntimeBrowserTest, CachedLookupsFollowDomInserts) {
+    ASSERT_TRUE(load("<ul id='list'><li>a</li><li>b</li></ul>"));
+
+    EXPECT_EQ(browser->countElements("li"), 2);
+    EXPECT_TRUE(browser->elementExists("ul > li"));
+
+    browser->executeJavascriptSync("document.getElementById('list').appendChild(document.createElement('li')); 'ok'");
+    EXPECT_EQ(browser->countElements("li"), 3);
+
+    // An insert and a query in the same task: the observer has not fired yet
+    std::string same_task = browser->executeJavascriptSync(
+        "document.getElementById('list').appendChild(document.createElement('li'));"
+        "String(window.__hweb.count('li'))");
+    EXPECT_EQ(same_task, "4");
+
+    browser->executeJavascriptSync("document.getElementById('list').textContent = ''; 'ok'");
+    EXPECT_EQ(browser->countElements("li"), 0);
+    EXPECT_FALSE(browser->elementExists("ul > li"));
+}
+
+TEST_F(PageRuntimeBrowserTest, StatePseudoClassesAreNeverServedFromCache) {
+    ASSERT_TRUE(load("<input type='checkbox' id='terms'>"));
+
+    EXPECT_FALSE(browser->elementExists("input:checked"));
+    EXPECT_EQ(browser->countElements("input:checked"), 0);
+
+    // Setting the property changes no attribute, so no mutation is recorded
+    browser->executeJavascriptSync("document.getElementById('terms').checked = true; 'ok'");
+    EXPECT_TRUE(browser->elementExists("input:checked"));
+    EXPECT_EQ(browser->countElements("input:checked"), 1);
+
+    browser->executeJavascriptSync("document.getElementById('terms').checked = false; 'ok'");
+    EXPECT_FALSE(browser->elementExists("input:checked"));
+}
+
+TEST_F(PageRuntimeBrowserTest, InvalidSelectorKeepsReportingItsError) {
+    ASSERT_TRUE(load("<ul><li>a</li></ul>"));
+
+    // The parse error is cached with the selector and must be reported on every call
+    EXPECT_THROW(browser->countElements("li["), std::runtime_error);
+    EXPECT_THROW(browser->countElements("li["), std::runtime_error);
+    EXPECT_EQ(browser->elementExistsWithValidation("li["), -1);
+    EXPECT_EQ(browser->countElements("li"), 1);
+}
+
+TEST_F(PageRuntimeBrowserTest, ReadableModeExtractsTheArticle) {
+    const std::string paragraph =
+        "The runtime picks the main content of a page by scoring its paragraphs, "
+        "and it reads only textContent so that no layout is forced while it does, "
+        "which keeps extraction cheap even on very long documents.";
+    ASSERT_TRUE(load("<nav><a href='/a'>Home</a> <a href='/b'>About us</a></nav>"
+                     "<article><h1>Field notes</h1><p>" + paragraph + "</p>"
+                     "<p hidden>Not for readers</p><ul><li>first point</li><li>second point</li></ul></article>"
+                     "<footer>Footer links</footer>"));
+
+    std::string text;
+    ASSERT_TRUE(browser->streamReadableContent(false, [&text](const char* data, size_t length) {
+        text.append(data, length);
+    }));
+    EXPECT_EQ(text.find("Field notes"), 0u);
+    EXPECT_NE(text.find(paragraph), std::string::npos);
+    EXPECT_NE(text.find("- first point\n- second point"), std::string::npos);
+    EXPECT_EQ(text.find("About us"), std::string::npos);
+    EXPECT_EQ(text.find("Footer links"), std::string::npos);
+    EXPECT_EQ(text.find("Not for readers"), std::string::npos);
+
+    std::string markdown;
+    ASSERT_TRUE(browser->streamReadableContent(true, [&markdown](const char* data, size_t length) {
+        markdown.append(data, length);
+    }));
+    EXPECT_EQ(markdown.find("# Field notes\n\n"), 0u);
+    EXPECT_NE(markdown.find("- first point"), std::string::npos);
+}
+
+TEST_F(PageRuntimeBrowserTest, FillFormReportsEveryFieldAndKeepsGoing) {
+    ASSERT_TRUE(load("<form><input name='first' id='first'><input type='checkbox' name='terms'>"
+                     "<select name='size'><option value='s'>S</option><option value='m'>M</option></select>"
+                     "<input name='locked' disabled></form>"));
+
+    // Failing keys come first; the fields after them must still be filled
+    auto status = browser->fillForm(
+        R"({"missing": "x", "size": "xl", "locked": "y", "first": "Ada", "terms": true})");
+
+    ASSERT_EQ(status.size(), 5u);
+    EXPECT_EQ(status["missing"], "not_found");
+    EXPECT_EQ(status["size"].rfind("no_option", 0), 0u) << status["size"];
+    EXPECT_EQ(status["locked"], "disabled");
+    EXPECT_EQ(status["first"], "ok");
+    EXPECT_EQ(status["terms"], "ok");
+
+    EXPECT_EQ(browser->executeJavascriptSync("document.getElementById('first').value"), "Ada");
+    EXPECT_TRUE(browser->elementExists("input[name=terms]:checked"));
+}
+
+TEST_F(PageRuntimeBrowserTest, DomMirrorFollowsPageChanges) {
+    ASSERT_TRUE(load("<ul id='list'><li class='a'>one</li></ul>"));
+
+    std::vector<std::string> diffs;
+    auto bus = browser->getEventBus();
+    size_t subscription = bus->subscribe(BrowserEvents::EventType::DOM_MUTATION,
+        [&diffs](const BrowserEvents::Event& event) { diffs.push_back(event.data); },
+        [](const BrowserEvents::Event& event) { return event.target == "dom-diff"; });
+
+    std::string snapshot;
+    ASSERT_TRUE(browser->snapshotDom([&snapshot](const char* data, size_t length) {
+        snapshot.append(data, length);
+    }));
+    DomMirror mirror;
+    ASSERT_TRUE(mirror.load(snapshot));
+    EXPECT_NE(mirror.html().find("<ul id=\"list\"><li class=\"a\">one</li></ul>"), std::string::npos);
+
+    browser->executeJavascriptSync(
+        "var li = document.createElement('li'); li.textContent = 'two';"
+        "document.getElementById('list').appendChild(li);"
+        "document.querySelector('li').className = 'b'; 'ok'");
+    for (int i = 0; i < 50 && diffs.empty(); ++i) {
+        browser->wait(100);
+    }
+    browser->stopDomDiffs();
+    bus->unsubscribe(subscription);
+
+    // Diffs arrive as DOM_MUTATION events, not as stream slices
+    ASSERT_FALSE(diffs.empty());
+    for (const auto& diff : diffs) {
+        ASSERT_TRUE(mirror.apply(diff)) << diff;
+    }
+    EXPECT_NE(mirror.html().find("<ul id=\"list\"><li class=\"b\">one</li><li>two</li></ul>"), std::string::npos)
+        << mirror.html();
+}
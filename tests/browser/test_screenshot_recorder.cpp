@@ -0,0 +1,107 @@
+#include <gtest/gtest.h>
+#include "Browser/ScreenshotRecorder.h"
+#include <cstdlib>
+#include <cstring>
+
+class FrameRingTest : public ::testing::Test {
+protected:
+    // Frame backed by a small malloc'd buffer carrying the given hash
+    RecordedFrame makeFrame(const std::string& hash, long long timestamp_ms) {
+        RecordedFrame frame;
+        unsigned char* bytes = static_cast<unsigned char*>(std::malloc(16));
+        std::memset(bytes, 0, 16);
+        frame.pixels.reset(bytes, 16, std::free);
+        frame.pixels.hash = hash;
+        frame.timestamp_ms = timestamp_ms;
+        frame.trigger = "interval";
+        return frame;
+    }
+};
+
+TEST_F(FrameRingTest, KeepsFramesInCaptureOrder) {
+    FrameRing ring(4);
+
+    EXPECT_TRUE(ring.push(makeFrame("a", 0), true));
+    EXPECT_TRUE(ring.push(makeFrame("b", 10), true));
+    EXPECT_TRUE(ring.push(makeFrame("c", 20), true));
+
+    ASSERT_EQ(ring.size(), 3);
+    EXPECT_EQ(ring.at(0).pixels.hash, "a");
+    EXPECT_EQ(ring.at(2).pixels.hash, "c");
+    EXPECT_EQ(ring.dropped(), 0);
+}
+
+TEST_F(FrameRingTest, DropsOldestWhenFull) {
+    FrameRing ring(2);
+
+    ring.push(makeFrame("a", 0), true);
+    ring.push(makeFrame("b", 10), true);
+    ring.push(makeFrame("c", 20), true);
+
+    ASSERT_EQ(ring.size(), 2);
+    EXPECT_EQ(ring.at(0).pixels.hash, "b");
+    EXPECT_EQ(ring.at(1).pixels.hash, "c");
+    EXPECT_EQ(ring.dropped(), 1);
+}
+
+TEST_F(FrameRingTest, CoalescesConsecutiveDuplicates) {
+    FrameRing ring(4);
+
+    ring.push(makeFrame("a", 0), true);
+    EXPECT_FALSE(ring.push(makeFrame("a", 10), true));
+    EXPECT_FALSE(ring.push(makeFrame("a", 20), true));
+    ring.push(makeFrame("b", 30), true);
+
+    ASSERT_EQ(ring.size(), 2);
+    EXPECT_EQ(ring.at(0).repeats, 3);
+    EXPECT_EQ(ring.at(1).repeats, 1);
+}
+
+TEST_F(FrameRingTest, KeepsDuplicatesWhenCoalescingDisabled) {
+    FrameRing ring(4);
+
+    ring.push(makeFrame("a", 0), false);
+    ring.push(makeFrame("a", 10), false);
+
+    EXPECT_EQ(ring.size(), 2);
+}
+
+TEST_F(FrameRingTest, AtOutOfRangeThrows) {
+    FrameRing ring(2);
+    ring.push(makeFrame("a", 0), true);
+
+    EXPECT_THROW(ring.at(1), std::out_of_range);
+}
+
+// ========== Viewport List Tests ==========
+
+TEST(ViewportListTest, ParsesWidthsWithDefaultHeight) {
+    auto viewports = parseViewportList("375,768,1280,1920", 800);
+
+    ASSERT_EQ(viewports.size(), 4);
+    EXPECT_EQ(viewports[0], std::make_pair(375, 800));
+    EXPECT_EQ(viewports[3], std::make_pair(1920, 800));
+}
+
+TEST(ViewportListTest, ParsesExplicitHeights) {
+    auto viewports = parseViewportList("375x667,1280", 800);
+
+    ASSERT_EQ(viewports.size(), 2);
+    EXPECT_EQ(viewports[0], std::make_pair(375, 667));
+    EXPECT_EQ(viewports[1], std::make_pair(1280, 800));
+}
+
+TEST(ViewportListTest, DropsRepeatedSizes) {
+    auto viewports = parseViewportList("375,375,375x667,1280,375", 667);
+
+    ASSERT_EQ(viewports.size(), 2);
+    EXPECT_EQ(viewports[0], std::make_pair(375, 667));
+    EXPECT_EQ(viewports[1], std::make_pair(1280, 667));
+}
+
+TEST(ViewportListTest, RejectsMalformedEntries) {
+    EXPECT_TRUE(parseViewportList("375,abc", 800).empty());
+    EXPECT_TRUE(parseViewportList("375px", 800).empty());
+    EXPECT_TRUE(parseViewportList("0,768", 800).empty());
+    EXPECT_TRUE(parseViewportList("375x", 800).empty());
+}
@@ -0,0 +1,154 @@
+#include <gtest/gtest.h>
+#include "Browser/ScreenshotStore.h"
+#include "../utils/test_helpers.h"
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+class ScreenshotStoreTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        temp_dir = std::make_unique<TestHelpers::TemporaryDirectory>("screenshot_store_tests");
+        store_dir = (temp_dir->getPath() / "store").string();
+        std::filesystem::create_directories(store_dir);
+    }
+
+    void TearDown() override {
+        temp_dir.reset();
+    }
+
+    // Solid ARGB32 frame of the given color (B, G, R, A byte order)
+    std::vector<unsigned char> makeFrame(int width, int height, unsigned char b, unsigned char g, unsigned char r) {
+        std::vector<unsigned char> frame(static_cast<size_t>(width) * height * 4);
+        for (size_t i = 0; i < frame.size(); i += 4) {
+            frame[i] = b;
+            frame[i + 1] = g;
+            frame[i + 2] = r;
+            frame[i + 3] = 0xFF;
+        }
+        return frame;
+    }
+
+    std::unique_ptr<TestHelpers::TemporaryDirectory> temp_dir;
+    std::string store_dir;
+};
+
+// ========== Hashing Tests ==========
+
+TEST_F(ScreenshotStoreTest, Xxh64KnownVectors) {
+    EXPECT_EQ(ScreenshotStore::xxh64("", 0), 0xEF46DB3751D8E999ULL);
+    EXPECT_EQ(ScreenshotStore::xxh64("abc", 3), 0x44BC2CF5AD770999ULL);
+}
+
+TEST_F(ScreenshotStoreTest, HashPixelsIdenticalFrames) {
+    auto a = makeFrame(64, 48, 10, 20, 30);
+    auto b = makeFrame(64, 48, 10, 20, 30);
+
+    EXPECT_EQ(ScreenshotStore::hashPixels(a.data(), 64, 48, 64 * 4),
+              ScreenshotStore::hashPixels(b.data(), 64, 48, 64 * 4));
+}
+
+TEST_F(ScreenshotStoreTest, HashPixelsDetectsSinglePixelChange) {
+    auto a = makeFrame(64, 48, 10, 20, 30);
+    auto b = a;
+    b[(10 * 64 + 10) * 4] ^= 1;
+
+    EXPECT_NE(ScreenshotStore::hashPixels(a.data(), 64, 48, 64 * 4),
+              ScreenshotStore::hashPixels(b.data(), 64, 48, 64 * 4));
+}
+
+TEST_F(ScreenshotStoreTest, HashPixelsIncludesDimensions) {
+    auto frame = makeFrame(32, 32, 0, 0, 0);
+
+    EXPECT_NE(ScreenshotStore::hashPixels(frame.data(), 32, 32, 32 * 4),
+              ScreenshotStore::hashPixels(frame.data(), 64, 16, 64 * 4));
+}
+
+TEST_F(ScreenshotStoreTest, PerceptualHashToleratesNoise) {
+    auto a = makeFrame(128, 128, 0, 0, 0);
+    // Right half white so the average hash has structure
+    for (int y = 0; y < 128; ++y) {
+        for (int x = 64; x < 128; ++x) {
+            unsigned char* px = &a[(y * 128 + x) * 4];
+            px[0] = px[1] = px[2] = 0xFF;
+        }
+    }
+    auto b = a;
+    b[(5 * 128 + 5) * 4] = 3;
+
+    uint64_t ha = ScreenshotStore::perceptualHash(a.data(), 128, 128, 128 * 4);
+    uint64_t hb = ScreenshotStore::perceptualHash(b.data(), 128, 128, 128 * 4);
+    EXPECT_LE(ScreenshotStore::hammingDistance(ha, hb), 2);
+    EXPECT_NE(ha, 0ULL);
+}
+
+TEST_F(ScreenshotStoreTest, ToHexIsFixedWidth) {
+    EXPECT_EQ(ScreenshotStore::toHex(0), "0000000000000000");
+    EXPECT_EQ(ScreenshotStore::toHex(0xABCDEFULL), "0000000000abcdef");
+}
+
+// ========== Store Tests ==========
+
+TEST_F(ScreenshotStoreTest, IngestAndMaterialize) {
+    ScreenshotStore store(store_dir);
+    auto source = temp_dir->createFile("first.png", "png-bytes");
+    std::string hash = "0123456789abcdef";
+
+    EXPECT_FALSE(store.contains(hash));
+    EXPECT_TRUE(store.ingest(hash, source.string()));
+    EXPECT_TRUE(store.contains(hash));
+
+    auto destination = temp_dir->getPath() / "second.png";
+    EXPECT_TRUE(store.materialize(hash, destination.string()));
+    EXPECT_TRUE(std::filesystem::equivalent(destination, store.blobPath(hash)));
+}
+
+TEST_F(ScreenshotStoreTest, MaterializeUnknownHashFails) {
+    ScreenshotStore store(store_dir);
+    auto destination = temp_dir->getPath() / "missing.png";
+
+    EXPECT_FALSE(store.materialize("ffffffffffffffff", destination.string()));
+    EXPECT_FALSE(std::filesystem::exists(destination));
+}
+
+TEST_F(ScreenshotStoreTest, LinkOrCopyReplacesExistingFile) {
+    auto source = temp_dir->createFile("source.png", "new");
+    auto destination = temp_dir->createFile("dest.png", "old");
+
+    EXPECT_TRUE(ScreenshotStore::linkOrCopy(source.string(), destination.string()));
+    EXPECT_TRUE(std::filesystem::equivalent(source, destination));
+}
+
+TEST_F(ScreenshotStoreTest, ReplaceFileLeavesLinkedBlobIntact) {
+    ScreenshotStore store(store_dir);
+    auto capture = temp_dir->createFile("monitor.png", "first-frame");
+    std::string hash = "00aa00aa00aa00aa";
+    ASSERT_TRUE(store.ingest(hash, capture.string()));
+    auto earlier = temp_dir->getPath() / "earlier.png";
+    ASSERT_TRUE(store.materialize(hash, earlier.string()));
+
+    // Next capture to the same filename with different pixels
+    EXPECT_TRUE(ScreenshotStore::replaceFile(capture.string(), [](const std::string& temp_path) {
+        std::ofstream file(temp_path, std::ios::binary);
+        file << "second-frame";
+        return file.good();
+    }));
+
+    EXPECT_EQ(TestHelpers::readFileContent(capture), "second-frame");
+    EXPECT_EQ(TestHelpers::readFileContent(store.blobPath(hash)), "first-frame");
+    EXPECT_EQ(TestHelpers::readFileContent(earlier), "first-frame");
+}
+
+TEST_F(ScreenshotStoreTest, ReplaceFileKeepsOldFileWhenWriterFails) {
+    auto capture = temp_dir->createFile("monitor.png", "first-frame");
+
+    EXPECT_FALSE(ScreenshotStore::replaceFile(capture.string(), [](const std::string& temp_path) {
+        std::ofstream(temp_path) << "partial";
+        return false;
+    }));
+
+    EXPECT_EQ(TestHelpers::readFileContent(capture), "first-frame");
+    EXPECT_EQ(std::distance(std::filesystem::directory_iterator(temp_dir->getPath()),
+                            std::filesystem::directory_iterator()), 2);  // store/ and monitor.png
+}
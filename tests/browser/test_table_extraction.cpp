@@ -0,0 +1,83 @@
+#include <gtest/gtest.h>
+#include "Browser/TableExtraction.h"
+
+class TableExtractionTest : public ::testing::Test {
+protected:
+    Json::Value cells(std::initializer_list<const char*> values) {
+        Json::Value row(Json::arrayValue);
+        for (const char* value : values) {
+            row.append(value ? Json::Value(value) : Json::Value());
+        }
+        return row;
+    }
+};
+
+TEST_F(TableExtractionTest, ParsesObjectFieldsWithAttributes) {
+    TableSpec spec;
+    std::string error;
+    ASSERT_TRUE(parseTableSpec(R"JSON({"rows": "tr", "fields": {"name": "td:nth-child(1)", "link": "a@href", "id": "@data-id"}})JSON", spec, error)) << error;
+
+    EXPECT_EQ(spec.row_selector, "tr");
+    ASSERT_EQ(spec.fields.size(), 3u);
+    // Object members come back sorted by name
+    EXPECT_EQ(spec.fields[0].name, "id");
+    EXPECT_EQ(spec.fields[0].selector, "");
+    EXPECT_EQ(spec.fields[0].attribute, "data-id");
+    EXPECT_EQ(spec.fields[1].name, "link");
+    EXPECT_EQ(spec.fields[1].selector, "a");
+    EXPECT_EQ(spec.fields[1].attribute, "href");
+    EXPECT_EQ(spec.fields[2].selector, "td:nth-child(1)");
+    EXPECT_EQ(spec.fields[2].attribute, "");
+}
+
+TEST_F(TableExtractionTest, ArrayFieldsKeepColumnOrder) {
+    TableSpec spec;
+    std::string error;
+    ASSERT_TRUE(parseTableSpec(R"JSON({"rows": ".item", "fields": [{"name": "title", "selector": "h2"}, {"name": "img", "selector": "img", "attr": "src"}]})JSON", spec, error)) << error;
+
+    ASSERT_EQ(spec.fields.size(), 2u);
+    EXPECT_EQ(spec.fields[0].name, "title");
+    EXPECT_EQ(spec.fields[1].name, "img");
+    EXPECT_EQ(spec.fields[1].attribute, "src");
+}
+
+TEST_F(TableExtractionTest, RejectsMalformedSpecs) {
+    TableSpec spec;
+    std::string error;
+
+    EXPECT_FALSE(parseTableSpec("not json", spec, error));
+    EXPECT_FALSE(parseTableSpec(R"JSON({"fields": {"a": "b"}})JSON", spec, error));
+    EXPECT_FALSE(parseTableSpec(R"JSON({"rows": "tr"})JSON", spec, error));
+    EXPECT_FALSE(parseTableSpec(R"JSON({"rows": "tr", "fields": {"a": 5}})JSON", spec, error));
+    EXPECT_FALSE(error.empty());
+}
+
+TEST_F(TableExtractionTest, SelectorWithAttributeMatchIsNotSplit) {
+    TableSpec spec;
+    std::string error;
+    ASSERT_TRUE(parseTableSpec(R"JSON({"rows": "tr", "fields": {"a": "a[href^='mailto:x@y.com']"}})JSON", spec, error));
+
+    EXPECT_EQ(spec.fields[0].selector, "a[href^='mailto:x@y.com']");
+    EXPECT_EQ(spec.fields[0].attribute, "");
+}
+
+TEST_F(TableExtractionTest, FormatsCsvWithQuoting) {
+    TableSpec spec;
+    std::string error;
+    ASSERT_TRUE(parseTableSpec(R"JSON({"rows": "tr", "fields": [{"name": "a", "selector": "x"}, {"name": "b", "selector": "y"}, {"name": "c", "selector": "z"}]})JSON", spec, error));
+
+    EXPECT_EQ(formatTableHeader(spec), "a,b,c");
+    EXPECT_EQ(formatTableRow(spec, cells({"plain", "with, comma", "say \"hi\""}), TableFormat::CSV),
+              "plain,\"with, comma\",\"say \"\"hi\"\"\"");
+    EXPECT_EQ(formatTableRow(spec, cells({"x", nullptr, "z"}), TableFormat::CSV), "x,,z");
+}
+
+TEST_F(TableExtractionTest, FormatsNdjsonWithNullForMissing) {
+    TableSpec spec;
+    std::string error;
+    ASSERT_TRUE(parseTableSpec(R"JSON({"rows": "tr", "fields": [{"name": "name", "selector": "td"}, {"name": "link", "selector": "a", "attr": "href"}]})JSON", spec, error));
+
+    std::string line = formatTableRow(spec, cells({"Ada", nullptr}), TableFormat::NDJSON);
+    EXPECT_EQ(line, "{\"link\":null,\"name\":\"Ada\"}");
+    EXPECT_EQ(line.find('\n'), std::string::npos);
+}
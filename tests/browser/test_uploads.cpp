@@ -0,0 +1,98 @@
+#include <gtest/gtest.h>
+#include "Browser/Uploads.h"
+
+using Clock = std::chrono::steady_clock;
+
+TEST(UploadsTest, FirstMessageAddsTransfer) {
+    std::vector<UploadTransfer> transfers;
+    auto now = Clock::now();
+
+    UploadTransfer* transfer = applyUploadMessage(transfers,
+        R"({"id":"a:1","url":"/upload","files":["one.txt","two.txt"],"state":"progress","sent":0,"total":30,"status":0})", now);
+
+    ASSERT_NE(transfer, nullptr);
+    ASSERT_EQ(transfers.size(), 1u);
+    EXPECT_EQ(transfer->url, "/upload");
+    EXPECT_TRUE(transfer->carries("two.txt"));
+    EXPECT_FALSE(transfer->carries("three.txt"));
+    EXPECT_EQ(transfer->total_bytes, 30u);
+    EXPECT_FALSE(transfer->done());
+}
+
+TEST(UploadsTest, ProgressUpdatesTheSameTransfer) {
+    std::vector<UploadTransfer> transfers;
+    auto start = Clock::now();
+    applyUploadMessage(transfers, R"({"id":"a:1","files":["big.bin"],"state":"progress","sent":0,"total":1000})", start);
+    applyUploadMessage(transfers, R"({"id":"a:1","state":"progress","sent":400,"total":1200})",
+                       start + std::chrono::milliseconds(100));
+    applyUploadMessage(transfers, R"({"id":"a:1","state":"progress","sent":800,"total":1200})",
+                       start + std::chrono::milliseconds(600));
+    UploadTransfer* transfer = applyUploadMessage(transfers, R"({"id":"a:1","state":"done","sent":0,"total":0,"status":201})",
+                                                  start + std::chrono::milliseconds(1000));
+
+    ASSERT_EQ(transfers.size(), 1u);
+    ASSERT_NE(transfer, nullptr);
+    EXPECT_EQ(transfer->state, UploadTransfer::State::FINISHED);
+    EXPECT_EQ(transfer->http_status, 201);
+    // The body size reported by progress events wins over the files' size
+    EXPECT_EQ(transfer->total_bytes, 1200u);
+    EXPECT_EQ(transfer->sent_bytes, 1200u);
+    EXPECT_EQ(transfer->longest_stall_ms, 500);
+    EXPECT_EQ(transfer->elapsedMs(), 1000);
+    EXPECT_DOUBLE_EQ(transfer->throughput(), 1200.0);
+}
+
+TEST(UploadsTest, FailedTransferKeepsItsState) {
+    std::vector<UploadTransfer> transfers;
+    auto now = Clock::now();
+    applyUploadMessage(transfers, R"({"id":"a:2","files":["x.pdf"],"state":"progress","sent":0,"total":10})", now);
+    applyUploadMessage(transfers, R"({"id":"a:2","state":"failed","status":413})", now);
+    applyUploadMessage(transfers, R"({"id":"a:2","state":"done","status":200})", now);
+
+    EXPECT_EQ(transfers[0].state, UploadTransfer::State::FAILED);
+    EXPECT_EQ(transfers[0].http_status, 413);
+    EXPECT_EQ(transfers[0].sent_bytes, 0u);
+}
+
+TEST(UploadsTest, MessagesWithoutTheTokenAreIgnored) {
+    std::vector<UploadTransfer> transfers;
+    auto now = Clock::now();
+
+    EXPECT_EQ(applyUploadMessage(transfers, R"({"id":"a:1","files":["x.pdf"],"state":"done","status":200})",
+                                 now, "secret"), nullptr);
+    EXPECT_EQ(applyUploadMessage(transfers, R"({"token":"guess","id":"a:1","files":["x.pdf"],"state":"done"})",
+                                 now, "secret"), nullptr);
+    EXPECT_TRUE(transfers.empty());
+
+    EXPECT_NE(applyUploadMessage(transfers, R"({"token":"secret","id":"a:1","files":["x.pdf"],"state":"progress"})",
+                                 now, "secret"), nullptr);
+    EXPECT_EQ(transfers.size(), 1u);
+}
+
+TEST(UploadsTest, SameNamedFilesGetTheirOwnTransfers) {
+    std::vector<UploadTransfer> transfers;
+    auto now = Clock::now();
+    applyUploadMessage(transfers, R"({"id":"old","files":["report.csv"],"state":"done"})", now);
+    applyUploadMessage(transfers, R"({"id":"a:1","files":["report.csv"],"state":"done","status":201})", now);
+    applyUploadMessage(transfers, R"({"id":"a:2","files":["notes.txt"],"state":"failed","status":500})", now);
+    applyUploadMessage(transfers, R"({"id":"a:3","files":["report.csv"],"state":"failed","status":413})", now);
+
+    auto matched = matchUploadTransfers(transfers, 1, {"report.csv", "notes.txt", "report.csv", "missing.bin"});
+
+    ASSERT_EQ(matched.size(), 4u);
+    EXPECT_EQ(matched[0], 1);
+    EXPECT_EQ(matched[1], 2);
+    EXPECT_EQ(matched[2], 3);
+    EXPECT_EQ(matched[3], -1);
+
+    // A single file takes the latest transfer carrying its name
+    EXPECT_EQ(matchUploadTransfers(transfers, 0, {"report.csv"}), std::vector<long>{3});
+}
+
+TEST(UploadsTest, MalformedMessagesAreIgnored) {
+    std::vector<UploadTransfer> transfers;
+    EXPECT_EQ(applyUploadMessage(transfers, "not json"), nullptr);
+    EXPECT_EQ(applyUploadMessage(transfers, R"(["a:1"])"), nullptr);
+    EXPECT_EQ(applyUploadMessage(transfers, R"({"state":"progress"})"), nullptr);
+    EXPECT_TRUE(transfers.empty());
+}
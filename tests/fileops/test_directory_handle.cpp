@@ -0,0 +1,106 @@
+#include <gtest/gtest.h>
+#include "FileOps/DirectoryHandle.h"
+#include "../utils/test_helpers.h"
+#include <fcntl.h>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <unistd.h>
+
+using namespace FileOps;
+
+class DirectoryHandleTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        temp_dir = std::make_unique<TestHelpers::TemporaryDirectory>("directory_handle_tests");
+    }
+
+    void TearDown() override {
+        temp_dir.reset();
+    }
+
+    static std::string readFile(const std::filesystem::path& path) {
+        std::ifstream file(path, std::ios::binary);
+        std::stringstream content;
+        content << file.rdbuf();
+        return content.str();
+    }
+
+    std::unique_ptr<TestHelpers::TemporaryDirectory> temp_dir;
+};
+
+TEST_F(DirectoryHandleTest, CreatesMissingDirectories) {
+    std::filesystem::path target = temp_dir->getPath() / "shots" / "2024" / "run";
+
+    DirectoryHandle directory(target.string());
+
+    ASSERT_TRUE(directory.isOpen());
+    EXPECT_EQ(directory.error(), 0);
+    EXPECT_TRUE(std::filesystem::is_directory(target));
+    EXPECT_EQ(directory.pathFor("frame.png"), (target / "frame.png").string());
+}
+
+TEST_F(DirectoryHandleTest, OpenWithoutCreateFails) {
+    std::filesystem::path missing = temp_dir->getPath() / "missing";
+
+    DirectoryHandle directory(missing.string(), false);
+
+    EXPECT_FALSE(directory.isOpen());
+    EXPECT_EQ(directory.error(), ENOENT);
+    EXPECT_FALSE(std::filesystem::exists(missing));
+
+    std::filesystem::path file = temp_dir->createFile("plain.txt", "x");
+    DirectoryHandle over_file((file / "below").string());
+    EXPECT_FALSE(over_file.isOpen());
+    EXPECT_FALSE(DirectoryHandle("").isOpen());
+}
+
+TEST_F(DirectoryHandleTest, WritesRenamesAndRemovesEntries) {
+    DirectoryHandle directory(temp_dir->getPath().string());
+    ASSERT_TRUE(directory.isOpen());
+
+    ASSERT_TRUE(directory.writeFile("data.part", "hello", 5));
+    EXPECT_TRUE(directory.exists("data.part"));
+    ASSERT_TRUE(directory.rename("data.part", "data.bin"));
+    EXPECT_FALSE(directory.exists("data.part"));
+    EXPECT_EQ(readFile(temp_dir->getPath() / "data.bin"), "hello");
+
+    // Rewriting truncates
+    ASSERT_TRUE(directory.writeFile("data.bin", "hi", 2));
+    EXPECT_EQ(readFile(temp_dir->getPath() / "data.bin"), "hi");
+
+    EXPECT_TRUE(directory.remove("data.bin"));
+    EXPECT_FALSE(std::filesystem::exists(temp_dir->getPath() / "data.bin"));
+}
+
+TEST_F(DirectoryHandleTest, RejectsNamesOutsideTheDirectory) {
+    std::filesystem::path inner = temp_dir->getPath() / "inner";
+    DirectoryHandle directory(inner.string());
+    ASSERT_TRUE(directory.isOpen());
+
+    EXPECT_FALSE(directory.writeFile("../escape.txt", "x", 1));
+    EXPECT_FALSE(directory.writeFile("/tmp/escape.txt", "x", 1));
+    EXPECT_FALSE(directory.writeFile("..", "x", 1));
+    EXPECT_FALSE(directory.writeFile("", "x", 1));
+    EXPECT_EQ(directory.openFile("sub/file.txt", O_WRONLY | O_CREAT), -1);
+    EXPECT_FALSE(std::filesystem::exists(temp_dir->getPath() / "escape.txt"));
+
+    EXPECT_TRUE(DirectoryHandle::isPlainName("frame-0001.png"));
+    EXPECT_FALSE(DirectoryHandle::isPlainName("a/b"));
+}
+
+TEST_F(DirectoryHandleTest, HandleFollowsMovedDirectory) {
+    std::filesystem::path original = temp_dir->getPath() / "before";
+    DirectoryHandle directory(original.string());
+    ASSERT_TRUE(directory.isOpen());
+
+    std::filesystem::rename(original, temp_dir->getPath() / "after");
+
+    // Entries resolve against the open descriptor, not the path
+    ASSERT_TRUE(directory.writeFile("frame.png", "png", 3));
+    EXPECT_TRUE(std::filesystem::exists(temp_dir->getPath() / "after" / "frame.png"));
+
+    DirectoryHandle moved(std::move(directory));
+    EXPECT_TRUE(moved.isOpen());
+    EXPECT_FALSE(directory.isOpen());
+}
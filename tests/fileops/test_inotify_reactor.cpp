@@ -0,0 +1,121 @@
+#include <gtest/gtest.h>
+#include "FileOps/InotifyReactor.h"
+#include "../utils/test_helpers.h"
+#include <sys/inotify.h>
+#include <condition_variable>
+#include <filesystem>
+#include <fstream>
+
+using namespace FileOps;
+
+class InotifyReactorTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        temp_dir = std::make_unique<TestHelpers::TemporaryDirectory>("inotify_reactor_tests");
+        InotifyReactor::instance().setCoalesceWindow(std::chrono::milliseconds(25));
+    }
+
+    void TearDown() override {
+        for (int token : tokens) {
+            InotifyReactor::instance().removeWatch(token);
+        }
+        temp_dir.reset();
+    }
+
+    int watch(uint32_t mask) {
+        int token = InotifyReactor::instance().addWatch(temp_dir->getPath().string(), mask,
+            [this](const std::string& name, uint32_t event_mask) {
+                std::lock_guard<std::mutex> lock(mutex);
+                events.emplace_back(name, event_mask);
+                cv.notify_all();
+            });
+        if (token != -1) {
+            tokens.push_back(token);
+        }
+        return token;
+    }
+
+    bool waitForEvents(size_t count, int timeout_ms = 2000) {
+        std::unique_lock<std::mutex> lock(mutex);
+        return cv.wait_for(lock, std::chrono::milliseconds(timeout_ms), [&] { return events.size() >= count; });
+    }
+
+    size_t countEvents(const std::string& name, uint32_t mask) {
+        std::lock_guard<std::mutex> lock(mutex);
+        size_t count = 0;
+        for (const auto& event : events) {
+            if (event.first == name && (event.second & mask)) {
+                count++;
+            }
+        }
+        return count;
+    }
+
+    std::unique_ptr<TestHelpers::TemporaryDirectory> temp_dir;
+    std::vector<int> tokens;
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::vector<std::pair<std::string, uint32_t>> events;
+};
+
+TEST_F(InotifyReactorTest, DeliversCreateEvents) {
+    ASSERT_NE(watch(IN_CREATE), -1);
+
+    std::ofstream(temp_dir->getPath() / "created.txt") << "data";
+
+    ASSERT_TRUE(waitForEvents(1));
+    EXPECT_EQ(countEvents("created.txt", IN_CREATE), 1u);
+}
+
+TEST_F(InotifyReactorTest, CoalescesModifyBursts) {
+    ASSERT_NE(watch(IN_MODIFY | IN_CLOSE_WRITE), -1);
+
+    {
+        std::ofstream file(temp_dir->getPath() / "burst.bin", std::ios::binary);
+        for (int i = 0; i < 200; ++i) {
+            file << std::string(512, 'x');
+            file.flush();
+        }
+    }
+
+    // The close must not overtake the modifies held back before it
+    ASSERT_TRUE(waitForEvents(2));
+    std::lock_guard<std::mutex> lock(mutex);
+    size_t modifies = 0;
+    for (const auto& event : events) {
+        if (event.second & IN_MODIFY) {
+            modifies++;
+        }
+    }
+    EXPECT_GE(modifies, 1u);
+    EXPECT_LT(modifies, 200u);
+    EXPECT_TRUE(events.back().second & IN_CLOSE_WRITE);
+}
+
+TEST_F(InotifyReactorTest, SharesDirectoryBetweenWatches) {
+    ASSERT_NE(watch(IN_CREATE), -1);
+    ASSERT_NE(watch(IN_CREATE), -1);
+    EXPECT_GE(InotifyReactor::instance().watchCount(), 2u);
+
+    std::ofstream(temp_dir->getPath() / "shared.txt") << "data";
+
+    ASSERT_TRUE(waitForEvents(2));
+    EXPECT_EQ(countEvents("shared.txt", IN_CREATE), 2u);
+}
+
+TEST_F(InotifyReactorTest, RemovedWatchStopsDelivery) {
+    int token = watch(IN_CREATE);
+    ASSERT_NE(token, -1);
+    InotifyReactor::instance().removeWatch(token);
+    tokens.clear();
+
+    std::ofstream(temp_dir->getPath() / "ignored.txt") << "data";
+
+    EXPECT_FALSE(waitForEvents(1, 200));
+}
+
+TEST_F(InotifyReactorTest, MissingDirectoryFails) {
+    int token = InotifyReactor::instance().addWatch(
+        (temp_dir->getPath() / "missing").string(), IN_CREATE, [](const std::string&, uint32_t) {});
+    EXPECT_EQ(token, -1);
+}
@@ -0,0 +1,137 @@
+#include <gtest/gtest.h>
+#include "FileOps/MimeSniffer.h"
+#include "FileOps/Types.h"
+#include "FileOps/UploadManager.h"
+#include "../utils/test_helpers.h"
+#include <filesystem>
+#include <fstream>
+
+using namespace FileOps;
+
+class MimeSnifferTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        temp_dir = std::make_unique<TestHelpers::TemporaryDirectory>("mime_sniffer_tests");
+    }
+
+    void TearDown() override {
+        temp_dir.reset();
+    }
+
+    std::string writeFile(const std::string& name, const std::string& content) {
+        std::filesystem::path path = temp_dir->getPath() / name;
+        std::ofstream file(path, std::ios::binary);
+        file << content;
+        return path.string();
+    }
+
+    static std::string sniff(const std::string& bytes) {
+        return MimeSniffer::sniff(reinterpret_cast<const uint8_t*>(bytes.data()), bytes.size());
+    }
+
+    std::unique_ptr<TestHelpers::TemporaryDirectory> temp_dir;
+};
+
+TEST_F(MimeSnifferTest, RecognisesMagicNumbers) {
+    EXPECT_EQ(sniff(std::string("\x89PNG\r\n\x1a\n\0\0\0\x0dIHDR", 16)), "image/png");
+    EXPECT_EQ(sniff("\xFF\xD8\xFF\xE0\0\x10JFIF"), "image/jpeg");
+    EXPECT_EQ(sniff("GIF89a\x01\0"), "image/gif");
+    EXPECT_EQ(sniff("%PDF-1.7\n"), "application/pdf");
+    EXPECT_EQ(sniff(std::string("\x1F\x8B\x08\0", 4)), "application/gzip");
+    EXPECT_EQ(sniff("\x7F" "ELF\x02\x01"), "application/x-executable");
+    EXPECT_EQ(sniff(std::string("SQLite format 3\0", 16)), "application/vnd.sqlite3");
+    EXPECT_EQ(sniff("plain words"), "");
+    EXPECT_EQ(sniff(""), "");
+}
+
+TEST_F(MimeSnifferTest, WildcardBytesAndLongestMatch) {
+    EXPECT_EQ(sniff(std::string("RIFF\x24\x08\0\0WEBPVP8 ", 16)), "image/webp");
+    EXPECT_EQ(sniff(std::string("RIFF\x24\x08\0\0WAVEfmt ", 16)), "audio/wav");
+    EXPECT_EQ(sniff(std::string("\0\0\0\x20" "ftypisom", 12)), "video/mp4");
+    EXPECT_EQ(sniff(std::string("\0\0\0\x1C" "ftypheic", 12)), "image/heic");
+    EXPECT_EQ(sniff(std::string("\0\0\0\x20" "ftypM4A ", 12)), "audio/mp4");
+}
+
+TEST_F(MimeSnifferTest, TellsZipContainersApart) {
+    // Stored entry: 20 byte body (offset 18), 8 byte name (offset 26)
+    std::string local_header("PK\3\4\x14\0\0\0\0\0\0\0\0\0\0\0\0\0\x14\0\0\0\x14\0\0\0\x08\0\0\0", 30);
+    EXPECT_EQ(sniff(local_header + "mimetypeapplication/epub+zipPK"), "application/epub+zip");
+    EXPECT_EQ(sniff(local_header + "word/document.xml"), "application/vnd.openxmlformats-officedocument.wordprocessingml.document");
+    EXPECT_EQ(sniff(local_header + "notes.txt"), "application/zip");
+    EXPECT_EQ(sniff("<?xml version=\"1.0\"?>\n<svg xmlns=\"http://www.w3.org/2000/svg\"/>"), "image/svg+xml");
+}
+
+TEST_F(MimeSnifferTest, DetectFallsBackToTextAndExtension) {
+    std::string text = "{\"key\": \"value\"}";
+    auto data = reinterpret_cast<const uint8_t*>(text.data());
+    EXPECT_EQ(MimeSniffer::detect(data, text.size(), "config.json"), "application/json");
+    EXPECT_EQ(MimeSniffer::detect(data, text.size(), "config.unknown"), "text/plain");
+
+    // Bytes without a signature never overrule the name
+    std::string binary("\x01\x02\x03\xFE\x00", 5);
+    auto raw = reinterpret_cast<const uint8_t*>(binary.data());
+    EXPECT_EQ(MimeSniffer::detect(raw, binary.size(), "photo.png"), "image/png");
+    EXPECT_EQ(MimeSniffer::detect(raw, binary.size(), "movie.mkv"), "video/x-matroska");
+    EXPECT_EQ(MimeSniffer::detect(raw, binary.size(), "blob.unknown"), "application/octet-stream");
+    EXPECT_TRUE(MimeSniffer::looksLikeText(reinterpret_cast<const uint8_t*>("na\xC3\xAFve"), 6));
+}
+
+TEST_F(MimeSnifferTest, RecognisesEveryMpegFrameSync) {
+    for (uint8_t second : {0xE2, 0xE3, 0xE4, 0xE5, 0xE6, 0xE7, 0xF2, 0xF3, 0xF4, 0xF5, 0xF6, 0xF7,
+                           0xFA, 0xFB, 0xFC, 0xFD, 0xFF}) {
+        std::string frame = {'\xFF', static_cast<char>(second), '\x90', '\x00'};
+        EXPECT_EQ(sniff(frame), "audio/mpeg") << std::hex << int(second);
+    }
+    // Reserved version or layer bits are not a frame header
+    EXPECT_EQ(sniff(std::string("\xFF\xE8\x90\x00", 4)), "");
+    EXPECT_EQ(sniff(std::string("\xFF\xF0\x90\x00", 4)), "");
+}
+
+TEST_F(MimeSnifferTest, InconclusiveContentKeepsItsExtension) {
+    UploadManager manager;
+    // Excel-style Latin-1 export: not valid UTF-8
+    std::string latin1 = writeFile("export.csv", "name;city\nJos\xE9;Z\xFCrich\n");
+    std::string utf16 = writeFile("notes.txt", std::string("\xFF\xFEh\0i\0\n\0", 8));
+    std::string utf16be = writeFile("notes-be.txt", std::string("\xFE\xFF\0h\0i", 6));
+    std::string mpeg2 = writeFile("voice.mp3", std::string("\xFF\xF3\x84\xC4\0\0\0\0", 8));
+
+    EXPECT_EQ(MimeSniffer::detectFile(latin1), "text/csv");
+    EXPECT_TRUE(MimeSniffer::contentMatchesExtension(MimeSniffer::detectFile(latin1), "csv"));
+    EXPECT_TRUE(manager.validateFileType(latin1, {"csv"}));
+
+    EXPECT_EQ(MimeSniffer::detectFile(utf16), "text/plain");
+    EXPECT_EQ(MimeSniffer::detectFile(utf16be), "text/plain");
+    EXPECT_TRUE(manager.validateFileType(utf16, {"txt"}));
+
+    EXPECT_EQ(MimeSniffer::detectFile(mpeg2), "audio/mpeg");
+    EXPECT_TRUE(manager.validateFileType(mpeg2, {"mp3"}));
+    EXPECT_TRUE(manager.validateFileType(mpeg2, {"audio/*"}));
+}
+
+TEST_F(MimeSnifferTest, FileInfoSniffsContent) {
+    std::string path = writeFile("renamed.txt", std::string("\x89PNG\r\n\x1a\n\0\0\0\x0dIHDR", 16));
+
+    FileInfo info = FileInfo::create(path);
+
+    EXPECT_TRUE(info.exists);
+    EXPECT_TRUE(info.is_readable);
+    EXPECT_EQ(info.size_bytes, 16u);
+    EXPECT_EQ(info.mime_type, "image/png");
+    EXPECT_FALSE(info.isOlderThan(std::chrono::minutes(1)));
+}
+
+TEST_F(MimeSnifferTest, ValidateFileTypeChecksContent) {
+    UploadManager manager;
+    std::string image = writeFile("picture.png", std::string("\x89PNG\r\n\x1a\n\0\0\0\x0dIHDR", 16));
+    std::string disguised = writeFile("tool.png", "\x7F" "ELF\x02\x01\x01\0");
+    std::string script = writeFile("run.png", "#!/bin/sh\nrm -rf ~\n");
+    std::string notes = writeFile("notes.txt", "hello\n");
+
+    EXPECT_TRUE(manager.validateFileType(image, {"png"}));
+    EXPECT_FALSE(manager.validateFileType(disguised, {"png"}));
+    EXPECT_FALSE(manager.validateFileType(script, {"png"}));
+    EXPECT_TRUE(manager.validateFileType(image, {"image/*"}));
+    EXPECT_FALSE(manager.validateFileType(notes, {"image/*"}));
+    EXPECT_TRUE(manager.validateFileType(notes, {".TXT"}));
+    EXPECT_EQ(manager.detectMimeType(disguised), "application/x-executable");
+}
@@ -166,6 +166,12 @@ TEST_F(PathUtilsTest, CreateDirectoriesIfNeededAlreadyExists) {
     EXPECT_TRUE(result); // Should succeed even if already exists
 }
 
+TEST_F(PathUtilsTest, CreateDirectoriesIfNeededOverFile) {
+    EXPECT_FALSE(PathUtils::createDirectoriesIfNeeded(test_file.string()));
+    EXPECT_FALSE(PathUtils::createDirectoriesIfNeeded((test_file / "below").string()));
+    EXPECT_TRUE(std::filesystem::is_regular_file(test_file));
+}
+
 // ========== File System Queries ==========
 
 TEST_F(PathUtilsTest, ExistsFile) {
@@ -233,6 +239,35 @@ TEST_F(PathUtilsTest, IsSecurePathDangerous) {
     EXPECT_FALSE(PathUtils::isSecurePath("path/with\\..\\traversal"));
 }
 
+TEST_F(PathUtilsTest, CachedResultsMatchUncached) {
+    PathUtils::clearPathCache();
+    
+    for (int pass = 0; pass < 2; ++pass) {
+        EXPECT_EQ(PathUtils::normalizePath("/path/./to/../file.txt"), "/path/file.txt");
+        EXPECT_TRUE(PathUtils::isSecurePath("/path/./to/../file.txt"));
+        EXPECT_FALSE(PathUtils::isSecurePath("../../../etc/passwd"));
+        EXPECT_FALSE(PathUtils::isSecurePath("shots/<frame>.png"));
+    }
+    EXPECT_EQ(PathUtils::pathCacheSize(), 3u);
+    
+    PathUtils::clearPathCache();
+    EXPECT_EQ(PathUtils::pathCacheSize(), 0u);
+}
+
+TEST_F(PathUtilsTest, PathCacheIsBounded) {
+    PathUtils::clearPathCache();
+    
+    for (int i = 0; i < 1000; ++i) {
+        std::string path = "shots/frame-" + std::to_string(i) + ".png";
+        ASSERT_TRUE(PathUtils::isSecurePath(path));
+    }
+    EXPECT_LE(PathUtils::pathCacheSize(), 256u);
+    
+    // Evicted entries are simply recomputed
+    EXPECT_EQ(PathUtils::normalizePath("shots/./frame-0.png"), "shots/frame-0.png");
+    EXPECT_TRUE(PathUtils::isSecurePath("shots/frame-0.png"));
+}
+
 TEST_F(PathUtilsTest, SanitizeFileName) {
     EXPECT_EQ(PathUtils::sanitizeFileName("safe_file.txt"), "safe_file.txt");
     
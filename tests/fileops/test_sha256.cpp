@@ -0,0 +1,151 @@
+#include <gtest/gtest.h>
+#include "FileOps/Sha256.h"
+#include "../utils/test_helpers.h"
+#include <filesystem>
+#include <fstream>
+
+using namespace FileOps;
+
+class Sha256Test : public ::testing::Test {
+protected:
+    void SetUp() override {
+        temp_dir = std::make_unique<TestHelpers::TemporaryDirectory>("sha256_tests");
+    }
+
+    void TearDown() override {
+        temp_dir.reset();
+    }
+
+    std::unique_ptr<TestHelpers::TemporaryDirectory> temp_dir;
+};
+
+TEST_F(Sha256Test, KnownVectors) {
+    Sha256 sha;
+    EXPECT_EQ(sha.finishHex(), "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855");
+
+    sha.update("abc", 3);
+    EXPECT_EQ(sha.finishHex(), "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+
+    std::string two_blocks = "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq";
+    sha.update(two_blocks.data(), two_blocks.size());
+    EXPECT_EQ(sha.finishHex(), "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1");
+}
+
+TEST_F(Sha256Test, SplitUpdatesMatchOneShot) {
+    std::string million(1000000, 'a');
+
+    Sha256 sha;
+    for (size_t offset = 0; offset < million.size(); offset += 7777) {
+        sha.update(million.data() + offset, std::min<size_t>(7777, million.size() - offset));
+    }
+    EXPECT_EQ(sha.finishHex(), "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0");
+}
+
+TEST_F(Sha256Test, StreamingHashFollowsGrowingFile) {
+    auto path = temp_dir->getPath() / "growing.bin";
+    std::ofstream out(path, std::ios::binary);
+
+    StreamingFileHash hash;
+    EXPECT_FALSE(hash.advance((temp_dir->getPath() / "missing.bin").string()));
+
+    std::string expected_content;
+    for (int i = 0; i < 5; ++i) {
+        std::string part(1000 + i * 4096, static_cast<char>('a' + i));
+        out << part << std::flush;
+        expected_content += part;
+        ASSERT_TRUE(hash.advance(path.string()));
+        EXPECT_EQ(hash.consumed(), expected_content.size());
+    }
+    out.close();
+
+    Sha256 reference;
+    reference.update(expected_content.data(), expected_content.size());
+    EXPECT_EQ(hash.finish(path.string()), reference.finishHex());
+    EXPECT_EQ(Sha256::fileDigest(path.string()), Sha256::fileDigest(path.string()));
+}
+
+TEST_F(Sha256Test, SinkReceivesEveryChunk) {
+    std::filesystem::path path = temp_dir->getPath() / "streamed.bin";
+    std::ofstream out(path, std::ios::binary);
+
+    std::string forwarded;
+    StreamingFileHash hash;
+    hash.setSink([&](const uint8_t* data, size_t length) {
+        forwarded.append(reinterpret_cast<const char*>(data), length);
+        return true;
+    });
+
+    std::string expected_content;
+    for (int i = 0; i < 3; ++i) {
+        std::string part(70000 + i, static_cast<char>('x' + i));
+        out << part << std::flush;
+        expected_content += part;
+        ASSERT_TRUE(hash.advance(path.string()));
+        EXPECT_EQ(forwarded.size(), expected_content.size());
+    }
+    out.close();
+
+    EXPECT_EQ(hash.finish(path.string()), Sha256::fileDigest(path.string()));
+    EXPECT_EQ(forwarded, expected_content);
+    EXPECT_FALSE(hash.sinkFailed());
+}
+
+TEST_F(Sha256Test, ReleaseConsumedPunchesOutForwardedBlocks) {
+    std::filesystem::path path = temp_dir->getPath() / "scratch.bin";
+    std::string content(300000, 's');
+    std::ofstream(path, std::ios::binary) << content;
+    std::string expected = Sha256::fileDigest(path.string());
+
+    std::string forwarded;
+    StreamingFileHash hash;
+    hash.setReleaseConsumed(true);
+    hash.setSink([&](const uint8_t* data, size_t length) {
+        forwarded.append(reinterpret_cast<const char*>(data), length);
+        return true;
+    });
+
+    ASSERT_TRUE(hash.advance(path.string()));
+    EXPECT_EQ(forwarded, content);
+    EXPECT_EQ(std::filesystem::file_size(path), content.size());
+
+    // Consumed whole blocks read back as zeros where the file system supports holes
+    std::ifstream in(path, std::ios::binary);
+    std::string head(4096, '\0');
+    in.read(&head[0], head.size());
+    if (head != std::string(4096, '\0')) {
+        GTEST_SKIP() << "file system does not support punching holes";
+    }
+    std::string tail(content.size() % 4096, '\0');
+    in.seekg(static_cast<std::streamoff>(content.size() - tail.size()));
+    in.read(&tail[0], tail.size());
+    EXPECT_EQ(tail, std::string(tail.size(), 's'));
+    EXPECT_EQ(hash.finish(path.string()), expected);
+}
+
+TEST_F(Sha256Test, RefusingSinkStopsForwardingButNotHashing) {
+    std::filesystem::path path = temp_dir->getPath() / "refused.bin";
+    std::ofstream(path, std::ios::binary) << std::string(200000, 'r');
+
+    size_t calls = 0;
+    StreamingFileHash hash;
+    hash.setSink([&](const uint8_t*, size_t) {
+        ++calls;
+        return false;
+    });
+
+    EXPECT_EQ(hash.finish(path.string()), Sha256::fileDigest(path.string()));
+    EXPECT_TRUE(hash.sinkFailed());
+    EXPECT_EQ(calls, 1u);
+}
+
+TEST_F(Sha256Test, FileDigestOfUnreadableFileIsEmpty) {
+    EXPECT_EQ(Sha256::fileDigest((temp_dir->getPath() / "missing.bin").string()), "");
+}
+
+TEST_F(Sha256Test, DigestComparison) {
+    std::string digest = "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad";
+    EXPECT_TRUE(Sha256::digestMatches(digest, "BA7816BF8F01CFEA414140DE5DAE2223B00361A396177A9CB410FF61F20015AD"));
+    EXPECT_TRUE(Sha256::digestMatches(digest, "sha256:" + digest));
+    EXPECT_FALSE(Sha256::digestMatches(digest, digest.substr(1)));
+    EXPECT_FALSE(Sha256::digestMatches("", ""));
+}
@@ -55,6 +55,8 @@ TEST_F(FileOpsTypesTest, DownloadResultEnumValues) {
     EXPECT_EQ(static_cast<int>(DownloadResult::PERMISSION_DENIED), 4);
     EXPECT_EQ(static_cast<int>(DownloadResult::DIRECTORY_NOT_FOUND), 5);
     EXPECT_EQ(static_cast<int>(DownloadResult::PATTERN_MATCH_FAILED), 6);
+    EXPECT_EQ(static_cast<int>(DownloadResult::DOWNLOAD_FAILED), 7);
+    EXPECT_EQ(static_cast<int>(DownloadResult::DISK_BUDGET_EXCEEDED), 8);
 }
 
 TEST_F(FileOpsTypesTest, WaitConditionEnumValues) {
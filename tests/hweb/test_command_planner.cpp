@@ -0,0 +1,160 @@
+#include <gtest/gtest.h>
+#include "../../src/hweb/Commands/Planner.h"
+#include <sstream>
+
+using HWeb::Command;
+using HWeb::CommandPlanner;
+
+class CommandPlannerTest : public ::testing::Test {
+protected:
+    Json::Value parse(const std::string& text) {
+        Json::Value value;
+        Json::CharReaderBuilder reader;
+        std::string errors;
+        std::istringstream stream(text);
+        Json::parseFromStream(reader, stream, &value, &errors);
+        return value;
+    }
+
+    Json::Value valueResult(const std::string& value) {
+        Json::Value result;
+        result["value"] = value;
+        return result;
+    }
+};
+
+TEST_F(CommandPlannerTest, GroupsFormFillIntoOneBatch) {
+    std::vector<Command> commands = {
+        {"select", "#country", "NZ"},
+        {"check", "#terms", ""},
+        {"uncheck", "#newsletter", ""},
+        {"click", "#submit", ""},
+        {"exists", "#result", ""}
+    };
+
+    auto batches = CommandPlanner::plan(commands);
+
+    // The click may navigate, so it closes the first batch
+    ASSERT_EQ(batches.size(), 2);
+    EXPECT_EQ(batches[0].begin, 0);
+    EXPECT_EQ(batches[0].end, 4);
+    EXPECT_TRUE(batches[0].compiled);
+    EXPECT_EQ(batches[1].begin, 4);
+    EXPECT_FALSE(batches[1].compiled);
+}
+
+TEST_F(CommandPlannerTest, TypingIsNeverBatched) {
+    // Typing goes through WebKit's editor for trusted input events
+    EXPECT_FALSE(CommandPlanner::is_batchable("type"));
+    EXPECT_FALSE(CommandPlanner::is_batchable("fill-enhanced"));
+
+    std::vector<Command> commands = {
+        {"type", "#first", "Ada"},
+        {"type", "#last", "Lovelace"},
+        {"check", "#terms", ""},
+        {"click", "#submit", ""}
+    };
+
+    auto batches = CommandPlanner::plan(commands);
+
+    ASSERT_EQ(batches.size(), 3);
+    EXPECT_FALSE(batches[0].compiled);
+    EXPECT_FALSE(batches[1].compiled);
+    EXPECT_TRUE(batches[2].compiled);
+    EXPECT_EQ(batches[2].begin, 2);
+}
+
+TEST_F(CommandPlannerTest, SplitsAtNonBatchableCommands) {
+    std::vector<Command> commands = {
+        {"focus", "#q", ""},
+        {"exists", "#q", ""},
+        {"screenshot", "out.png", ""},
+        {"count", "li", ""},
+        {"exists", "a", ""}
+    };
+
+    auto batches = CommandPlanner::plan(commands);
+
+    ASSERT_EQ(batches.size(), 3);
+    EXPECT_TRUE(batches[0].compiled);
+    EXPECT_EQ(batches[0].end, 2);
+    EXPECT_FALSE(batches[1].compiled);
+    EXPECT_TRUE(batches[2].compiled);
+    EXPECT_EQ(batches[2].begin, 3);
+    EXPECT_EQ(batches[2].end, 5);
+}
+
+TEST_F(CommandPlannerTest, UnboundedOutputIsNeverBatched) {
+    // A batch result is one capped string; these go through their own handlers
+    for (const char* type : {"html", "text", "attr"}) {
+        EXPECT_FALSE(CommandPlanner::is_batchable(type)) << type;
+    }
+
+    std::vector<Command> commands = {
+        {"exists", "#title", ""},
+        {"count", "p", ""},
+        {"text", "#content", ""},
+        {"count", "li", ""},
+        {"exists", "a", ""}
+    };
+
+    auto batches = CommandPlanner::plan(commands);
+
+    ASSERT_EQ(batches.size(), 3);
+    EXPECT_TRUE(batches[0].compiled);
+    EXPECT_EQ(batches[1].begin, 2);
+    EXPECT_FALSE(batches[1].compiled);
+    EXPECT_TRUE(batches[2].compiled);
+}
+
+TEST_F(CommandPlannerTest, CompilePassesValuesAsData) {
+    std::vector<Command> commands = {
+        {"select", "select[name='q']", "it's \"quoted\""},
+        {"uncheck", "#opt", ""}
+    };
+
+    Json::Value steps = parse(CommandPlanner::compile(commands, {0, 2, true}));
+
+    ASSERT_EQ(steps.size(), 2);
+    EXPECT_EQ(steps[0]["op"].asString(), "select");
+    EXPECT_EQ(steps[0]["args"][0].asString(), "select[name='q']");
+    EXPECT_EQ(steps[0]["args"][1].asString(), "it's \"quoted\"");
+    EXPECT_EQ(steps[0]["wait"].asInt(), CommandPlanner::ELEMENT_WAIT_MS);
+    EXPECT_EQ(steps[1]["op"].asString(), "setChecked");
+    EXPECT_EQ(steps[1]["args"][1].asString(), "false");
+}
+
+TEST_F(CommandPlannerTest, InterpretInteractionResults) {
+    Command click = {"click", "#go", ""};
+
+    auto ok = CommandPlanner::interpret(click, valueResult("CLICKED_SUCCESS"));
+    EXPECT_TRUE(ok.ok);
+    EXPECT_EQ(ok.message, "Clicked: #go");
+
+    auto missing = CommandPlanner::interpret(click, valueResult("ELEMENT_NOT_FOUND"));
+    EXPECT_FALSE(missing.ok);
+    EXPECT_EQ(missing.message, "ELEMENT_NOT_FOUND");
+}
+
+TEST_F(CommandPlannerTest, InterpretDataResults) {
+    auto exists = CommandPlanner::interpret({"exists", "#none", ""}, valueResult("false"));
+    EXPECT_TRUE(exists.ok);
+    EXPECT_TRUE(exists.has_output);
+    EXPECT_EQ(exists.output, "false");
+
+    auto count = CommandPlanner::interpret({"count", "li", ""}, valueResult("7"));
+    EXPECT_EQ(count.output, "7");
+
+    auto bad = CommandPlanner::interpret({"count", "li[", ""}, valueResult("SELECTOR_ERROR:bad"));
+    EXPECT_FALSE(bad.ok);
+    EXPECT_NE(bad.message.find("Invalid CSS selector"), std::string::npos);
+}
+
+TEST_F(CommandPlannerTest, InterpretStepError) {
+    Json::Value result;
+    result["error"] = "boom";
+
+    auto outcome = CommandPlanner::interpret({"select", "#a", "x"}, result);
+    EXPECT_FALSE(outcome.ok);
+    EXPECT_EQ(outcome.message, "boom");
+}
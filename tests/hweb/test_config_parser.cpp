@@ -163,4 +163,156 @@ TEST_F(ConfigParserTest, ParseAssertionCommands) {
     EXPECT_EQ(config.assertions[2].type, "count");
     EXPECT_EQ(config.assertions[2].selector, ".item");
     EXPECT_EQ(config.assertions[2].expected_value, ">5");
-}
\ No newline at end of file
+}
+TEST_F(ConfigParserTest, ParseScreenshotStoreOptions) {
+    std::vector<std::string> args = {
+        "--screenshot-store", "/tmp/shots",
+        "--screenshot-phash",
+        "--screenshot", "page.png"
+    };
+    
+    auto config = parser.parseArguments(args);
+    
+    EXPECT_EQ(config.screenshot_store_dir, "/tmp/shots");
+    EXPECT_TRUE(config.screenshot_perceptual_hash);
+    ASSERT_EQ(config.commands.size(), 1);
+    EXPECT_EQ(config.commands[0].type, "screenshot");
+    EXPECT_EQ(config.commands[0].selector, "page.png");
+}
+
+TEST_F(ConfigParserTest, ParseScreenshotBurst) {
+    std::vector<std::string> args = {
+        "--screenshot-burst", "frames", "3000", "events",
+        "--screenshot-burst", "frames2", "1000"
+    };
+    
+    auto config = parser.parseArguments(args);
+    
+    ASSERT_EQ(config.commands.size(), 2);
+    EXPECT_EQ(config.commands[0].type, "screenshot-burst");
+    EXPECT_EQ(config.commands[0].selector, "frames");
+    EXPECT_EQ(config.commands[0].value, "3000,events");
+    EXPECT_EQ(config.commands[1].selector, "frames2");
+    EXPECT_EQ(config.commands[1].value, "1000");
+}
+
+TEST_F(ConfigParserTest, ParseScreenshotViewports) {
+    std::vector<std::string> args = {
+        "--screenshot-viewports", "375,768x1024", "shots",
+        "--screenshot-viewports", "1280"
+    };
+    
+    auto config = parser.parseArguments(args);
+    
+    ASSERT_EQ(config.commands.size(), 2);
+    EXPECT_EQ(config.commands[0].type, "screenshot-viewports");
+    EXPECT_EQ(config.commands[0].selector, "shots");
+    EXPECT_EQ(config.commands[0].value, "375,768x1024");
+    EXPECT_EQ(config.commands[1].selector, "viewports");
+    EXPECT_EQ(config.commands[1].value, "1280");
+}
+
+TEST_F(ConfigParserTest, ParseExtractTable) {
+    std::vector<std::string> args = {
+        "--extract-table", "spec.json", "csv",
+        "--extract-table", "{\"rows\": \"tr\"}", "--text", "h1"
+    };
+    
+    auto config = parser.parseArguments(args);
+    
+    ASSERT_EQ(config.commands.size(), 3);
+    EXPECT_EQ(config.commands[0].type, "extract-table");
+    EXPECT_EQ(config.commands[0].selector, "csv");
+    EXPECT_EQ(config.commands[0].value, "spec.json");
+    EXPECT_EQ(config.commands[1].selector, "ndjson");
+    EXPECT_EQ(config.commands[1].value, "{\"rows\": \"tr\"}");
+    EXPECT_EQ(config.commands[2].type, "text");
+}
+
+TEST_F(ConfigParserTest, ParseDomDiff) {
+    std::vector<std::string> args = {"--dom-diff", "5000"};
+    
+    auto config = parser.parseArguments(args);
+    
+    ASSERT_EQ(config.commands.size(), 1);
+    EXPECT_EQ(config.commands[0].type, "dom-diff");
+    EXPECT_EQ(config.commands[0].value, "5000");
+}
+
+TEST_F(ConfigParserTest, ParseDownloadWaitWithDigest) {
+    std::string digest = "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855";
+    std::vector<std::string> args = {"--download-wait", "report.pdf", digest, "--download-wait", "*.csv", "--text", "h1"};
+    
+    auto config = parser.parseArguments(args);
+    
+    ASSERT_EQ(config.commands.size(), 3);
+    EXPECT_EQ(config.commands[0].selector, "report.pdf");
+    EXPECT_EQ(config.commands[0].value, digest);
+    EXPECT_EQ(config.commands[1].selector, "*.csv");
+    EXPECT_EQ(config.commands[1].value, "");
+    EXPECT_EQ(config.commands[2].type, "text");
+}
+
+TEST_F(ConfigParserTest, ParseDownloadAll) {
+    std::vector<std::string> args = {"--max-concurrent-downloads", "3", "--download-budget", "1048576",
+                                     "--download-all", "https://a.test/1.zip,https://a.test/2.zip"};
+    
+    auto config = parser.parseArguments(args);
+    
+    EXPECT_EQ(config.file_settings.max_concurrent_downloads, 3u);
+    EXPECT_EQ(config.file_settings.download_budget, 1048576u);
+    ASSERT_EQ(config.commands.size(), 1);
+    EXPECT_EQ(config.commands[0].type, "download-all");
+    EXPECT_EQ(config.commands[0].value, "https://a.test/1.zip,https://a.test/2.zip");
+}
+
+TEST_F(ConfigParserTest, ParseDownloadStream) {
+    std::vector<std::string> args = {"--download-timeout", "5000", "--download-stream", "https://a.test/data.csv"};
+    
+    auto config = parser.parseArguments(args);
+    
+    ASSERT_EQ(config.commands.size(), 1);
+    EXPECT_EQ(config.commands[0].type, "download-stream");
+    EXPECT_EQ(config.commands[0].value, "https://a.test/data.csv");
+    EXPECT_EQ(config.commands[0].timeout, 5000);
+}
+
+TEST_F(ConfigParserTest, ParseFetch) {
+    std::vector<std::string> args = {"--fetch", "https://a.test/api/items", "--fetch", "https://a.test/report.pdf", "report.pdf",
+                                     "--fetch", "https://a.test/b", "--text", "h1"};
+    
+    auto config = parser.parseArguments(args);
+    
+    ASSERT_EQ(config.commands.size(), 4);
+    EXPECT_EQ(config.commands[0].type, "fetch");
+    EXPECT_EQ(config.commands[0].value, "https://a.test/api/items");
+    EXPECT_EQ(config.commands[0].selector, "");
+    EXPECT_EQ(config.commands[1].value, "https://a.test/report.pdf");
+    EXPECT_EQ(config.commands[1].selector, "report.pdf");
+    EXPECT_EQ(config.commands[2].selector, "");
+    EXPECT_EQ(config.commands[3].type, "text");
+}
+
+TEST_F(ConfigParserTest, ParseFillForm) {
+    std::vector<std::string> args = {"--fill-form", "data.json", "--fill-form", "{\"#q\": \"term\"}"};
+    
+    auto config = parser.parseArguments(args);
+    
+    ASSERT_EQ(config.commands.size(), 2);
+    EXPECT_EQ(config.commands[0].type, "fill-form");
+    EXPECT_EQ(config.commands[0].value, "data.json");
+    EXPECT_EQ(config.commands[1].type, "fill-form");
+    EXPECT_EQ(config.commands[1].value, "{\"#q\": \"term\"}");
+}
+
+TEST_F(ConfigParserTest, ParseReadableModes) {
+    std::vector<std::string> args = {"--readable", "--markdown"};
+    
+    auto config = parser.parseArguments(args);
+    
+    ASSERT_EQ(config.commands.size(), 2);
+    EXPECT_EQ(config.commands[0].type, "readable");
+    EXPECT_EQ(config.commands[0].value, "text");
+    EXPECT_EQ(config.commands[1].type, "readable");
+    EXPECT_EQ(config.commands[1].value, "markdown");
+}
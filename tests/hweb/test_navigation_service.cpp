@@ -41,6 +41,21 @@ TEST_F(NavigationServiceTest, DetermineNavigationStrategy) {
     EXPECT_EQ(strategy4, HWeb::NavigationStrategy::NO_NAVIGATION);
 }
 
+TEST_F(NavigationServiceTest, FetchOnlyRunSkipsThePage) {
+    HWeb::HWebConfig config;
+    config.commands.push_back({"fetch", "", "https://saved.com/api"});
+    config.commands.push_back({"store", "key", "value"});
+    Session session("fetch");
+    session.setCurrentUrl("https://saved.com/");
+    
+    EXPECT_EQ(nav_service.determine_navigation_strategy(config, session), HWeb::NavigationStrategy::SESSION_ONLY);
+    EXPECT_FALSE(nav_service.create_navigation_plan(config, session).should_navigate);
+    
+    // Anything that needs the DOM brings the page back
+    config.commands.push_back({"text", "h1", ""});
+    EXPECT_EQ(nav_service.determine_navigation_strategy(config, session), HWeb::NavigationStrategy::CONTINUE_SESSION);
+}
+
 TEST_F(NavigationServiceTest, CreateNavigationPlan) {
     // Test NEW_URL plan
     HWeb::HWebConfig config;
@@ -66,4 +66,11 @@ TEST_F(OutputTest, FormatErrorInJsonMode) {
     HWeb::Output::format_error("Navigation", "Timeout occurred");
     
     EXPECT_EQ(captured_output.str(), "{\"error\": \"Navigation: Timeout occurred\"}\n");
-}
\ No newline at end of file
+}
+
+TEST_F(OutputTest, CommandFailedNamesCommandAndReason) {
+    HWeb::Output::set_silent_mode(true);
+    HWeb::Output::command_failed("click", "#go", "ELEMENT_NOT_FOUND");
+    
+    EXPECT_EQ(captured_output.str(), "--click #go failed: ELEMENT_NOT_FOUND\n");
+}